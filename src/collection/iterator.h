@@ -0,0 +1,248 @@
+#ifndef CTK_ITERATOR_H
+#define CTK_ITERATOR_H
+
+#include "../core/memory.h"
+
+/**
+ * @brief Lazy, stack resident iterator over an array, the source every adapter chain starts from
+ *
+ * @param type: type yielded by the iterator (e.g., StrSlice, RcString*)
+ * @param type_name: upper case name of the type (e.g., StrSlice, PathNode)
+ * @param func_name: lower case name of the type (e.g., str_slice, path_node)
+ *
+ * @note adapters are generated per chain with DEFINE_ITER_MAP(), DEFINE_ITER_FILTER(), DEFINE_ITER_TAKE(),
+ *       DEFINE_ITER_SKIP(), DEFINE_ITER_ENUMERATE(), and DEFINE_ITER_ZIP(), each one a distinct struct that holds
+ *       its inner iterator by value and calls its inner next and its callback directly
+ * @note every next is static inline and free of function pointers, so at -O2 a chain built and consumed in one
+ *       function inlines into the consuming loop with no calls left, skip only adds a short loop in front of it
+ * @note nothing is evaluated until iter_##func_name##_next() pulls an element through the chain
+ */
+#define DEFINE_ITER(type, type_name, func_name)                                                \
+    typedef struct {                                                                           \
+        type* elements;                                                                        \
+        usize position;                                                                        \
+        usize count;                                                                           \
+    } Iter##type_name;                                                                         \
+                                                                                               \
+    /* @brief iterates count elements of the given array, which must outlive the iterator */   \
+    static inline Iter##type_name iter_##func_name##_from_array(type* elements, usize count) { \
+        return (Iter##type_name) {.elements = elements, .position = 0, .count = count};        \
+    }                                                                                          \
+    static inline bool iter_##func_name##_next(Iter##type_name* iter, type* out) {             \
+        ASSERT_NONNULL(iter);                                                                  \
+        ASSERT_NONNULL(out);                                                                   \
+        if (iter->position >= iter->count) {                                                   \
+            return false;                                                                      \
+        }                                                                                      \
+        *out = iter->elements[iter->position++];                                               \
+        return true;                                                                           \
+    }                                                                                          \
+    _ITER_COUNT(type, type_name, func_name)
+
+/**
+ * @brief Adapter yielding map(element) for every element of an inner iterator
+ *
+ * @param type: type yielded by the adapter, which may differ from the inner type (e.g., usize)
+ * @param type_name: upper case name of the adapter (e.g., FieldLength gives IterFieldLength)
+ * @param func_name: lower case name of the adapter (e.g., field_length)
+ * @param inner_type: type yielded by the inner iterator
+ * @param inner_type_name: upper case name of the inner iterator
+ * @param inner_func_name: lower case name of the inner iterator
+ * @param map: type map(inner_type)
+ */
+#define DEFINE_ITER_MAP(type, type_name, func_name, inner_type, inner_type_name, inner_func_name, map) \
+    typedef struct {                                                                                   \
+        Iter##inner_type_name inner;                                                                   \
+    } Iter##type_name;                                                                                 \
+                                                                                                       \
+    static inline Iter##type_name iter_##func_name##_from(Iter##inner_type_name inner) {               \
+        return (Iter##type_name) {.inner = inner};                                                     \
+    }                                                                                                  \
+    static inline bool iter_##func_name##_next(Iter##type_name* iter, type* out) {                     \
+        ASSERT_NONNULL(iter);                                                                          \
+        ASSERT_NONNULL(out);                                                                           \
+        inner_type current;                                                                            \
+        if (!iter_##inner_func_name##_next(&iter->inner, &current)) {                                  \
+            return false;                                                                              \
+        }                                                                                              \
+        *out = map(current);                                                                           \
+        return true;                                                                                   \
+    }                                                                                                  \
+    _ITER_COUNT(type, type_name, func_name)
+
+/**
+ * @brief Adapter yielding only the elements of an inner iterator for which filter() returns true
+ *
+ * @param type: type yielded by both the adapter and the inner iterator
+ * @param type_name: upper case name of the adapter (e.g., LongField gives IterLongField)
+ * @param func_name: lower case name of the adapter (e.g., long_field)
+ * @param inner_type_name: upper case name of the inner iterator
+ * @param inner_func_name: lower case name of the inner iterator
+ * @param filter: bool filter(type*)
+ */
+#define DEFINE_ITER_FILTER(type, type_name, func_name, inner_type_name, inner_func_name, filter) \
+    typedef struct {                                                                             \
+        Iter##inner_type_name inner;                                                             \
+    } Iter##type_name;                                                                           \
+                                                                                                 \
+    static inline Iter##type_name iter_##func_name##_from(Iter##inner_type_name inner) {         \
+        return (Iter##type_name) {.inner = inner};                                               \
+    }                                                                                            \
+    static inline bool iter_##func_name##_next(Iter##type_name* iter, type* out) {               \
+        ASSERT_NONNULL(iter);                                                                    \
+        ASSERT_NONNULL(out);                                                                     \
+        while (iter_##inner_func_name##_next(&iter->inner, out)) {                               \
+            if (filter(out)) {                                                                   \
+                return true;                                                                     \
+            }                                                                                    \
+        }                                                                                        \
+        return false;                                                                            \
+    }                                                                                            \
+    _ITER_COUNT(type, type_name, func_name)
+
+/**
+ * @brief Adapter yielding at most the first count elements of an inner iterator
+ *
+ * @param type: type yielded by both the adapter and the inner iterator
+ * @param type_name: upper case name of the adapter
+ * @param func_name: lower case name of the adapter
+ * @param inner_type_name: upper case name of the inner iterator
+ * @param inner_func_name: lower case name of the inner iterator
+ */
+#define DEFINE_ITER_TAKE(type, type_name, func_name, inner_type_name, inner_func_name)                \
+    typedef struct {                                                                                  \
+        Iter##inner_type_name inner;                                                                  \
+        usize remaining;                                                                              \
+    } Iter##type_name;                                                                                \
+                                                                                                      \
+    static inline Iter##type_name iter_##func_name##_from(Iter##inner_type_name inner, usize count) { \
+        return (Iter##type_name) {.inner = inner, .remaining = count};                                \
+    }                                                                                                 \
+    static inline bool iter_##func_name##_next(Iter##type_name* iter, type* out) {                    \
+        ASSERT_NONNULL(iter);                                                                         \
+        ASSERT_NONNULL(out);                                                                          \
+        if (iter->remaining == 0 || !iter_##inner_func_name##_next(&iter->inner, out)) {              \
+            return false;                                                                             \
+        }                                                                                             \
+        iter->remaining--;                                                                            \
+        return true;                                                                                  \
+    }                                                                                                 \
+    _ITER_COUNT(type, type_name, func_name)
+
+/**
+ * @brief Adapter dropping the first count elements of an inner iterator and yielding the rest
+ *
+ * @param type: type yielded by both the adapter and the inner iterator
+ * @param type_name: upper case name of the adapter
+ * @param func_name: lower case name of the adapter
+ * @param inner_type_name: upper case name of the inner iterator
+ * @param inner_func_name: lower case name of the inner iterator
+ */
+#define DEFINE_ITER_SKIP(type, type_name, func_name, inner_type_name, inner_func_name)                \
+    typedef struct {                                                                                  \
+        Iter##inner_type_name inner;                                                                  \
+        usize remaining;                                                                              \
+    } Iter##type_name;                                                                                \
+                                                                                                      \
+    static inline Iter##type_name iter_##func_name##_from(Iter##inner_type_name inner, usize count) { \
+        return (Iter##type_name) {.inner = inner, .remaining = count};                                \
+    }                                                                                                 \
+    static inline bool iter_##func_name##_next(Iter##type_name* iter, type* out) {                    \
+        ASSERT_NONNULL(iter);                                                                         \
+        ASSERT_NONNULL(out);                                                                          \
+        for (; iter->remaining > 0; iter->remaining--) {                                              \
+            if (!iter_##inner_func_name##_next(&iter->inner, out)) {                                  \
+                return false;                                                                         \
+            }                                                                                         \
+        }                                                                                             \
+        return iter_##inner_func_name##_next(&iter->inner, out);                                      \
+    }                                                                                                 \
+    _ITER_COUNT(type, type_name, func_name)
+
+/**
+ * @brief Pair yielded by DEFINE_ITER_ENUMERATE() and DEFINE_ITER_ZIP()
+ *
+ * @param left_type: type of the left element, which must be usize for enumerate
+ * @param right_type: type of the right element
+ * @param type_name: name of the pair struct (e.g., IndexedInt)
+ *
+ * @note a pair is a plain value, so it can be mapped, filtered, zipped again, or stored in an array for DEFINE_ITER()
+ */
+#define DEFINE_ITER_PAIR(left_type, right_type, type_name) \
+    typedef struct {                                       \
+        left_type left;                                    \
+        right_type right;                                  \
+    } type_name;
+
+/**
+ * @brief Adapter yielding each element of an inner iterator as the right of a pair whose left is its index
+ *
+ * @param type: pair type from DEFINE_ITER_PAIR() with usize on the left and the inner type on the right
+ * @param type_name: upper case name of the adapter
+ * @param func_name: lower case name of the adapter
+ * @param inner_type_name: upper case name of the inner iterator
+ * @param inner_func_name: lower case name of the inner iterator
+ */
+#define DEFINE_ITER_ENUMERATE(type, type_name, func_name, inner_type_name, inner_func_name) \
+    typedef struct {                                                                        \
+        Iter##inner_type_name inner;                                                        \
+        usize index;                                                                        \
+    } Iter##type_name;                                                                      \
+                                                                                            \
+    static inline Iter##type_name iter_##func_name##_from(Iter##inner_type_name inner) {    \
+        return (Iter##type_name) {.inner = inner, .index = 0};                              \
+    }                                                                                       \
+    static inline bool iter_##func_name##_next(Iter##type_name* iter, type* out) {          \
+        ASSERT_NONNULL(iter);                                                               \
+        ASSERT_NONNULL(out);                                                                \
+        if (!iter_##inner_func_name##_next(&iter->inner, &out->right)) {                    \
+            return false;                                                                   \
+        }                                                                                   \
+        out->left = iter->index++;                                                          \
+        return true;                                                                        \
+    }                                                                                       \
+    _ITER_COUNT(type, type_name, func_name)
+
+/**
+ * @brief Adapter yielding pairs of elements from two inner iterators until either one is exhausted
+ *
+ * @param type: pair type from DEFINE_ITER_PAIR() with the left inner type on the left and the right one on the right
+ * @param type_name: upper case name of the adapter
+ * @param func_name: lower case name of the adapter
+ * @param left_type_name: upper case name of the left inner iterator
+ * @param left_func_name: lower case name of the left inner iterator
+ * @param right_type_name: upper case name of the right inner iterator
+ * @param right_func_name: lower case name of the right inner iterator
+ *
+ * @note the left iterator is advanced first, so it may have consumed one element more than the right when zip stops
+ */
+#define DEFINE_ITER_ZIP(type, type_name, func_name, left_type_name, left_func_name, right_type_name, right_func_name) \
+    typedef struct {                                                                                                  \
+        Iter##left_type_name left;                                                                                    \
+        Iter##right_type_name right;                                                                                  \
+    } Iter##type_name;                                                                                                \
+                                                                                                                      \
+    static inline Iter##type_name iter_##func_name##_from(Iter##left_type_name left, Iter##right_type_name right) {   \
+        return (Iter##type_name) {.left = left, .right = right};                                                      \
+    }                                                                                                                 \
+    static inline bool iter_##func_name##_next(Iter##type_name* iter, type* out) {                                    \
+        ASSERT_NONNULL(iter);                                                                                         \
+        ASSERT_NONNULL(out);                                                                                          \
+        return iter_##left_func_name##_next(&iter->left, &out->left) &&                                               \
+               iter_##right_func_name##_next(&iter->right, &out->right);                                              \
+    }                                                                                                                 \
+    _ITER_COUNT(type, type_name, func_name)
+
+#define _ITER_COUNT(type, type_name, func_name)                                      \
+    /* @brief consumes the iterator and returns the number of elements it yielded */ \
+    static inline usize iter_##func_name##_count(Iter##type_name* iter) {            \
+        ASSERT_NONNULL(iter);                                                        \
+        type current;                                                                \
+        usize count = 0;                                                             \
+        while (iter_##func_name##_next(iter, &current)) {                            \
+            count++;                                                                 \
+        }                                                                            \
+        return count;                                                                \
+    }
+
+#endif
@@ -0,0 +1,144 @@
+#ifndef CTK_SEGMENTED_VECTOR_H
+#define CTK_SEGMENTED_VECTOR_H
+
+#include "../core/memory.h"
+
+#define _SEGMENTED_VEC_FIRST_BITS 3
+#define _SEGMENTED_VEC_MAX_CHUNKS (64 - _SEGMENTED_VEC_FIRST_BITS)
+
+/**
+ * @brief maps an element index to its chunk, where chunk k holds (1 << FIRST_BITS) << k elements
+ */
+static inline usize _segmented_vec_chunk(usize index) {
+    return (63 - __builtin_clzll((u64) index + (1 << _SEGMENTED_VEC_FIRST_BITS))) - _SEGMENTED_VEC_FIRST_BITS;
+}
+
+/**
+ * @brief maps an element index to its offset inside of the chunk given by _segmented_vec_chunk()
+ */
+static inline usize _segmented_vec_offset(usize index, usize chunk) {
+    return index + (1 << _SEGMENTED_VEC_FIRST_BITS) - ((usize) 1 << (chunk + _SEGMENTED_VEC_FIRST_BITS));
+}
+
+/**
+ * @brief destroy hook for segmented vectors of types that do not own any memory
+ */
+static inline void segmented_vec_no_destroy(void* element) {
+    (void) element;
+}
+
+/**
+ * @brief Vector storing elements by value in geometrically growing chunks that never move
+ *
+ * @param type: inner type stored by value
+ * @param type_name: upper case name of the type (e.g., Int, Double, String)
+ * @param func_name: lower case name of the type (e.g., int, double, string)
+ * @param destroy: void destroy(type*) releasing anything owned by an element in place (see segmented_vec_no_destroy)
+ *
+ * @note pointers to elements stay valid until the element is popped, cleared, or the vector is freed
+ * @note growth allocates a new chunk twice the size of the last one and never copies existing elements
+ */
+#define DEFINE_SEGMENTED_VEC(type, type_name, func_name, destroy)                                                   \
+    typedef struct {                                                                                                \
+        type* chunks[_SEGMENTED_VEC_MAX_CHUNKS];                                                                    \
+        usize chunk_count;                                                                                          \
+        usize count;                                                                                                \
+    } SegmentedVec##type_name;                                                                                      \
+                                                                                                                    \
+    DEFINE_OPTION(type*, type_name, func_name, NULL)                                                                \
+                                                                                                                    \
+    static inline SegmentedVec##type_name* segmented_vec_##func_name##_new() {                                      \
+        SegmentedVec##type_name* vec = (SegmentedVec##type_name*) heap_one(sizeof(SegmentedVec##type_name));        \
+        vec->chunk_count = 0;                                                                                       \
+        vec->count = 0;                                                                                             \
+        return vec;                                                                                                 \
+    }                                                                                                               \
+    static inline void segmented_vec_##func_name##_clear(SegmentedVec##type_name* vec) {                            \
+        ASSERT_NONNULL(vec);                                                                                        \
+        usize index = 0;                                                                                            \
+        for (usize chunk = 0; chunk < vec->chunk_count; chunk++) {                                                  \
+            usize chunk_size = (usize) 1 << (chunk + _SEGMENTED_VEC_FIRST_BITS);                                    \
+            for (usize offset = 0; offset < chunk_size && index < vec->count; offset++, index++) {                  \
+                destroy(&vec->chunks[chunk][offset]);                                                               \
+            }                                                                                                       \
+        }                                                                                                           \
+        vec->count = 0;                                                                                             \
+    }                                                                                                               \
+    static inline void segmented_vec_##func_name##_free(SegmentedVec##type_name** vec) {                            \
+        ASSERT_NONNULL(vec);                                                                                        \
+        ASSERT_NONNULL(*vec);                                                                                       \
+        segmented_vec_##func_name##_clear(*vec);                                                                    \
+        for (usize chunk = 0; chunk < (*vec)->chunk_count; chunk++) {                                               \
+            free((*vec)->chunks[chunk]);                                                                            \
+        }                                                                                                           \
+        free(*vec);                                                                                                 \
+        *vec = NULL;                                                                                                \
+    }                                                                                                               \
+    /* @return a stable pointer to a new uninitialized slot at the end of the vector */                             \
+    static inline type* segmented_vec_##func_name##_emplace_back(SegmentedVec##type_name* vec) {                    \
+        ASSERT_NONNULL(vec);                                                                                        \
+        usize chunk = _segmented_vec_chunk(vec->count);                                                             \
+        if (chunk >= vec->chunk_count) {                                                                            \
+            assert(chunk < _SEGMENTED_VEC_MAX_CHUNKS);                                                              \
+            vec->chunks[chunk] = (type*) heap_many(sizeof(type), (usize) 1 << (chunk + _SEGMENTED_VEC_FIRST_BITS)); \
+            vec->chunk_count = chunk + 1;                                                                           \
+        }                                                                                                           \
+        type* slot = &vec->chunks[chunk][_segmented_vec_offset(vec->count, chunk)];                                 \
+        vec->count++;                                                                                               \
+        return slot;                                                                                                \
+    }                                                                                                               \
+    /* @return a stable pointer to the pushed element, which now owns anything the given element owned */           \
+    static inline type* segmented_vec_##func_name##_push_back(SegmentedVec##type_name* vec, type element) {         \
+        type* slot = segmented_vec_##func_name##_emplace_back(vec);                                                 \
+        *slot = element;                                                                                            \
+        return slot;                                                                                                \
+    }                                                                                                               \
+    static inline type* segmented_vec_##func_name##_at(SegmentedVec##type_name* vec, usize index) {                 \
+        ASSERT_NONNULL(vec);                                                                                        \
+        assert(index < vec->count);                                                                                 \
+        usize chunk = _segmented_vec_chunk(index);                                                                  \
+        return &vec->chunks[chunk][_segmented_vec_offset(index, chunk)];                                            \
+    }                                                                                                               \
+    static inline Option##type_name segmented_vec_##func_name##_get(SegmentedVec##type_name* vec, usize index) {    \
+        ASSERT_NONNULL(vec);                                                                                        \
+        if (index >= vec->count) {                                                                                  \
+            return option_##func_name##_empty();                                                                    \
+        }                                                                                                           \
+        return option_##func_name(segmented_vec_##func_name##_at(vec, index));                                      \
+    }                                                                                                               \
+    static inline Option##type_name segmented_vec_##func_name##_first(SegmentedVec##type_name* vec) {               \
+        return segmented_vec_##func_name##_get(vec, 0);                                                             \
+    }                                                                                                               \
+    static inline Option##type_name segmented_vec_##func_name##_last(SegmentedVec##type_name* vec) {                \
+        ASSERT_NONNULL(vec);                                                                                        \
+        if (vec->count == 0) {                                                                                      \
+            return option_##func_name##_empty();                                                                    \
+        }                                                                                                           \
+        return segmented_vec_##func_name##_get(vec, vec->count - 1);                                                \
+    }                                                                                                               \
+    /* @brief destroys the last element in place, chunks are kept for later pushes */                               \
+    static inline void segmented_vec_##func_name##_pop_back(SegmentedVec##type_name* vec) {                         \
+        ASSERT_NONNULL(vec);                                                                                        \
+        assert(vec->count > 0);                                                                                     \
+        destroy(segmented_vec_##func_name##_at(vec, vec->count - 1));                                               \
+        vec->count--;                                                                                               \
+    }
+
+/**
+ * @brief iterates a segmented vector chunk by chunk without any per index bucket math
+ * @note unlike vec_for_each(), declaration receives a pointer to the stored element (e.g., Point* point)
+ */
+#define segmented_vec_for_each(declaration, vector, body)                                                                \
+    do {                                                                                                                 \
+        usize _segmented_index = 0;                                                                                      \
+        for (usize _segmented_chunk = 0; _segmented_chunk < (vector)->chunk_count; _segmented_chunk++) {                 \
+            usize _segmented_size = (usize) 1 << (_segmented_chunk + _SEGMENTED_VEC_FIRST_BITS);                         \
+            for (usize _segmented_offset = 0; _segmented_offset < _segmented_size && _segmented_index < (vector)->count; \
+                 _segmented_offset++, _segmented_index++) {                                                              \
+                declaration = &(vector)->chunks[_segmented_chunk][_segmented_offset];                                    \
+                body                                                                                                     \
+            }                                                                                                            \
+        }                                                                                                                \
+    } while (0);
+
+#endif
@@ -0,0 +1,275 @@
+#ifndef CTK_SHARDED_MAP_H
+#define CTK_SHARDED_MAP_H
+
+#include <pthread.h>
+#include "../core/memory.h"
+
+#define SHARDED_MAP_DEFAULT_SHARDS 16
+
+#define _SHARDED_MAP_CACHE_LINE 64
+#define _SHARDED_MAP_INITIAL_CAPACITY 8
+
+/**
+ * @brief Thread safe hash map split into independently locked shards with attached helper functions
+ *
+ * @param key_type: type of the owned keys (e.g., String)
+ * @param value_type: type of the owned values (e.g., CString)
+ * @param type_name: upper case name of the map (e.g., PathCache)
+ * @param func_name: lower case name of the map (e.g., path_cache)
+ * @param hash: u64 hash(const key_type*)
+ * @param equals: bool equals(const key_type*, const key_type*)
+ * @param key_clone: key_type* key_clone(const key_type*)
+ * @param key_destroy: void key_destroy(key_type**)
+ * @param value_clone: value_type* value_clone(const value_type*)
+ * @param value_destroy: void value_destroy(value_type**)
+ *
+ * @note the shard is chosen by the high bits of the hash and the slot inside the shard by the low bits
+ * @note each shard sits on its own cache line and is guarded by a reader-writer lock, so readers never block readers
+ * @note lookups return clones as a stored value may be replaced or removed by another thread at any time
+ */
+#define DEFINE_SHARDED_MAP(key_type, value_type, type_name, func_name, hash, equals, key_clone, key_destroy, value_clone, value_destroy) \
+    typedef struct {                                                                                                                     \
+        pthread_rwlock_t lock;                                                                                                           \
+        u64* hashes;                                                                                                                     \
+        key_type** keys;                                                                                                                 \
+        value_type** values;                                                                                                             \
+        usize count;                                                                                                                     \
+        usize capacity;                                                                                                                  \
+    } __attribute__((aligned(_SHARDED_MAP_CACHE_LINE))) _ShardedMapShard##type_name;                                                     \
+                                                                                                                                         \
+    typedef struct {                                                                                                                     \
+        _ShardedMapShard##type_name* shards;                                                                                             \
+        usize shard_count;                                                                                                               \
+        u32 shard_bits;                                                                                                                  \
+    } ShardedMap##type_name;                                                                                                             \
+                                                                                                                                         \
+    DEFINE_OPTION(value_type*, type_name, func_name, NULL)                                                                               \
+                                                                                                                                         \
+    static inline ShardedMap##type_name* sharded_map_##func_name##_new(usize shard_count) {                                              \
+        ShardedMap##type_name* map = (ShardedMap##type_name*) heap_one(sizeof(ShardedMap##type_name));                                   \
+        map->shard_count = 1;                                                                                                            \
+        map->shard_bits = 0;                                                                                                             \
+        while (map->shard_count < shard_count) {                                                                                         \
+            map->shard_count <<= 1;                                                                                                      \
+            map->shard_bits++;                                                                                                           \
+        }                                                                                                                                \
+        map->shards = (_ShardedMapShard##type_name*) heap_aligned(                                                                       \
+            _SHARDED_MAP_CACHE_LINE, sizeof(_ShardedMapShard##type_name), map->shard_count);                                             \
+        for (usize i = 0; i < map->shard_count; i++) {                                                                                   \
+            pthread_rwlock_init(&map->shards[i].lock, NULL);                                                                             \
+            map->shards[i].hashes = NULL;                                                                                                \
+            map->shards[i].keys = NULL;                                                                                                  \
+            map->shards[i].values = NULL;                                                                                                \
+            map->shards[i].count = 0;                                                                                                    \
+            map->shards[i].capacity = 0;                                                                                                 \
+        }                                                                                                                                \
+        return map;                                                                                                                      \
+    }                                                                                                                                    \
+    static inline void _sharded_map_##func_name##_shard_clear(_ShardedMapShard##type_name* shard) {                                      \
+        for (usize i = 0; i < shard->capacity; i++) {                                                                                    \
+            if (shard->keys[i] != NULL) {                                                                                                \
+                key_destroy(&shard->keys[i]);                                                                                            \
+                value_destroy(&shard->values[i]);                                                                                        \
+                shard->keys[i] = NULL;                                                                                                   \
+            }                                                                                                                            \
+        }                                                                                                                                \
+        shard->count = 0;                                                                                                                \
+    }                                                                                                                                    \
+    static inline void sharded_map_##func_name##_free(ShardedMap##type_name** map) {                                                     \
+        ASSERT_NONNULL(map);                                                                                                             \
+        ASSERT_NONNULL(*map);                                                                                                            \
+        for (usize i = 0; i < (*map)->shard_count; i++) {                                                                                \
+            _ShardedMapShard##type_name* shard = &(*map)->shards[i];                                                                     \
+            _sharded_map_##func_name##_shard_clear(shard);                                                                               \
+            free(shard->hashes);                                                                                                         \
+            free(shard->keys);                                                                                                           \
+            free(shard->values);                                                                                                         \
+            pthread_rwlock_destroy(&shard->lock);                                                                                        \
+        }                                                                                                                                \
+        free((*map)->shards);                                                                                                            \
+        free(*map);                                                                                                                      \
+        *map = NULL;                                                                                                                     \
+    }                                                                                                                                    \
+    static inline _ShardedMapShard##type_name* _sharded_map_##func_name##_shard(ShardedMap##type_name* map,                              \
+                                                                                u64 key_hash) {                                          \
+        if (map->shard_bits == 0) {                                                                                                      \
+            return &map->shards[0];                                                                                                      \
+        }                                                                                                                                \
+        return &map->shards[key_hash >> (64 - map->shard_bits)];                                                                         \
+    }                                                                                                                                    \
+    static inline usize _sharded_map_##func_name##_find(_ShardedMapShard##type_name* shard, u64 key_hash,                                \
+                                                        const key_type* key) {                                                           \
+        if (shard->capacity == 0) {                                                                                                      \
+            return shard->capacity;                                                                                                      \
+        }                                                                                                                                \
+        usize mask = shard->capacity - 1;                                                                                                \
+        for (usize i = key_hash & mask;; i = (i + 1) & mask) {                                                                           \
+            if (shard->keys[i] == NULL) {                                                                                                \
+                return shard->capacity;                                                                                                  \
+            }                                                                                                                            \
+            if (shard->hashes[i] == key_hash && equals(shard->keys[i], key)) {                                                           \
+                return i;                                                                                                                \
+            }                                                                                                                            \
+        }                                                                                                                                \
+    }                                                                                                                                    \
+    static inline void _sharded_map_##func_name##_place(_ShardedMapShard##type_name* shard, u64 key_hash,                                \
+                                                        key_type* key, value_type* value) {                                              \
+        usize mask = shard->capacity - 1;                                                                                                \
+        usize i = key_hash & mask;                                                                                                       \
+        while (shard->keys[i] != NULL) {                                                                                                 \
+            i = (i + 1) & mask;                                                                                                          \
+        }                                                                                                                                \
+        shard->hashes[i] = key_hash;                                                                                                     \
+        shard->keys[i] = key;                                                                                                            \
+        shard->values[i] = value;                                                                                                        \
+        shard->count++;                                                                                                                  \
+    }                                                                                                                                    \
+    static inline void _sharded_map_##func_name##_grow(_ShardedMapShard##type_name* shard) {                                             \
+        u64* old_hashes = shard->hashes;                                                                                                 \
+        key_type** old_keys = shard->keys;                                                                                               \
+        value_type** old_values = shard->values;                                                                                         \
+        usize old_capacity = shard->capacity;                                                                                            \
+        shard->capacity = old_capacity > 0 ? old_capacity * 2 : _SHARDED_MAP_INITIAL_CAPACITY;                                           \
+        shard->hashes = (u64*) heap_many(sizeof(u64), shard->capacity);                                                                  \
+        shard->keys = (key_type**) heap_clear(sizeof(key_type*), shard->capacity);                                                       \
+        shard->values = (value_type**) heap_many(sizeof(value_type*), shard->capacity);                                                  \
+        shard->count = 0;                                                                                                                \
+        for (usize i = 0; i < old_capacity; i++) {                                                                                       \
+            if (old_keys[i] != NULL) {                                                                                                   \
+                _sharded_map_##func_name##_place(shard, old_hashes[i], old_keys[i], old_values[i]);                                      \
+            }                                                                                                                            \
+        }                                                                                                                                \
+        free(old_hashes);                                                                                                                \
+        free(old_keys);                                                                                                                  \
+        free(old_values);                                                                                                                \
+    }                                                                                                                                    \
+    static inline bool _sharded_map_##func_name##_store(_ShardedMapShard##type_name* shard, u64 key_hash,                                \
+                                                        key_type* key, value_type* value) {                                              \
+        usize index = _sharded_map_##func_name##_find(shard, key_hash, key);                                                             \
+        if (index < shard->capacity) {                                                                                                   \
+            key_destroy(&key);                                                                                                           \
+            value_destroy(&shard->values[index]);                                                                                        \
+            shard->values[index] = value;                                                                                                \
+            return false;                                                                                                                \
+        }                                                                                                                                \
+        if ((shard->count + 1) * 4 > shard->capacity * 3) {                                                                              \
+            _sharded_map_##func_name##_grow(shard);                                                                                      \
+        }                                                                                                                                \
+        _sharded_map_##func_name##_place(shard, key_hash, key, value);                                                                   \
+        return true;                                                                                                                     \
+    }                                                                                                                                    \
+    /* @return true if the key was not present before, false if an existing value was replaced */                                        \
+    static inline bool sharded_map_##func_name##_insert_owned(ShardedMap##type_name* map, key_type* key,                                 \
+                                                              value_type* value) {                                                       \
+        ASSERT_NONNULL(map);                                                                                                             \
+        ASSERT_NONNULL(key);                                                                                                             \
+        ASSERT_NONNULL(value);                                                                                                           \
+        u64 key_hash = hash(key);                                                                                                        \
+        _ShardedMapShard##type_name* shard = _sharded_map_##func_name##_shard(map, key_hash);                                            \
+        pthread_rwlock_wrlock(&shard->lock);                                                                                             \
+        bool inserted = _sharded_map_##func_name##_store(shard, key_hash, key, value);                                                   \
+        pthread_rwlock_unlock(&shard->lock);                                                                                             \
+        return inserted;                                                                                                                 \
+    }                                                                                                                                    \
+    static inline bool sharded_map_##func_name##_insert(ShardedMap##type_name* map, const key_type* key,                                 \
+                                                        const value_type* value) {                                                       \
+        ASSERT_NONNULL(key);                                                                                                             \
+        ASSERT_NONNULL(value);                                                                                                           \
+        return sharded_map_##func_name##_insert_owned(map, key_clone(key), value_clone(value));                                          \
+    }                                                                                                                                    \
+    /* @return a clone of the stored value, or of the given value if the key was absent, which must be freed */                          \
+    static inline value_type* sharded_map_##func_name##_get_or_insert_owned(ShardedMap##type_name* map,                                  \
+                                                                            key_type* key, value_type* value) {                          \
+        ASSERT_NONNULL(map);                                                                                                             \
+        ASSERT_NONNULL(key);                                                                                                             \
+        ASSERT_NONNULL(value);                                                                                                           \
+        u64 key_hash = hash(key);                                                                                                        \
+        _ShardedMapShard##type_name* shard = _sharded_map_##func_name##_shard(map, key_hash);                                            \
+        pthread_rwlock_wrlock(&shard->lock);                                                                                             \
+        usize index = _sharded_map_##func_name##_find(shard, key_hash, key);                                                             \
+        value_type* result;                                                                                                              \
+        if (index < shard->capacity) {                                                                                                   \
+            result = value_clone(shard->values[index]);                                                                                  \
+            key_destroy(&key);                                                                                                           \
+            value_destroy(&value);                                                                                                       \
+        } else {                                                                                                                         \
+            result = value_clone(value);                                                                                                 \
+            _sharded_map_##func_name##_store(shard, key_hash, key, value);                                                               \
+        }                                                                                                                                \
+        pthread_rwlock_unlock(&shard->lock);                                                                                             \
+        return result;                                                                                                                   \
+    }                                                                                                                                    \
+    /* @return a clone of the stored value which must be freed, or an empty option if not found */                                       \
+    static inline Option##type_name sharded_map_##func_name##_get(ShardedMap##type_name* map, const key_type* key) {                     \
+        ASSERT_NONNULL(map);                                                                                                             \
+        ASSERT_NONNULL(key);                                                                                                             \
+        u64 key_hash = hash(key);                                                                                                        \
+        _ShardedMapShard##type_name* shard = _sharded_map_##func_name##_shard(map, key_hash);                                            \
+        pthread_rwlock_rdlock(&shard->lock);                                                                                             \
+        usize index = _sharded_map_##func_name##_find(shard, key_hash, key);                                                             \
+        Option##type_name result = index < shard->capacity ? option_##func_name(value_clone(shard->values[index]))                       \
+                                                           : option_##func_name##_empty();                                               \
+        pthread_rwlock_unlock(&shard->lock);                                                                                             \
+        return result;                                                                                                                   \
+    }                                                                                                                                    \
+    static inline bool sharded_map_##func_name##_contains(ShardedMap##type_name* map, const key_type* key) {                             \
+        ASSERT_NONNULL(map);                                                                                                             \
+        ASSERT_NONNULL(key);                                                                                                             \
+        u64 key_hash = hash(key);                                                                                                        \
+        _ShardedMapShard##type_name* shard = _sharded_map_##func_name##_shard(map, key_hash);                                            \
+        pthread_rwlock_rdlock(&shard->lock);                                                                                             \
+        bool found = _sharded_map_##func_name##_find(shard, key_hash, key) < shard->capacity;                                            \
+        pthread_rwlock_unlock(&shard->lock);                                                                                             \
+        return found;                                                                                                                    \
+    }                                                                                                                                    \
+    /* @return true if the key was present and has been destroyed along with its value */                                                \
+    static inline bool sharded_map_##func_name##_remove(ShardedMap##type_name* map, const key_type* key) {                               \
+        ASSERT_NONNULL(map);                                                                                                             \
+        ASSERT_NONNULL(key);                                                                                                             \
+        u64 key_hash = hash(key);                                                                                                        \
+        _ShardedMapShard##type_name* shard = _sharded_map_##func_name##_shard(map, key_hash);                                            \
+        pthread_rwlock_wrlock(&shard->lock);                                                                                             \
+        usize index = _sharded_map_##func_name##_find(shard, key_hash, key);                                                             \
+        if (index >= shard->capacity) {                                                                                                  \
+            pthread_rwlock_unlock(&shard->lock);                                                                                         \
+            return false;                                                                                                                \
+        }                                                                                                                                \
+        key_destroy(&shard->keys[index]);                                                                                                \
+        value_destroy(&shard->values[index]);                                                                                            \
+        shard->keys[index] = NULL;                                                                                                       \
+        shard->count--;                                                                                                                  \
+        usize mask = shard->capacity - 1;                                                                                                \
+        usize hole = index;                                                                                                              \
+        for (usize i = (index + 1) & mask; shard->keys[i] != NULL; i = (i + 1) & mask) {                                                 \
+            usize home = shard->hashes[i] & mask;                                                                                        \
+            if (((i - home) & mask) >= ((i - hole) & mask)) {                                                                            \
+                shard->hashes[hole] = shard->hashes[i];                                                                                  \
+                shard->keys[hole] = shard->keys[i];                                                                                      \
+                shard->values[hole] = shard->values[i];                                                                                  \
+                shard->keys[i] = NULL;                                                                                                   \
+                hole = i;                                                                                                                \
+            }                                                                                                                            \
+        }                                                                                                                                \
+        pthread_rwlock_unlock(&shard->lock);                                                                                             \
+        return true;                                                                                                                     \
+    }                                                                                                                                    \
+    static inline usize sharded_map_##func_name##_count(ShardedMap##type_name* map) {                                                    \
+        ASSERT_NONNULL(map);                                                                                                             \
+        usize count = 0;                                                                                                                 \
+        for (usize i = 0; i < map->shard_count; i++) {                                                                                   \
+            pthread_rwlock_rdlock(&map->shards[i].lock);                                                                                 \
+            count += map->shards[i].count;                                                                                               \
+            pthread_rwlock_unlock(&map->shards[i].lock);                                                                                 \
+        }                                                                                                                                \
+        return count;                                                                                                                    \
+    }                                                                                                                                    \
+    static inline void sharded_map_##func_name##_clear(ShardedMap##type_name* map) {                                                     \
+        ASSERT_NONNULL(map);                                                                                                             \
+        for (usize i = 0; i < map->shard_count; i++) {                                                                                   \
+            pthread_rwlock_wrlock(&map->shards[i].lock);                                                                                 \
+            _sharded_map_##func_name##_shard_clear(&map->shards[i]);                                                                     \
+            pthread_rwlock_unlock(&map->shards[i].lock);                                                                                 \
+        }                                                                                                                                \
+    }
+
+#endif
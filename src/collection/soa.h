@@ -0,0 +1,142 @@
+#ifndef CTK_SOA_H
+#define CTK_SOA_H
+
+#include <string.h>
+#include "../core/memory.h"
+
+#define _SOA_ALIGNMENT 64
+
+/**
+ * @brief Struct-of-arrays container with one contiguous, cache line aligned column per field
+ *
+ * @param type_name: upper case name of the row type generated alongside the container (e.g., Particle)
+ * @param func_name: lower case name of the row type (e.g., particle)
+ * @param ...: between 1 and 8 (type, field) pairs (e.g., (f32, x), (f32, y), (u32, id))
+ *
+ * @note generates the row struct type_name, the container Soa##type_name, and a column accessor per field
+ *       (e.g., soa_particle_x()) returning a pointer suitable for auto-vectorized loops
+ * @note fields are copied by value, so columns should hold plain data types
+ */
+#define DEFINE_SOA(type_name, func_name, ...)                                                                  \
+    typedef struct {                                                                                           \
+        _SOA_FOR_EACH(_SOA_ROW_FIELD, type_name, func_name, __VA_ARGS__)                                       \
+    } type_name;                                                                                               \
+                                                                                                               \
+    typedef struct {                                                                                           \
+        _SOA_FOR_EACH(_SOA_COLUMN_FIELD, type_name, func_name, __VA_ARGS__)                                    \
+        usize count;                                                                                           \
+        usize capacity;                                                                                        \
+    } Soa##type_name;                                                                                          \
+                                                                                                               \
+    DEFINE_OPTION(type_name, type_name, func_name, ((type_name) {0}))                                          \
+                                                                                                               \
+    static inline Soa##type_name* soa_##func_name##_new(usize initial_capacity) {                              \
+        Soa##type_name* soa = (Soa##type_name*) heap_one(sizeof(Soa##type_name));                              \
+        soa->count = 0;                                                                                        \
+        soa->capacity = initial_capacity > 0 ? initial_capacity : 1;                                           \
+        _SOA_FOR_EACH(_SOA_COLUMN_NEW, type_name, func_name, __VA_ARGS__)                                      \
+        return soa;                                                                                            \
+    }                                                                                                          \
+    static inline void soa_##func_name##_free(Soa##type_name** soa) {                                          \
+        ASSERT_NONNULL(soa);                                                                                   \
+        ASSERT_NONNULL(*soa);                                                                                  \
+        _SOA_FOR_EACH(_SOA_COLUMN_FREE, type_name, func_name, __VA_ARGS__)                                     \
+        free(*soa);                                                                                            \
+        *soa = NULL;                                                                                           \
+    }                                                                                                          \
+    static inline void soa_##func_name##_resize(Soa##type_name* soa, usize new_capacity) {                     \
+        ASSERT_NONNULL(soa);                                                                                   \
+        assert(new_capacity >= soa->count);                                                                    \
+        soa->capacity = new_capacity > 0 ? new_capacity : 1;                                                   \
+        _SOA_FOR_EACH(_SOA_COLUMN_RESIZE, type_name, func_name, __VA_ARGS__)                                   \
+    }                                                                                                          \
+    static inline void soa_##func_name##_push(Soa##type_name* soa, type_name row) {                            \
+        ASSERT_NONNULL(soa);                                                                                   \
+        if (soa->count + 1 > soa->capacity) {                                                                  \
+            soa_##func_name##_resize(soa, soa->capacity * 2);                                                  \
+        }                                                                                                      \
+        _SOA_FOR_EACH(_SOA_COLUMN_PUSH, type_name, func_name, __VA_ARGS__)                                     \
+        soa->count++;                                                                                          \
+    }                                                                                                          \
+    static inline Option##type_name soa_##func_name##_get(const Soa##type_name* soa, usize index) {            \
+        ASSERT_NONNULL(soa);                                                                                   \
+        if (index >= soa->count) {                                                                             \
+            return option_##func_name##_empty();                                                               \
+        }                                                                                                      \
+        type_name row;                                                                                         \
+        _SOA_FOR_EACH(_SOA_COLUMN_GET, type_name, func_name, __VA_ARGS__)                                      \
+        return option_##func_name(row);                                                                        \
+    }                                                                                                          \
+    static inline void soa_##func_name##_set(Soa##type_name* soa, usize index, type_name row) {                \
+        ASSERT_NONNULL(soa);                                                                                   \
+        assert(index < soa->count);                                                                            \
+        _SOA_FOR_EACH(_SOA_COLUMN_SET, type_name, func_name, __VA_ARGS__)                                      \
+    }                                                                                                          \
+    /* @brief removes the row at index by moving the last row into its place, which does not preserve order */ \
+    static inline Option##type_name soa_##func_name##_swap_remove(Soa##type_name* soa, usize index) {          \
+        Option##type_name removed = soa_##func_name##_get(soa, index);                                         \
+        if (!removed.present) {                                                                                \
+            return removed;                                                                                    \
+        }                                                                                                      \
+        soa->count--;                                                                                          \
+        _SOA_FOR_EACH(_SOA_COLUMN_SWAP_REMOVE, type_name, func_name, __VA_ARGS__)                              \
+        return removed;                                                                                        \
+    }                                                                                                          \
+    static inline void soa_##func_name##_clear(Soa##type_name* soa) {                                          \
+        ASSERT_NONNULL(soa);                                                                                   \
+        soa->count = 0;                                                                                        \
+    }                                                                                                          \
+    _SOA_FOR_EACH(_SOA_COLUMN_ACCESSOR, type_name, func_name, __VA_ARGS__)
+
+// INTERNAL
+
+#define _SOA_ROW_FIELD(type_name, func_name, type, field) type field;
+#define _SOA_COLUMN_FIELD(type_name, func_name, type, field) type* field;
+#define _SOA_COLUMN_NEW(type_name, func_name, type, field) \
+    soa->field = (type*) heap_aligned(_SOA_ALIGNMENT, sizeof(type), soa->capacity);
+#define _SOA_COLUMN_FREE(type_name, func_name, type, field) free((*soa)->field);
+#define _SOA_COLUMN_RESIZE(type_name, func_name, type, field)                             \
+    {                                                                                     \
+        type* column = (type*) heap_aligned(_SOA_ALIGNMENT, sizeof(type), soa->capacity); \
+        memcpy(column, soa->field, sizeof(type) * soa->count);                            \
+        free(soa->field);                                                                 \
+        soa->field = column;                                                              \
+    }
+#define _SOA_COLUMN_PUSH(type_name, func_name, type, field) soa->field[soa->count] = row.field;
+#define _SOA_COLUMN_GET(type_name, func_name, type, field) row.field = soa->field[index];
+#define _SOA_COLUMN_SET(type_name, func_name, type, field) soa->field[index] = row.field;
+#define _SOA_COLUMN_SWAP_REMOVE(type_name, func_name, type, field) soa->field[index] = soa->field[soa->count];
+#define _SOA_COLUMN_ACCESSOR(type_name, func_name, type, field)                \
+    static inline type* soa_##func_name##_##field(const Soa##type_name* soa) { \
+        ASSERT_NONNULL(soa);                                                   \
+        return (type*) __builtin_assume_aligned(soa->field, _SOA_ALIGNMENT);   \
+    }
+
+#define _SOA_UNPACK(type, field) type, field
+#define _SOA_CALL(macro, args) macro args
+#define _SOA_APPLY(macro, type_name, func_name, pair) _SOA_CALL(macro, (type_name, func_name, _SOA_UNPACK pair))
+
+#define _SOA_FOR_EACH_1(macro, type_name, func_name, pair) _SOA_APPLY(macro, type_name, func_name, pair)
+#define _SOA_FOR_EACH_2(macro, type_name, func_name, pair, ...) \
+    _SOA_APPLY(macro, type_name, func_name, pair) _SOA_FOR_EACH_1(macro, type_name, func_name, __VA_ARGS__)
+#define _SOA_FOR_EACH_3(macro, type_name, func_name, pair, ...) \
+    _SOA_APPLY(macro, type_name, func_name, pair) _SOA_FOR_EACH_2(macro, type_name, func_name, __VA_ARGS__)
+#define _SOA_FOR_EACH_4(macro, type_name, func_name, pair, ...) \
+    _SOA_APPLY(macro, type_name, func_name, pair) _SOA_FOR_EACH_3(macro, type_name, func_name, __VA_ARGS__)
+#define _SOA_FOR_EACH_5(macro, type_name, func_name, pair, ...) \
+    _SOA_APPLY(macro, type_name, func_name, pair) _SOA_FOR_EACH_4(macro, type_name, func_name, __VA_ARGS__)
+#define _SOA_FOR_EACH_6(macro, type_name, func_name, pair, ...) \
+    _SOA_APPLY(macro, type_name, func_name, pair) _SOA_FOR_EACH_5(macro, type_name, func_name, __VA_ARGS__)
+#define _SOA_FOR_EACH_7(macro, type_name, func_name, pair, ...) \
+    _SOA_APPLY(macro, type_name, func_name, pair) _SOA_FOR_EACH_6(macro, type_name, func_name, __VA_ARGS__)
+#define _SOA_FOR_EACH_8(macro, type_name, func_name, pair, ...) \
+    _SOA_APPLY(macro, type_name, func_name, pair) _SOA_FOR_EACH_7(macro, type_name, func_name, __VA_ARGS__)
+
+#define _SOA_COUNT_ARGS_IMPL(_1, _2, _3, _4, _5, _6, _7, _8, N, ...) N
+#define _SOA_COUNT_ARGS(...) _SOA_COUNT_ARGS_IMPL(__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1)
+#define _SOA_CONCAT_IMPL(left, right) left##right
+#define _SOA_CONCAT(left, right) _SOA_CONCAT_IMPL(left, right)
+#define _SOA_FOR_EACH(macro, type_name, func_name, ...) \
+    _SOA_CONCAT(_SOA_FOR_EACH_, _SOA_COUNT_ARGS(__VA_ARGS__))(macro, type_name, func_name, __VA_ARGS__)
+
+#endif
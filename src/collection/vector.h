@@ -16,7 +16,7 @@
     DEFINE_OPTION(type*, type_name, func_name, NULL)                                                           \
                                                                                                                \
     static inline Vec##type_name* vec_##func_name##_new(usize initial_capacity) {                              \
-        Vec##type_name* vec = (Vec##type_name*) heap_many(sizeof(Vec##type_name), initial_capacity);           \
+        Vec##type_name* vec = (Vec##type_name*) heap_one(sizeof(Vec##type_name));                             \
         vec->elements = (type**) heap_many(sizeof(type*), initial_capacity);                                   \
         vec->count = 0;                                                                                        \
         vec->capacity = initial_capacity;                                                                      \
@@ -32,7 +32,7 @@
         Vec##type_name* cloned = vec_##func_name##_new(vec->capacity);                                         \
         cloned->count = vec->count;                                                                            \
         for (usize i = 0; i < vec->count; i++) {                                                               \
-            if (cloned->elements[i] != NULL) {                                                                 \
+            if (vec->elements[i] != NULL) {                                                                    \
                 cloned->elements[i] = clone(vec->elements[i]);                                                 \
             } else {                                                                                           \
                 cloned->elements[i] = NULL;                                                                    \
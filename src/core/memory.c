@@ -35,4 +35,13 @@ void* heap_renew(void* existing, usize size, usize count) {
 	return result;
 }
 
+void* heap_aligned(usize alignment, usize size, usize count) {
+	usize total = size * count;
+	total = (total + alignment - 1) / alignment * alignment;
+	void* result = aligned_alloc(alignment, total > 0 ? total : alignment);
+	if (result == NULL) {
+		panic(str_static("[CTK ERROR]: Could not allocate memory for function 'heap_aligned()'"));
+	}
+	return result;
+}
 
@@ -0,0 +1,32 @@
+#ifndef CTK_SIMD_H
+#define CTK_SIMD_H
+
+#include "../core/type.h"
+
+// Defining CTK_NO_SIMD at build time forces every kernel onto its portable scalar path
+#if (defined(__x86_64__) || defined(__i386__)) && !defined(CTK_NO_SIMD)
+#include <immintrin.h>
+#define _SIMD_X86 1
+#endif
+
+#if defined(_SIMD_X86) && defined(__SSE2__)
+#define _SIMD_SSE2 1
+#endif
+
+#ifdef _SIMD_X86
+#define _SIMD_TARGET_AVX2 __attribute__((target("avx2,popcnt")))
+#endif
+
+/**
+ * @return true if AVX2 (and POPCNT) kernels may be used on the running cpu
+ * @note always false when built without x86 SIMD support or with CTK_NO_SIMD defined
+ */
+static inline bool simd_has_avx2() {
+#ifdef _SIMD_X86
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+#else
+    return false;
+#endif
+}
+
+#endif
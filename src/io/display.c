@@ -1,22 +1,25 @@
 #include "display.h"
 #include "../core/error.h"
 #include "../core/memory.h"
+#include "../string/number.h"
 #include <stdio.h>
 
 void _print(_Display display) {
 	ASSERT_NONNULL(display.param);
+    c8 digits[NUMBER_FLOAT_MAX_CHARS];
+
     switch (display.type) {
-        case _TYPE_INT_32: printf("%d", *(i32*) display.param); break;
-        case _TYPE_INT_64: printf("%ld", *(i64*) display.param); break;
-        case _TYPE_UINT: printf("%zu", *(usize*) display.param); break;
-        case _TYPE_FLOAT_32: printf("%.2f", *(f32*) display.param); break;
-        case _TYPE_FLOAT_64: printf("%.2f", *(f64*) display.param); break;
+        case _TYPE_INT_32: fwrite(digits, 1, number_format_i64(digits, *(i32*) display.param), stdout); break;
+        case _TYPE_INT_64: fwrite(digits, 1, number_format_i64(digits, *(i64*) display.param), stdout); break;
+        case _TYPE_UINT: fwrite(digits, 1, number_format_u64(digits, *(usize*) display.param), stdout); break;
+        case _TYPE_FLOAT_32: fwrite(digits, 1, number_format_f32(digits, *(f32*) display.param), stdout); break;
+        case _TYPE_FLOAT_64: fwrite(digits, 1, number_format_f64(digits, *(f64*) display.param), stdout); break;
         case _TYPE_CHAR_ARR: puts((char*) display.param); break;
         case _TYPE_CHAR: putchar(*(char*) display.param); break;
         case _TYPE_BOOL: puts(*(bool*) display.param ? "true" : "false"); break;
         case _TYPE_STR: fwrite(((StrSlice*) display.param)->buffer, 1, ((StrSlice*) display.param)->length, stdout); break;
         case _TYPE_CSTR: fwrite(((CStrSlice*) display.param)->buffer, 1, ((CStrSlice*) display.param)->length, stdout); break;
-        case _TYPE_STRING: fwrite(((String*) display.param)->buffer, 1, ((String*) display.param)->length, stdout); break;
+        case _TYPE_STRING: fwrite(string_buffer(display.param), 1, string_length(display.param), stdout); break;
         case _TYPE_CSTRING: fwrite(((CString*) display.param)->buffer, 1, ((CString*) display.param)->length, stdout); break;
     }
 }
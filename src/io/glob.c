@@ -0,0 +1,656 @@
+#include "glob.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../core/memory.h"
+
+#define _TOKEN_BYTES    0
+#define _TOKEN_STAR     1
+#define _TOKEN_ANYTHING 2
+#define _TOKEN_DIRS     3
+
+#define _SHAPE_PROGRAM 0
+#define _SHAPE_EXACT   1
+#define _SHAPE_PREFIX  2
+#define _SHAPE_SUFFIX  3
+#define _SHAPE_TAIL    4
+
+#define _GLOB_STACK_WORDS 32
+
+typedef struct {
+    u8 kind;
+    i16 byte;
+    u64 set[4];
+} GlobToken;
+
+// MARK: Internal (Parser)
+
+static inline void set_add(u64* set, u8 byte) {
+    set[byte / 64] |= (u64) 1 << (byte % 64);
+}
+
+static inline bool set_contains(const u64* set, u8 byte) {
+    return (set[byte / 64] >> (byte % 64)) & 1;
+}
+
+static void push_bytes(GlobToken* tokens, usize* count, const u64* set, i16 byte) {
+    GlobToken* token = &tokens[(*count)++];
+    token->kind = _TOKEN_BYTES;
+    token->byte = byte;
+    memcpy(token->set, set, sizeof(token->set));
+}
+
+static void push_literal(GlobToken* tokens, usize* count, u8 byte) {
+    u64 set[4] = {0};
+    set_add(set, byte);
+    push_bytes(tokens, count, set, byte);
+}
+
+static void push_wildcard(GlobToken* tokens, usize* count, u8 kind) {
+    // runs of the same wildcard match exactly what one of them does
+    if (*count > 0 && tokens[*count - 1].kind == kind && kind != _TOKEN_BYTES) {
+        return;
+    }
+
+    GlobToken* token = &tokens[(*count)++];
+    token->kind = kind;
+    token->byte = -1;
+}
+
+static bool parse_class(const c8* pattern, usize length, usize* index, u64* set) {
+    usize i = *index + 1;
+    bool negate = i < length && (pattern[i] == '!' || pattern[i] == '^');
+    if (negate) {
+        i++;
+    }
+
+    // a ']' right after the opening bracket is taken literally, the same as in shells
+    bool first = true;
+    while (i < length && (pattern[i] != ']' || first)) {
+        first = false;
+
+        u8 low = pattern[i++];
+        if (low == '\\') {
+            if (i == length) {
+                return false;
+            }
+            low = pattern[i++];
+        }
+
+        u8 high = low;
+        if (i + 1 < length && pattern[i] == '-' && pattern[i + 1] != ']') {
+            i++;
+            high = pattern[i++];
+            if (high == '\\') {
+                if (i == length) {
+                    return false;
+                }
+                high = pattern[i++];
+            }
+        }
+
+        for (u32 byte = low; byte <= high; byte++) {
+            set_add(set, byte);
+        }
+    }
+
+    if (i == length) {
+        return false;
+    }
+
+    if (negate) {
+        for (usize word = 0; word < 4; word++) {
+            set[word] = ~set[word];
+        }
+    }
+
+    set[0] &= ~((u64) 1 << '/');
+    *index = i + 1;
+    return true;
+}
+
+/**
+ * @return true and fills tokens, which must hold pattern->length entries, or false with the offending index in error
+ */
+static bool glob_parse(const StrSlice* pattern, GlobToken* tokens, usize* count, usize* error) {
+    const c8* buffer = pattern->buffer;
+    usize length = pattern->length;
+    usize i = 0;
+    *count = 0;
+
+    while (i < length) {
+        c8 current = buffer[i];
+
+        if (current == '*') {
+            usize end = i;
+            while (end < length && buffer[end] == '*') {
+                end++;
+            }
+
+            bool component = end - i >= 2 && (i == 0 || buffer[i - 1] == '/') && (end == length || buffer[end] == '/');
+            if (component && end == length) {
+                push_wildcard(tokens, count, _TOKEN_ANYTHING);
+            } else if (component) {
+                push_wildcard(tokens, count, _TOKEN_DIRS);
+                end++;
+            } else {
+                push_wildcard(tokens, count, _TOKEN_STAR);
+            }
+
+            i = end;
+        } else if (current == '?') {
+            u64 set[4] = {~(u64) 0, ~(u64) 0, ~(u64) 0, ~(u64) 0};
+            set[0] &= ~((u64) 1 << '/');
+            push_bytes(tokens, count, set, -1);
+            i++;
+        } else if (current == '[') {
+            u64 set[4] = {0};
+            if (!parse_class(buffer, length, &i, set)) {
+                *error = i;
+                return false;
+            }
+            push_bytes(tokens, count, set, -1);
+        } else if (current == '\\') {
+            if (i + 1 == length) {
+                *error = i;
+                return false;
+            }
+            push_literal(tokens, count, buffer[i + 1]);
+            i += 2;
+        } else {
+            push_literal(tokens, count, current);
+            i++;
+        }
+    }
+
+    return true;
+}
+
+// MARK: Internal (Literal)
+
+static bool tokens_literal(const GlobToken* tokens, usize start, usize end, bool slashes) {
+    for (usize i = start; i < end; i++) {
+        if (tokens[i].kind != _TOKEN_BYTES || tokens[i].byte < 0 || (!slashes && tokens[i].byte == '/')) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief sets literal to the shape the tokens reduce to, which is _SHAPE_PROGRAM if they need the NFA
+ */
+static void literal_detect(const GlobToken* tokens, usize count, GlobLiteral* literal) {
+    usize start = 0;
+    usize end = count;
+    u8 last = count > 0 ? tokens[count - 1].kind : _TOKEN_BYTES;
+
+    literal->slash_free = false;
+    if (tokens_literal(tokens, 0, count, true)) {
+        literal->shape = _SHAPE_EXACT;
+    } else if ((last == _TOKEN_STAR || last == _TOKEN_ANYTHING) && tokens_literal(tokens, 0, count - 1, true)) {
+        literal->shape = _SHAPE_PREFIX;
+        literal->slash_free = last == _TOKEN_STAR;
+        end = count - 1;
+    } else if (tokens[0].kind == _TOKEN_STAR && tokens_literal(tokens, 1, count, true)) {
+        literal->shape = _SHAPE_SUFFIX;
+        literal->slash_free = true;
+        start = 1;
+    } else if (tokens[0].kind == _TOKEN_DIRS && tokens_literal(tokens, 1, count, true)) {
+        literal->shape = _SHAPE_TAIL;
+        start = 1;
+    } else if (tokens[0].kind == _TOKEN_DIRS && count > 1 && tokens[1].kind == _TOKEN_STAR
+               && tokens_literal(tokens, 2, count, false)) {
+        // the last component ends with the literal, and everything before it is taken by the "**" and the '*'
+        literal->shape = _SHAPE_SUFFIX;
+        start = 2;
+    } else {
+        literal->shape = _SHAPE_PROGRAM;
+        literal->literal = NULL;
+        literal->length = 0;
+        return;
+    }
+
+    literal->length = end - start;
+    literal->literal = heap_many(sizeof(c8), literal->length + 1);
+    for (usize i = start; i < end; i++) {
+        literal->literal[i - start] = tokens[i].byte;
+    }
+}
+
+static bool literal_matches(const GlobLiteral* literal, const StrSlice* path) {
+    usize length = literal->length;
+    if (path->length < length) {
+        return false;
+    }
+
+    usize rest = path->length - length;
+    switch (literal->shape) {
+        case _SHAPE_EXACT:
+            return rest == 0 && memcmp(path->buffer, literal->literal, length) == 0;
+        case _SHAPE_PREFIX:
+            return memcmp(path->buffer, literal->literal, length) == 0
+                && (!literal->slash_free || bytes_find(path->buffer + length, rest, '/') == rest);
+        case _SHAPE_SUFFIX:
+            return memcmp(path->buffer + rest, literal->literal, length) == 0
+                && (!literal->slash_free || bytes_find(path->buffer, rest, '/') == rest);
+        default:
+            return memcmp(path->buffer + rest, literal->literal, length) == 0
+                && (rest == 0 || path->buffer[rest - 1] == '/');
+    }
+}
+
+// MARK: Internal (Program)
+
+static inline void bits_add(u64* bits, usize position) {
+    bits[position / 64] |= (u64) 1 << (position % 64);
+}
+
+static inline bool bits_contains(const u64* bits, usize position) {
+    return (bits[position / 64] >> (position % 64)) & 1;
+}
+
+/**
+ * @return the number of state bits the tokens take, a "**\/" taking two and the final position one
+ */
+static usize tokens_positions(const GlobToken* tokens, usize count) {
+    usize positions = 1;
+    for (usize i = 0; i < count; i++) {
+        positions += tokens[i].kind == _TOKEN_DIRS ? 2 : 1;
+    }
+
+    return positions;
+}
+
+static void program_init(GlobProgram* program, usize positions) {
+    usize words = (positions + 63) / 64;
+
+    // every table lives in one block, so the whole program is freed with accept
+    program->accept = heap_clear(sizeof(u64), words * (2 * 256 + 4));
+    program->loop = program->accept + 256 * words;
+    program->starts = program->loop + 256 * words;
+    program->epsilon = program->starts + words;
+    program->dirs = program->epsilon + words;
+    program->finals = program->dirs + words;
+    program->words = words;
+    program->has_dirs = false;
+}
+
+/**
+ * @return the final position of the tokens, laid out from the given position onwards
+ */
+static usize program_append(GlobProgram* program, const GlobToken* tokens, usize count, usize position) {
+    usize words = program->words;
+    bits_add(program->starts, position);
+
+    for (usize i = 0; i < count; i++) {
+        const GlobToken* token = &tokens[i];
+
+        switch (token->kind) {
+            case _TOKEN_BYTES:
+                for (usize byte = 0; byte < 256; byte++) {
+                    if (set_contains(token->set, byte)) {
+                        bits_add(program->accept + byte * words, position);
+                    }
+                }
+                break;
+            case _TOKEN_STAR:
+            case _TOKEN_ANYTHING:
+                for (usize byte = 0; byte < 256; byte++) {
+                    if (byte != '/' || token->kind == _TOKEN_ANYTHING) {
+                        bits_add(program->loop + byte * words, position);
+                    }
+                }
+                bits_add(program->epsilon, position);
+                break;
+            default:
+                bits_add(program->dirs, position);
+                program->has_dirs = true;
+                position++;
+                break;
+        }
+
+        position++;
+    }
+
+    bits_add(program->finals, position);
+    return position;
+}
+
+/**
+ * @brief ors every bit of bits within mask, shifted up by shift, back into bits
+ */
+static inline void bits_shift_or(u64* bits, const u64* mask, usize shift, usize words) {
+    u64 carry = 0;
+    for (usize i = 0; i < words; i++) {
+        u64 moved = bits[i] & mask[i];
+        bits[i] |= (moved << shift) | carry;
+        carry = moved >> (64 - shift);
+    }
+}
+
+/**
+ * @brief adds every position reachable without consuming a byte
+ * @note a "**\/" may skip past its two bits and then a '*' past its one, which is as far as skipping goes, since
+ *       runs of wildcards are merged when parsing and a "**\/" can only follow a '/'
+ */
+static inline void program_close(const GlobProgram* program, u64* state) {
+    if (program->has_dirs) {
+        bits_shift_or(state, program->dirs, 2, program->words);
+    }
+    bits_shift_or(state, program->epsilon, 1, program->words);
+}
+
+static void program_start(GlobProgram* program) {
+    program_close(program, program->starts);
+}
+
+/**
+ * @return the state after running the whole path, which is one of state or next, or NULL once no position is left
+ */
+static const u64* program_run(const GlobProgram* program, const StrSlice* path, u64* state, u64* next) {
+    usize words = program->words;
+    memcpy(state, program->starts, words * sizeof(u64));
+
+    for (usize i = 0; i < path->length; i++) {
+        u8 byte = path->buffer[i];
+        const u64* accept = program->accept + byte * words;
+        const u64* loop = program->loop + byte * words;
+
+        u64 carry = 0;
+        for (usize word = 0; word < words; word++) {
+            u64 advanced = state[word] & accept[word];
+            next[word] = (advanced << 1) | carry | (state[word] & loop[word]);
+            carry = advanced >> 63;
+        }
+
+        if (program->has_dirs) {
+            // a "**\/" sits at a component boundary in its first bit and inside a component in its second, and from
+            // either moves to the boundary on '/' and inside on any other byte
+            carry = 0;
+            for (usize word = 0; word < words; word++) {
+                u64 above = word + 1 < words ? state[word + 1] << 63 : 0;
+                u64 dirs = (state[word] | (state[word] >> 1) | above) & program->dirs[word];
+                if (byte == '/') {
+                    next[word] |= dirs;
+                } else {
+                    next[word] |= (dirs << 1) | carry;
+                    carry = dirs >> 63;
+                }
+            }
+        }
+
+        program_close(program, next);
+
+        u64 alive = 0;
+        for (usize word = 0; word < words; word++) {
+            alive |= next[word];
+        }
+        if (alive == 0) {
+            return NULL;
+        }
+
+        u64* swap = state;
+        state = next;
+        next = swap;
+    }
+
+    return state;
+}
+
+/**
+ * @return the state after running the whole path through a program that fits in a single word, or 0
+ * @note same as program_run(), kept in registers since most patterns have fewer than 64 positions
+ */
+static u64 program_run_word(const GlobProgram* program, const StrSlice* path) {
+    u64 state = program->starts[0];
+    u64 epsilon = program->epsilon[0];
+    u64 dirs = program->dirs[0];
+
+    for (usize i = 0; i < path->length; i++) {
+        u8 byte = path->buffer[i];
+        u64 next = ((state & program->accept[byte]) << 1) | (state & program->loop[byte]);
+        u64 boundary = (state | (state >> 1)) & dirs;
+        next |= byte == '/' ? boundary : boundary << 1;
+        next |= (next & dirs) << 2;
+        next |= (next & epsilon) << 1;
+
+        if (next == 0) {
+            return 0;
+        }
+        state = next;
+    }
+
+    return state;
+}
+
+static void program_free(GlobProgram* program) {
+    free(program->accept);
+    program->accept = NULL;
+}
+
+// MARK: Internal (Set)
+
+/**
+ * @return the index of the first pattern matching the path, or set->count if none does
+ * @note with matches given every matching index is pushed onto it instead of returning at the first
+ */
+static usize set_scan(const GlobSet* set, const StrSlice* path, StrIndices* matches) {
+    u64 stack[2 * _GLOB_STACK_WORDS];
+    u64* scratch = NULL;
+    const u64* state = NULL;
+    u64 word;
+    bool ran = false;
+    usize found = set->count;
+
+    for (usize i = 0; i < set->count; i++) {
+        bool matched;
+        if (set->literals[i].shape != _SHAPE_PROGRAM) {
+            matched = literal_matches(&set->literals[i], path);
+        } else {
+            // the program runs at most once, and only when a pattern that needs it is reached
+            if (!ran && set->program.words == 1) {
+                word = program_run_word(&set->program, path);
+                state = &word;
+                ran = true;
+            } else if (!ran) {
+                usize words = set->program.words;
+                u64* buffer = stack;
+                if (words > _GLOB_STACK_WORDS) {
+                    scratch = heap_many(sizeof(u64), 2 * words);
+                    buffer = scratch;
+                }
+                state = program_run(&set->program, path, buffer, buffer + words);
+                ran = true;
+            }
+            matched = state != NULL && bits_contains(state, set->finals[i]);
+        }
+
+        if (matched) {
+            if (matches == NULL) {
+                found = i;
+                break;
+            }
+            matches->indices[matches->count++] = i;
+        }
+    }
+
+    free(scratch);
+    return found;
+}
+
+// MARK: Lifecycle
+
+Glob* glob_new(const StrSlice* pattern) {
+    ASSERT_NONNULL(pattern);
+
+    GlobToken* tokens = heap_many(sizeof(GlobToken), pattern->length + 1);
+    usize count;
+    usize error;
+    if (!glob_parse(pattern, tokens, &count, &error)) {
+        free(tokens);
+        return NULL;
+    }
+
+    Glob* glob = heap_one(sizeof(Glob));
+    literal_detect(tokens, count, &glob->literal);
+    if (glob->literal.shape == _SHAPE_PROGRAM) {
+        program_init(&glob->program, tokens_positions(tokens, count));
+        program_append(&glob->program, tokens, count, 0);
+        program_start(&glob->program);
+    } else {
+        glob->program = (GlobProgram) {0};
+    }
+
+    free(tokens);
+    return glob;
+}
+
+GlobSet* glob_set_new(const StrSlice* patterns, usize count) {
+    ASSERT_NONNULL(patterns);
+
+    GlobToken** tokens = heap_clear(sizeof(GlobToken*), count + 1);
+    usize* token_counts = heap_many(sizeof(usize), count + 1);
+    GlobSet* set = heap_one(sizeof(GlobSet));
+    set->literals = heap_clear(sizeof(GlobLiteral), count + 1);
+    set->finals = heap_clear(sizeof(usize), count + 1);
+    set->count = count;
+
+    // every pattern is parsed first, so the shared program is allocated once at its final size
+    usize positions = 0;
+    bool valid = true;
+    for (usize i = 0; i < count && valid; i++) {
+        usize error;
+        tokens[i] = heap_many(sizeof(GlobToken), patterns[i].length + 1);
+        valid = glob_parse(&patterns[i], tokens[i], &token_counts[i], &error);
+        if (valid) {
+            literal_detect(tokens[i], token_counts[i], &set->literals[i]);
+            if (set->literals[i].shape == _SHAPE_PROGRAM) {
+                positions += tokens_positions(tokens[i], token_counts[i]);
+            }
+        }
+    }
+
+    if (valid) {
+        program_init(&set->program, positions == 0 ? 1 : positions);
+
+        usize position = 0;
+        for (usize i = 0; i < count; i++) {
+            if (set->literals[i].shape == _SHAPE_PROGRAM) {
+                set->finals[i] = program_append(&set->program, tokens[i], token_counts[i], position);
+                position = set->finals[i] + 1;
+            }
+        }
+        program_start(&set->program);
+    }
+
+    for (usize i = 0; i < count; i++) {
+        free(tokens[i]);
+    }
+    free(tokens);
+    free(token_counts);
+
+    if (!valid) {
+        set->program = (GlobProgram) {0};
+        glob_set_free(&set);
+    }
+
+    return set;
+}
+
+void glob_free(Glob** glob) {
+    ASSERT_NONNULL(glob);
+    ASSERT_NONNULL(*glob);
+
+    program_free(&(*glob)->program);
+    free((*glob)->literal.literal);
+    free(*glob);
+    *glob = NULL;
+}
+
+void glob_set_free(GlobSet** set) {
+    ASSERT_NONNULL(set);
+    ASSERT_NONNULL(*set);
+
+    program_free(&(*set)->program);
+    for (usize i = 0; i < (*set)->count; i++) {
+        free((*set)->literals[i].literal);
+    }
+    free((*set)->literals);
+    free((*set)->finals);
+    free(*set);
+    *set = NULL;
+}
+
+// MARK: Query
+
+OptionIndex glob_syntax_error(const StrSlice* pattern) {
+    ASSERT_NONNULL(pattern);
+
+    GlobToken* tokens = heap_many(sizeof(GlobToken), pattern->length + 1);
+    usize count;
+    usize error;
+    bool valid = glob_parse(pattern, tokens, &count, &error);
+    free(tokens);
+
+    return valid ? option_index_empty() : option_index(error);
+}
+
+bool glob_matches(const Glob* glob, const StrSlice* path) {
+    ASSERT_NONNULL(glob);
+    ASSERT_NONNULL(path);
+
+    if (glob->literal.shape != _SHAPE_PROGRAM) {
+        return literal_matches(&glob->literal, path);
+    }
+
+    const GlobProgram* program = &glob->program;
+    if (program->words == 1) {
+        return (program_run_word(program, path) & program->finals[0]) != 0;
+    }
+
+    u64 stack[2 * _GLOB_STACK_WORDS];
+    u64* scratch = NULL;
+    u64* buffer = stack;
+    if (program->words > _GLOB_STACK_WORDS) {
+        scratch = heap_many(sizeof(u64), 2 * program->words);
+        buffer = scratch;
+    }
+
+    const u64* state = program_run(program, path, buffer, buffer + program->words);
+    bool matched = false;
+    for (usize word = 0; state != NULL && word < program->words; word++) {
+        matched |= (state[word] & program->finals[word]) != 0;
+    }
+
+    free(scratch);
+    return matched;
+}
+
+bool glob_set_is_match(const GlobSet* set, const StrSlice* path) {
+    ASSERT_NONNULL(set);
+    ASSERT_NONNULL(path);
+
+    return set_scan(set, path, NULL) < set->count;
+}
+
+OptionIndex glob_set_find(const GlobSet* set, const StrSlice* path) {
+    ASSERT_NONNULL(set);
+    ASSERT_NONNULL(path);
+
+    usize found = set_scan(set, path, NULL);
+    return found < set->count ? option_index(found) : option_index_empty();
+}
+
+StrIndices* glob_set_matches(const GlobSet* set, const StrSlice* path) {
+    ASSERT_NONNULL(set);
+    ASSERT_NONNULL(path);
+
+    StrIndices* matches = heap_one(sizeof(StrIndices));
+    matches->indices = heap_many(sizeof(usize), set->count + 1);
+    matches->count = 0;
+    set_scan(set, path, matches);
+
+    return matches;
+}
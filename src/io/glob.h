@@ -0,0 +1,130 @@
+#ifndef CTK_GLOB_H
+#define CTK_GLOB_H
+
+#include "../io/path.h"
+#include "../string/search.h"
+#include "../string/string.h"
+
+// MARK: Definition
+
+/**
+ * @brief Bit parallel NFA over the positions of one or more glob patterns, where bit i of a state means the first
+ *        i tokens of a pattern have matched
+ * @note internal to Glob and GlobSet, the tables hold words 64 bit words per entry, with accept and loop indexed
+ *       by byte first
+ */
+typedef struct {
+    u64* accept;
+    u64* loop;
+    u64* starts;
+    u64* epsilon;
+    u64* dirs;
+    u64* finals;
+    usize words;
+    bool has_dirs;
+} GlobProgram;
+
+/**
+ * @brief Literal a pattern reduces to when it has at most one wildcard, such as "Makefile", "*.c", "**\/build"
+ *        or a directory followed by "**", checked with a single compare instead of running a GlobProgram
+ * @note internal to Glob and GlobSet
+ */
+typedef struct {
+    u8 shape;
+    bool slash_free;
+    c8* literal;
+    usize length;
+} GlobLiteral;
+
+/**
+ * @brief Glob pattern compiled once and matched against any number of '/' separated paths without copying them
+ * @note '*' matches any run of bytes but '/', '?' any one byte but '/', and [abc] [a-z] [!a-z] [^a-z] one byte but
+ *       '/' from the class, while '\' escapes the byte after it
+ * @note "**" spanning a whole component matches any number of components, so "**\/x" matches "x" and "a/b/x", and
+ *       "**" as the last component matches everything below, while "**" anywhere else is the same as '*'
+ * @note matching simulates every position of the pattern at once with shifts and masks, so it is linear in the
+ *       length of the path and never backtracks, however many wildcards the pattern has
+ */
+typedef struct {
+    GlobProgram program;
+    GlobLiteral literal;
+} Glob;
+
+/**
+ * @brief Set of globs compiled together, so a path is scanned once whatever the number of patterns
+ * @note patterns reducing to a GlobLiteral are compared directly, every other pattern shares one GlobProgram
+ */
+typedef struct {
+    GlobProgram program;
+    GlobLiteral* literals;
+    usize* finals;
+    usize count;
+} GlobSet;
+
+// MARK: Lifecycle
+
+/**
+ * @return heap allocated glob compiled from the given pattern, or NULL if the pattern is not valid
+ * @note the pattern may be freed once this returns, see glob_syntax_error() for why a pattern was rejected
+ * @note must be freed
+ */
+Glob* glob_new(const StrSlice* pattern) __attribute__((warn_unused_result)) __attribute__((nonnull(1)));
+
+/**
+ * @return heap allocated set of every given pattern, or NULL if any of them is not valid
+ * @note the patterns may be freed once this returns, and matches report their index in the given order
+ * @note must be freed
+ */
+GlobSet* glob_set_new(const StrSlice* patterns, usize count)
+    __attribute__((warn_unused_result))
+    __attribute__((nonnull(1)));
+
+/**
+ * @brief deep free of Glob* and sets pointer to NULL
+ */
+void glob_free(Glob** glob) __attribute__((nonnull(1)));
+
+/**
+ * @brief deep free of GlobSet* and sets pointer to NULL
+ */
+void glob_set_free(GlobSet** set) __attribute__((nonnull(1)));
+
+// MARK: Query
+
+/**
+ * @return the index of the unterminated '[' or of a trailing '\' in the pattern, or an empty optional if valid
+ */
+OptionIndex glob_syntax_error(const StrSlice* pattern) __attribute__((nonnull(1)));
+
+/**
+ * @return true if the glob matches the whole of the given path
+ */
+bool glob_matches(const Glob* glob, const StrSlice* path) __attribute__((nonnull(1, 2)));
+
+/**
+ * @return true if the glob matches the whole uri of the given path
+ */
+__attribute__((nonnull(1, 2))) static inline bool glob_matches_path(const Glob* glob, const Path* path) {
+    return glob_matches(glob, cstring_as_str_ref(path->uri));
+}
+
+/**
+ * @return true if any pattern of the set matches the whole of the given path
+ */
+bool glob_set_is_match(const GlobSet* set, const StrSlice* path) __attribute__((nonnull(1, 2)));
+
+/**
+ * @return the index of the first pattern of the set matching the whole of the given path, or an empty optional
+ */
+OptionIndex glob_set_find(const GlobSet* set, const StrSlice* path) __attribute__((nonnull(1, 2)));
+
+/**
+ * @return a heap allocated list of the index of every pattern of the set matching the whole of the given path,
+ *         in ascending order
+ * @note this does need to be freed
+ */
+StrIndices* glob_set_matches(const GlobSet* set, const StrSlice* path)
+    __attribute__((nonnull(1, 2)))
+    __attribute__((warn_unused_result));
+
+#endif
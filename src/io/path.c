@@ -1,7 +1,10 @@
 #include "path.h"
 #include <assert.h>
+#include <string.h>
 #include "../core/memory.h"
 #include "../os/env.h"
+#include "../string/builder.h"
+#include "../string/split.h"
 #include "io.h"
 #include "unistd.h"
 
@@ -11,18 +14,18 @@ PathMut* path_mut_new(const StrSlice* str) {
     ASSERT_NONNULL(str);
 
     PathMut* path_mut = heap_one(sizeof(PathMut));
-    StrSlices* split = str_split_slices(str, '/');
-    path_mut->nodes = vec_path_node_new(split->count);
+    path_mut->nodes = vec_path_node_new(str_count_char(str, '/') + 2);
 
-    if (str->buffer[0] == '/') {
-        vec_path_node_push_back_owned(path_mut->nodes, string_mut_new("/"));
+    if (str->length > 0 && str->buffer[0] == '/') {
+        vec_path_node_push_back_owned(path_mut->nodes, rc_string_new("/"));
     }
 
-    for (usize i = 0; i < split->count; i++) {
-        vec_path_node_push_back_owned(path_mut->nodes, str_to_owned_mut(&split->slices[i]));
-    }
+    StrSplitIter nodes = str_split_iter(str, '/');
+    StrSlice node;
 
-    str_slices_free(&split);
+    while (str_split_iter_next(&nodes, &node)) {
+        vec_path_node_push_back_owned(path_mut->nodes, rc_string_from_str(&node));
+    }
 
     return path_mut;
 }
@@ -46,7 +49,7 @@ PathMut* path_mut_user() {
     OptionEnvVar user = env_var(cstr_static("USER"));
     assert(user.present);
 
-    vec_path_node_push_back_owned(path_mut->nodes, str_to_owned_mut(&user.value));
+    vec_path_node_push_back_owned(path_mut->nodes, rc_string_from_str(&user.value));
 
     return path_mut;
 }
@@ -60,7 +63,7 @@ void path_mut_normalize(PathMut* path_mut) {
         PathMut* current = path_mut_current();
 
         for (usize j = 0; j < current->nodes->count; j++) {
-            StringMut* node_current = current->nodes->elements[j];
+            RcString* node_current = current->nodes->elements[j];
             vec_path_node_push_back_owned(path_mut->nodes, node_current);
         }
 
@@ -79,14 +82,14 @@ void path_mut_normalize(PathMut* path_mut) {
             continue;
         }
 
-        StringMut* node = node_opt.value;
-        bool is_slash = str_equals(string_mut_as_ref(node), str_static("/"));
-        bool is_back = str_equals(string_mut_as_ref(node), str_static(".."));
-        bool is_user = str_equals(string_mut_as_ref(node), str_static("~"));
+        RcString* node = node_opt.value;
+        bool is_slash = str_equals(rc_string_as_ref(node), str_static("/"));
+        bool is_back = str_equals(rc_string_as_ref(node), str_static(".."));
+        bool is_user = str_equals(rc_string_as_ref(node), str_static("~"));
 
         // "/" -> Add slash
         if (is_slash) {
-            vec_path_node_push_back_owned(normalized, string_mut_clone(node));
+            vec_path_node_push_back_owned(normalized, rc_string_clone(node));
             continue;
         }
 
@@ -95,8 +98,8 @@ void path_mut_normalize(PathMut* path_mut) {
             PathMut* home = path_mut_user();
 
             for (usize j = 0; j < home->nodes->count; j++) {
-                StringMut* node_current = home->nodes->elements[j];
-                vec_path_node_push_back_owned(normalized, string_mut_clone(node_current));
+                RcString* node_current = home->nodes->elements[j];
+                vec_path_node_push_back_owned(normalized, rc_string_clone(node_current));
             }
 
             path_mut_free(&home);
@@ -116,10 +119,10 @@ void path_mut_normalize(PathMut* path_mut) {
                 vec_path_node_push_back_owned(normalized, current->nodes->elements[0]);
             } else {
                 for (usize j = 0; j < current->nodes->count - 1; j++) {
-                    StringMut* node_current = current->nodes->elements[j];
+                    RcString* node_current = current->nodes->elements[j];
                     vec_path_node_push_back_owned(normalized, node_current);
                 }
-                string_mut_free(&current->nodes->elements[current->nodes->count - 1]);
+                rc_string_free(&current->nodes->elements[current->nodes->count - 1]);
             }
 
             free(current->nodes->elements);
@@ -131,14 +134,14 @@ void path_mut_normalize(PathMut* path_mut) {
 
         // ".." within path -> Remove previous if not at root
         if (is_back) {
-            bool only_root = normalized->count == 1 && str_equals(string_mut_as_ref(normalized->elements[0]), str_static("/"));
+            bool only_root = normalized->count == 1 && str_equals(rc_string_as_ref(normalized->elements[0]), str_static("/"));
             if (normalized->count >= 1 && !only_root) {
                 vec_path_node_delete(normalized, normalized->count - 1);
             }
             continue;
         }
 
-        vec_path_node_push_back_owned(normalized, string_mut_clone(node));
+        vec_path_node_push_back_owned(normalized, rc_string_clone(node));
     }
 
     // Nothing in normalized after normalization, user cwd
@@ -148,7 +151,7 @@ void path_mut_normalize(PathMut* path_mut) {
         vec_path_node_clear(path_mut->nodes);
 
         for (usize j = 0; j < current->nodes->count; j++) {
-            StringMut* node_current = current->nodes->elements[j];
+            RcString* node_current = current->nodes->elements[j];
             vec_path_node_push_back_owned(path_mut->nodes, node_current);
         }
 
@@ -168,25 +171,19 @@ Path* path_mut_to_path(PathMut* path_mut) {
     path_mut_normalize(path_mut);
 
     Path* path = heap_one(sizeof(Path));
-    StringMut* uri_mut = string_mut_new_sized(path_mut->nodes->count * 4);
+    StringBuilder uri;
+    string_builder_init(&uri);
 
+    // nodes are measured before anything is copied, so the uri is allocated once at its exact length
     for (usize i = 0; i < path_mut->nodes->count; i++) {
-        StringMut* current = path_mut->nodes->elements[i];
-        string_mut_push(uri_mut, string_mut_as_ref(current));
-        if (i < path_mut->nodes->count - 1 && !str_equals(string_mut_as_ref(current), str_static("/"))) {
-            string_mut_push_char(uri_mut, '/');
+        StrSlice* current = rc_string_as_ref(path_mut->nodes->elements[i]);
+        string_builder_push(&uri, current);
+        if (i < path_mut->nodes->count - 1 && !str_equals(current, str_static("/"))) {
+            string_builder_push(&uri, str_static("/"));
         }
     }
 
-    if (uri_mut->capacity < uri_mut->length + 1) {
-        uri_mut->buffer = heap_renew(uri_mut->buffer, sizeof(c8), ++uri_mut->capacity);
-    }
-
-    uri_mut->buffer[uri_mut->length] = '\0';
-    path->uri = heap_one(sizeof(CString));
-    path->uri->buffer = uri_mut->buffer;
-    path->uri->length = uri_mut->length;
-    free(uri_mut);
+    path->uri = string_builder_build_cstring(&uri);
 
     return path;
 }
@@ -214,23 +211,29 @@ void path_free(Path** path) {
 bool path_mut_is_absolute(PathMut* path_mut) {
     ASSERT_NONNULL(path_mut);
 
-    return path_mut->nodes->count > 0 && path_mut->nodes->elements[0]->buffer[0] == '/';
+    if (path_mut->nodes->count == 0) {
+        return false;
+    }
+
+    // nodes are not null terminated, so an empty first node has no byte to read
+    const RcString* first = path_mut->nodes->elements[0];
+    return first->length > 0 && first->buffer[0] == '/';
 }
 
 bool path_mut_is_root(PathMut* path_mut) {
     ASSERT_NONNULL(path_mut);
 
-    return path_mut->nodes->count == 1 && str_equals(string_mut_as_ref(path_mut->nodes->elements[0]), str_static("/"));
+    return path_mut->nodes->count == 1 && str_equals(rc_string_as_ref(path_mut->nodes->elements[0]), str_static("/"));
 }
 
 bool path_mut_is_empty(PathMut* path_mut) {
     ASSERT_NONNULL(path_mut);
 
-    vec_for_each(StringMut node, path_mut->nodes, {
-        if (node.length != 0) {
+    for (usize i = 0; i < path_mut->nodes->count; i++) {
+        if (path_mut->nodes->elements[i]->length != 0) {
             return false;
         }
-    });
+    }
 
     return true;
 }
@@ -242,7 +245,13 @@ OptionPathNodeRef path_mut_node(PathMut* path_mut, usize index) {
         return option_path_node_ref_empty();
     }
 
-    return option_path_node_ref(string_mut_as_ref(path_mut->nodes->elements[index]));
+    return option_path_node_ref(rc_string_as_ref(path_mut->nodes->elements[index]));
+}
+
+IterPathNode path_mut_iter(PathMut* path_mut) {
+    ASSERT_NONNULL(path_mut);
+
+    return iter_path_node_from_array(path_mut->nodes->elements, path_mut->nodes->count);
 }
 
 // MARK: Display
@@ -252,7 +261,7 @@ void path_mut_display(PathMut* path_mut) {
 
     for (usize i = 0; i < path_mut->nodes->count; i++) {
         print(str_static("\""));
-        print(string_mut_as_ref(path_mut->nodes->elements[i]));
+        print(rc_string_as_ref(path_mut->nodes->elements[i]));
         print(str_static("\""));
 
         if (i < path_mut->nodes->count - 1) {
@@ -269,5 +278,5 @@ void path_mut_append(PathMut* path_mut, const StrSlice* added) {
     ASSERT_NONNULL(path_mut);
     ASSERT_NONNULL(added);
 
-    vec_path_node_push_back_owned(path_mut->nodes, str_to_owned_mut(added));
+    vec_path_node_push_back_owned(path_mut->nodes, rc_string_from_str(added));
 }
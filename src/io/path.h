@@ -2,6 +2,7 @@
 #define CTK_PATH_H
 
 #include "../collection/vector.h"
+#include "../string/rc_string.h"
 #include "../string/string.h"
 
 #ifdef __APPLE__
@@ -10,8 +11,9 @@
 #define HOME_LITERAL "/home"
 #endif
 
-DEFINE_VEC(StringMut, PathNode, path_node, string_mut_clone, string_mut_free, str_compare)
+DEFINE_VEC(RcString, PathNode, path_node, rc_string_clone, rc_string_free, rc_string_compare)
 DEFINE_OPTION(StrSlice*, PathNodeRef, path_node_ref, NULL)
+DEFINE_ITER(RcString*, PathNode, path_node)
 
 // MARK: Definition
 
@@ -50,6 +52,12 @@ bool path_mut_is_empty(PathMut* path_mut) __attribute__((nonnull(1)));
 
 OptionPathNodeRef path_mut_node(PathMut* path_mut, usize index) __attribute__((nonnull(1)));
 
+/**
+ * @return a lazy iterator over the nodes of the given path without copying them
+ * @note the iterator is invalidated by any mutation of the path
+ */
+IterPathNode path_mut_iter(PathMut* path_mut) __attribute__((nonnull(1)));
+
 // MARK: Display
 
 void path_mut_display(PathMut* path_mut) __attribute__((nonnull(1)));
@@ -0,0 +1,184 @@
+#include "thread_pool.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "../core/error.h"
+#include "../core/memory.h"
+
+// MARK: Internal
+
+/**
+ * @brief takes the task at the head of the queue and runs it, with the lock held before and after
+ */
+static void thread_pool_run(ThreadPool* pool) {
+    ThreadPoolTask task = pool->tasks[pool->head];
+    pool->head = (pool->head + 1) % pool->capacity;
+    pool->count--;
+    pool->active++;
+
+    pthread_mutex_unlock(&pool->lock);
+    task.function(task.argument);
+    pthread_mutex_lock(&pool->lock);
+
+    pool->active--;
+    bool group_done = task.group != NULL && --task.group->pending == 0;
+    if (group_done || (pool->count == 0 && pool->active == 0)) {
+        pthread_cond_broadcast(&pool->idle);
+    }
+}
+
+/**
+ * @brief appends the given task to the queue and wakes a worker, with the lock held
+ */
+static void thread_pool_push(ThreadPool* pool, ThreadPoolTask task) {
+    if (pool->count >= pool->capacity) {
+        // unwrap the ring into a larger buffer so the queue stays in submission order
+        ThreadPoolTask* tasks = heap_many(sizeof(ThreadPoolTask), pool->capacity * 2);
+        for (usize i = 0; i < pool->count; i++) {
+            tasks[i] = pool->tasks[(pool->head + i) % pool->capacity];
+        }
+        free(pool->tasks);
+        pool->tasks = tasks;
+        pool->head = 0;
+        pool->capacity *= 2;
+    }
+
+    pool->tasks[(pool->head + pool->count) % pool->capacity] = task;
+    pool->count++;
+
+    pthread_cond_signal(&pool->available);
+}
+
+static void* thread_pool_worker(void* argument) {
+    ThreadPool* pool = argument;
+
+    pthread_mutex_lock(&pool->lock);
+
+    while (true) {
+        while (pool->count == 0 && !pool->stopping) {
+            pthread_cond_wait(&pool->available, &pool->lock);
+        }
+
+        if (pool->count == 0) {
+            break;
+        }
+
+        thread_pool_run(pool);
+    }
+
+    pthread_mutex_unlock(&pool->lock);
+
+    return NULL;
+}
+
+// MARK: Lifecycle
+
+ThreadPool* thread_pool_new(usize thread_count) {
+    if (thread_count == 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        thread_count = online > 0 ? (usize) online : 1;
+    }
+
+    ThreadPool* pool = heap_one(sizeof(ThreadPool));
+    pool->threads = heap_many(sizeof(pthread_t), thread_count);
+    pool->thread_count = thread_count;
+    pool->capacity = 16;
+    pool->tasks = heap_many(sizeof(ThreadPoolTask), pool->capacity);
+    pool->head = 0;
+    pool->count = 0;
+    pool->active = 0;
+    pool->stopping = false;
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->available, NULL);
+    pthread_cond_init(&pool->idle, NULL);
+
+    for (usize i = 0; i < thread_count; i++) {
+        if (pthread_create(&pool->threads[i], NULL, thread_pool_worker, pool) != 0) {
+            panic(str_static("[CTK ERROR]: Could not start worker thread for function 'thread_pool_new()'"));
+        }
+    }
+
+    return pool;
+}
+
+void thread_pool_group_init(ThreadPoolGroup* group) {
+    ASSERT_NONNULL(group);
+
+    group->pending = 0;
+}
+
+void thread_pool_free(ThreadPool** pool) {
+    ASSERT_NONNULL(pool);
+    ASSERT_NONNULL(*pool);
+
+    pthread_mutex_lock(&(*pool)->lock);
+    (*pool)->stopping = true;
+    pthread_cond_broadcast(&(*pool)->available);
+    pthread_mutex_unlock(&(*pool)->lock);
+
+    for (usize i = 0; i < (*pool)->thread_count; i++) {
+        pthread_join((*pool)->threads[i], NULL);
+    }
+
+    pthread_mutex_destroy(&(*pool)->lock);
+    pthread_cond_destroy(&(*pool)->available);
+    pthread_cond_destroy(&(*pool)->idle);
+
+    free((*pool)->threads);
+    free((*pool)->tasks);
+    free(*pool);
+    *pool = NULL;
+}
+
+// MARK: Mutation
+
+void thread_pool_submit(ThreadPool* pool, ThreadPoolFunction function, void* argument) {
+    ASSERT_NONNULL(pool);
+    ASSERT_NONNULL(function);
+
+    pthread_mutex_lock(&pool->lock);
+    thread_pool_push(pool, (ThreadPoolTask) {function, argument, NULL});
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void thread_pool_submit_group(ThreadPool* pool, ThreadPoolGroup* group, ThreadPoolFunction function, void* argument) {
+    ASSERT_NONNULL(pool);
+    ASSERT_NONNULL(group);
+    ASSERT_NONNULL(function);
+
+    pthread_mutex_lock(&pool->lock);
+    group->pending++;
+    thread_pool_push(pool, (ThreadPoolTask) {function, argument, group});
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void thread_pool_wait(ThreadPool* pool) {
+    ASSERT_NONNULL(pool);
+
+    pthread_mutex_lock(&pool->lock);
+
+    while (pool->count > 0 || pool->active > 0) {
+        pthread_cond_wait(&pool->idle, &pool->lock);
+    }
+
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void thread_pool_group_wait(ThreadPool* pool, ThreadPoolGroup* group) {
+    ASSERT_NONNULL(pool);
+    ASSERT_NONNULL(group);
+
+    pthread_mutex_lock(&pool->lock);
+
+    // running queued tasks here rather than sleeping means a waiting task still lends its thread to the pool
+    while (group->pending > 0) {
+        if (pool->count > 0) {
+            thread_pool_run(pool);
+        } else {
+            pthread_cond_wait(&pool->idle, &pool->lock);
+        }
+    }
+
+    pthread_mutex_unlock(&pool->lock);
+}
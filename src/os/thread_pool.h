@@ -0,0 +1,91 @@
+#ifndef CTK_THREAD_POOL_H
+#define CTK_THREAD_POOL_H
+
+#include <pthread.h>
+#include "../core/type.h"
+
+// MARK: Definition
+
+typedef void (*ThreadPoolFunction)(void* argument);
+
+/**
+ * @brief Count of the tasks submitted under it that have not finished yet, waited on with thread_pool_group_wait()
+ * @note stack allocated and guarded by the lock of the pool its tasks run on
+ */
+typedef struct {
+    usize pending;
+} ThreadPoolGroup;
+
+typedef struct {
+    ThreadPoolFunction function;
+    void* argument;
+    ThreadPoolGroup* group;
+} ThreadPoolTask;
+
+/**
+ * @brief Fixed set of worker threads pulling tasks from a shared FIFO queue
+ * @note tasks run in submission order but complete in any order, see thread_pool_wait()
+ */
+typedef struct {
+    pthread_t* threads;
+    usize thread_count;
+    ThreadPoolTask* tasks;
+    usize head;
+    usize count;
+    usize capacity;
+    usize active;
+    bool stopping;
+    pthread_mutex_t lock;
+    pthread_cond_t available;
+    pthread_cond_t idle;
+} ThreadPool;
+
+// MARK: Lifecycle
+
+/**
+ * @return heap allocated pool running the given number of worker threads
+ * @note a thread_count of 0 starts one worker per online cpu
+ * @note must be freed, which waits for every queued task to finish
+ */
+ThreadPool* thread_pool_new(usize thread_count) __attribute__((warn_unused_result));
+
+/**
+ * @brief waits for queued tasks, joins every worker, frees the pool, and sets pointer to NULL
+ */
+void thread_pool_free(ThreadPool** pool) __attribute__((nonnull(1)));
+
+/**
+ * @brief initializes a stack allocated group with no pending tasks, which does not need to be freed
+ */
+void thread_pool_group_init(ThreadPoolGroup* group) __attribute__((nonnull(1)));
+
+// MARK: Mutation
+
+/**
+ * @brief queues the given function to be called with the given argument on a worker thread
+ * @note the argument must stay valid until the task has run
+ */
+void thread_pool_submit(ThreadPool* pool, ThreadPoolFunction function, void* argument) __attribute__((nonnull(1, 2)));
+
+/**
+ * @brief queues the given function like thread_pool_submit(), counting it as pending in the given group until it
+ *        has run
+ * @note the group must stay valid until thread_pool_group_wait() returns for it
+ */
+void thread_pool_submit_group(ThreadPool* pool, ThreadPoolGroup* group, ThreadPoolFunction function, void* argument)
+    __attribute__((nonnull(1, 2, 3)));
+
+/**
+ * @brief blocks until the queue is empty and no worker is running a task
+ * @note this waits on every task of the pool, so it must not be called from a task, which would wait on itself
+ */
+void thread_pool_wait(ThreadPool* pool) __attribute__((nonnull(1)));
+
+/**
+ * @brief blocks until every task submitted under the given group has run, whatever else the pool is doing
+ * @note while tasks are queued the caller runs them itself instead of sleeping, so this may be called from a task
+ *       of the same pool without starving it of workers
+ */
+void thread_pool_group_wait(ThreadPool* pool, ThreadPoolGroup* group) __attribute__((nonnull(1, 2)));
+
+#endif
@@ -0,0 +1,147 @@
+#include "builder.h"
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../core/memory.h"
+
+// MARK: Internal
+
+/**
+ * @brief copies every piece, in order, into buffer, which must hold the builder's length
+ */
+static void builder_copy(const StringBuilder* builder, c8* buffer) {
+    for (usize i = 0; i < builder->count; i++) {
+        memcpy(buffer, builder->pieces[i].buffer, builder->pieces[i].length);
+        buffer += builder->pieces[i].length;
+    }
+}
+
+// MARK: Joining
+
+String* str_join(const StrSlices* slices, const StrSlice* separator) {
+    ASSERT_NONNULL(slices);
+    ASSERT_NONNULL(separator);
+
+    usize length = slices->count > 0 ? separator->length * (slices->count - 1) : 0;
+
+    for (usize i = 0; i < slices->count; i++) {
+        length += slices->slices[i].length;
+    }
+
+    String* string = string_new_sized(length);
+    c8* cursor = string_buffer(string);
+
+    for (usize i = 0; i < slices->count; i++) {
+        if (i > 0) {
+            memcpy(cursor, separator->buffer, separator->length);
+            cursor += separator->length;
+        }
+        memcpy(cursor, slices->slices[i].buffer, slices->slices[i].length);
+        cursor += slices->slices[i].length;
+    }
+
+    return string;
+}
+
+String* str_concat(usize count, ...) {
+    va_list arguments;
+    va_list measured;
+    usize length = 0;
+
+    va_start(arguments, count);
+    va_copy(measured, arguments);
+
+    for (usize i = 0; i < count; i++) {
+        const StrSlice* piece = va_arg(measured, const StrSlice*);
+        ASSERT_NONNULL(piece);
+        length += piece->length;
+    }
+    va_end(measured);
+
+    String* string = string_new_sized(length);
+    c8* cursor = string_buffer(string);
+
+    for (usize i = 0; i < count; i++) {
+        const StrSlice* piece = va_arg(arguments, const StrSlice*);
+        memcpy(cursor, piece->buffer, piece->length);
+        cursor += piece->length;
+    }
+    va_end(arguments);
+
+    return string;
+}
+
+// MARK: Builder
+
+void string_builder_init(StringBuilder* builder) {
+    ASSERT_NONNULL(builder);
+
+    builder->pieces = builder->inline_pieces;
+    builder->count = 0;
+    builder->capacity = STRING_BUILDER_INLINE_PIECES;
+    builder->length = 0;
+}
+
+void string_builder_push(StringBuilder* builder, const StrSlice* piece) {
+    ASSERT_NONNULL(builder);
+    ASSERT_NONNULL(piece);
+
+    if (builder->count == builder->capacity) {
+        usize capacity = builder->capacity * 2;
+
+        if (builder->pieces == builder->inline_pieces) {
+            builder->pieces = heap_many(sizeof(StrSlice), capacity);
+            memcpy(builder->pieces, builder->inline_pieces, sizeof(builder->inline_pieces));
+        } else {
+            builder->pieces = heap_renew(builder->pieces, sizeof(StrSlice), capacity);
+        }
+        builder->capacity = capacity;
+    }
+
+    builder->pieces[builder->count++] = *piece;
+    builder->length += piece->length;
+}
+
+String* string_builder_build(StringBuilder* builder) {
+    ASSERT_NONNULL(builder);
+
+    String* string = string_new_sized(builder->length);
+    builder_copy(builder, string_buffer(string));
+    string_builder_clear(builder);
+
+    return string;
+}
+
+CString* string_builder_build_cstring(StringBuilder* builder) {
+    ASSERT_NONNULL(builder);
+
+    CString* cstring = heap_one(sizeof(CString));
+    cstring->length = builder->length;
+    cstring->buffer = heap_many(sizeof(c8), builder->length + 1);
+    builder_copy(builder, cstring->buffer);
+    cstring->buffer[builder->length] = '\0';
+    string_builder_clear(builder);
+
+    return cstring;
+}
+
+void string_builder_build_into(StringBuilder* builder, StringMut* string_mut) {
+    ASSERT_NONNULL(builder);
+    ASSERT_NONNULL(string_mut);
+
+    string_mut_reserve(string_mut, builder->length);
+    usize length = string_mut_length(string_mut);
+    builder_copy(builder, string_mut_buffer(string_mut) + length);
+    string_mut_set_length(string_mut, length + builder->length);
+    string_builder_clear(builder);
+}
+
+void string_builder_clear(StringBuilder* builder) {
+    ASSERT_NONNULL(builder);
+
+    if (builder->pieces != builder->inline_pieces) {
+        free(builder->pieces);
+    }
+
+    string_builder_init(builder);
+}
@@ -0,0 +1,87 @@
+#ifndef CTK_BUILDER_H
+#define CTK_BUILDER_H
+
+#include "../string/string.h"
+
+/**
+ * @brief number of pieces a StringBuilder tracks inside of its own struct before spilling to the heap
+ */
+#define STRING_BUILDER_INLINE_PIECES 16
+
+// MARK: Definition
+
+/**
+ * @brief Stack allocated list of pieces that is measured first and then copied into its final string in one go
+ * @note pieces are referenced, not copied, so everything pushed must outlive the build
+ * @note because pieces may point into the struct itself, a StringBuilder must not be copied by value once pushed to
+ */
+typedef struct {
+    StrSlice* pieces;
+    usize count;
+    usize capacity;
+    usize length;
+    StrSlice inline_pieces[STRING_BUILDER_INLINE_PIECES];
+} StringBuilder;
+
+// MARK: Joining
+
+/**
+ * @return heap allocated string of the given slices with separator between each of them
+ * @note the exact length is summed up first, so the result is allocated once and every byte is copied once
+ */
+String* str_join(const StrSlices* slices, const StrSlice* separator)
+    __attribute__((warn_unused_result))
+    __attribute__((nonnull(1, 2)));
+
+/**
+ * @return heap allocated string of the count given const StrSlice* arguments, one after another
+ * @note e.g. str_concat(3, scheme, str_static("://"), host), which allocates once
+ */
+String* str_concat(usize count, ...) __attribute__((warn_unused_result));
+
+// MARK: Builder
+
+/**
+ * @brief prepares the given builder for use, no memory is allocated until more than STRING_BUILDER_INLINE_PIECES are pushed
+ */
+void string_builder_init(StringBuilder* builder) __attribute__((nonnull(1)));
+
+/**
+ * @brief records the given piece to be copied in at build time
+ */
+void string_builder_push(StringBuilder* builder, const StrSlice* piece) __attribute__((nonnull(1, 2)));
+
+/**
+ * @return total length of every piece pushed so far, which is exactly the length the build will have
+ */
+__attribute__((nonnull(1))) static inline usize string_builder_length(const StringBuilder* builder) {
+    return builder->length;
+}
+
+/**
+ * @return heap allocated string of every piece pushed, in order, allocated once at its exact length
+ * @note the builder is cleared afterwards and can be reused
+ */
+String* string_builder_build(StringBuilder* builder)
+    __attribute__((warn_unused_result))
+    __attribute__((nonnull(1)));
+
+/**
+ * @return heap allocated cstring of every piece pushed, in order, allocated once at its exact length
+ * @note the builder is cleared afterwards and can be reused
+ */
+CString* string_builder_build_cstring(StringBuilder* builder)
+    __attribute__((warn_unused_result))
+    __attribute__((nonnull(1)));
+
+/**
+ * @brief pushes every piece onto the end of the mutable string with a single reserve, then clears the builder
+ */
+void string_builder_build_into(StringBuilder* builder, StringMut* string_mut) __attribute__((nonnull(1, 2)));
+
+/**
+ * @brief forgets every piece pushed so far and releases any memory the builder allocated
+ */
+void string_builder_clear(StringBuilder* builder) __attribute__((nonnull(1)));
+
+#endif
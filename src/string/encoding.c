@@ -0,0 +1,513 @@
+#include "encoding.h"
+#include <assert.h>
+#include <string.h>
+#include "../core/memory.h"
+#include "../core/simd.h"
+
+// MARK: Internal
+
+static const c8 HEX_DIGITS[16] = "0123456789abcdef";
+
+static const c8 BASE64_STANDARD_DIGITS[64] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static const c8 BASE64_URL_DIGITS[64] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+static const i8 BASE64_DECODE_STANDARD[256] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1, -1, 63,
+    52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,
+    -1, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14,
+    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1,
+    -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+    41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+};
+
+static const i8 BASE64_DECODE_URL[256] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1,
+    52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,
+    -1, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14,
+    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, 63,
+    -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+    41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+};
+
+static inline i32 hex_value(u8 byte) {
+    if ((u8) (byte - '0') < 10) {
+        return byte - '0';
+    }
+    if ((u8) ((byte | 0x20) - 'a') < 6) {
+        return (byte | 0x20) - 'a' + 10;
+    }
+
+    return -1;
+}
+
+static void hex_encode_scalar(const u8* bytes, usize start, usize length, c8* out) {
+    for (usize i = start; i < length; i++) {
+        out[i * 2] = HEX_DIGITS[bytes[i] >> 4];
+        out[i * 2 + 1] = HEX_DIGITS[bytes[i] & 0x0F];
+    }
+}
+
+/**
+ * @return the index of the first byte that is not a hex digit, or length once every pair from start on is decoded
+ */
+static usize hex_decode_scalar(const u8* hex, usize start, usize length, u8* out) {
+    for (usize i = start; i + 1 < length; i += 2) {
+        i32 high = hex_value(hex[i]);
+        i32 low = hex_value(hex[i + 1]);
+
+        if ((high | low) < 0) {
+            return high < 0 ? i : i + 1;
+        }
+        out[i / 2] = (u8) ((high << 4) | low);
+    }
+
+    return length;
+}
+
+static void base64_encode_scalar(const u8* bytes, usize start, usize length, const c8* digits, bool pad, c8* out) {
+    usize i = start;
+    c8* cursor = out + start / 3 * 4;
+
+    for (; i + 3 <= length; i += 3) {
+        u32 group = ((u32) bytes[i] << 16) | ((u32) bytes[i + 1] << 8) | bytes[i + 2];
+        cursor[0] = digits[group >> 18];
+        cursor[1] = digits[(group >> 12) & 0x3F];
+        cursor[2] = digits[(group >> 6) & 0x3F];
+        cursor[3] = digits[group & 0x3F];
+        cursor += 4;
+    }
+
+    if (i == length) {
+        return;
+    }
+
+    // one or two bytes left over make two or three digits, padded out to four for the standard alphabet
+    u32 group = (u32) bytes[i] << 16;
+    if (i + 1 < length) {
+        group |= (u32) bytes[i + 1] << 8;
+    }
+
+    *cursor++ = digits[group >> 18];
+    *cursor++ = digits[(group >> 12) & 0x3F];
+    if (i + 1 < length) {
+        *cursor++ = digits[(group >> 6) & 0x3F];
+    } else if (pad) {
+        *cursor++ = '=';
+    }
+    if (pad) {
+        *cursor = '=';
+    }
+}
+
+/**
+ * @return the index of the first byte that is not a base64 digit, or length once every group from start on is decoded
+ * @note start must be a multiple of 4, and a trailing lone digit is left for the caller to reject
+ */
+static usize base64_decode_scalar(const u8* base64, usize start, usize length, const i8* table, u8* out) {
+    usize i = start;
+    u8* cursor = out + start / 4 * 3;
+
+    for (; i + 4 <= length; i += 4) {
+        i32 a = table[base64[i]];
+        i32 b = table[base64[i + 1]];
+        i32 c = table[base64[i + 2]];
+        i32 d = table[base64[i + 3]];
+
+        if ((a | b | c | d) < 0) {
+            return a < 0 ? i : b < 0 ? i + 1 : c < 0 ? i + 2 : i + 3;
+        }
+
+        u32 group = ((u32) a << 18) | ((u32) b << 12) | ((u32) c << 6) | (u32) d;
+        cursor[0] = (u8) (group >> 16);
+        cursor[1] = (u8) (group >> 8);
+        cursor[2] = (u8) group;
+        cursor += 3;
+    }
+
+    for (usize j = i; j < length; j++) {
+        if (table[base64[j]] < 0) {
+            return j;
+        }
+    }
+
+    if (length - i >= 2) {
+        u32 group = ((u32) table[base64[i]] << 18) | ((u32) table[base64[i + 1]] << 12);
+        if (length - i == 3) {
+            group |= (u32) table[base64[i + 2]] << 6;
+            cursor[1] = (u8) (group >> 8);
+        }
+        cursor[0] = (u8) (group >> 16);
+    }
+
+    return length;
+}
+
+static inline usize base64_decoded_length(usize length) {
+    return length / 4 * 3 + (length % 4 == 0 ? 0 : length % 4 - 1);
+}
+
+#ifdef _SIMD_SSE2
+/**
+ * @return ascii hex digits for the nibbles, each below 16, of the given vector
+ */
+static inline __m128i hex_digits_sse2(__m128i nibbles) {
+    __m128i letters = _mm_and_si128(_mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9)), _mm_set1_epi8('a' - '0' - 10));
+    return _mm_add_epi8(_mm_add_epi8(nibbles, _mm_set1_epi8('0')), letters);
+}
+
+/**
+ * @return the nibble values of 16 hex digits, clearing lanes of valid to zero where a byte is not a hex digit
+ */
+static inline __m128i hex_nibbles_sse2(__m128i chars, __m128i* valid) {
+    __m128i zero = _mm_setzero_si128();
+    __m128i digit = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+    __m128i letter = _mm_sub_epi8(_mm_or_si128(chars, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    __m128i is_digit = _mm_cmpeq_epi8(_mm_subs_epu8(digit, _mm_set1_epi8(9)), zero);
+    __m128i is_letter = _mm_cmpeq_epi8(_mm_subs_epu8(letter, _mm_set1_epi8(5)), zero);
+
+    *valid = _mm_and_si128(*valid, _mm_or_si128(is_digit, is_letter));
+    return _mm_or_si128(_mm_and_si128(is_digit, digit),
+                        _mm_and_si128(is_letter, _mm_add_epi8(letter, _mm_set1_epi8(10))));
+}
+
+/**
+ * @return the bytes made from pairs of nibbles, high first, in the low byte of each 16-bit lane
+ */
+static inline __m128i hex_pairs_sse2(__m128i nibbles) {
+    __m128i joined = _mm_or_si128(_mm_slli_epi16(nibbles, 4), _mm_srli_epi16(nibbles, 8));
+    return _mm_and_si128(joined, _mm_set1_epi16(0xFF));
+}
+
+static usize hex_encode_sse2(const u8* bytes, usize length, c8* out) {
+    usize i = 0;
+
+    for (; i + 16 <= length; i += 16) {
+        __m128i input = _mm_loadu_si128((const __m128i*) (bytes + i));
+        __m128i high = hex_digits_sse2(_mm_and_si128(_mm_srli_epi16(input, 4), _mm_set1_epi8(0x0F)));
+        __m128i low = hex_digits_sse2(_mm_and_si128(input, _mm_set1_epi8(0x0F)));
+
+        _mm_storeu_si128((__m128i*) (out + i * 2), _mm_unpacklo_epi8(high, low));
+        _mm_storeu_si128((__m128i*) (out + i * 2 + 16), _mm_unpackhi_epi8(high, low));
+    }
+
+    return i;
+}
+
+/**
+ * @return the number of hex digits decoded, which stops short at the first block holding a byte that is not one
+ */
+static usize hex_decode_sse2(const u8* hex, usize length, u8* out) {
+    usize i = 0;
+
+    for (; i + 32 <= length; i += 32) {
+        __m128i valid = _mm_set1_epi8(-1);
+        __m128i first = hex_nibbles_sse2(_mm_loadu_si128((const __m128i*) (hex + i)), &valid);
+        __m128i second = hex_nibbles_sse2(_mm_loadu_si128((const __m128i*) (hex + i + 16)), &valid);
+
+        if (_mm_movemask_epi8(valid) != 0xFFFF) {
+            break;
+        }
+
+        _mm_storeu_si128((__m128i*) (out + i / 2), _mm_packus_epi16(hex_pairs_sse2(first), hex_pairs_sse2(second)));
+    }
+
+    return i;
+}
+#endif
+
+#ifdef _SIMD_X86
+_SIMD_TARGET_AVX2 static inline __m256i hex_digits_avx2(__m256i nibbles) {
+    __m256i letters = _mm256_and_si256(_mm256_cmpgt_epi8(nibbles, _mm256_set1_epi8(9)), _mm256_set1_epi8('a' - '0' - 10));
+    return _mm256_add_epi8(_mm256_add_epi8(nibbles, _mm256_set1_epi8('0')), letters);
+}
+
+_SIMD_TARGET_AVX2 static inline __m256i hex_nibbles_avx2(__m256i chars, __m256i* valid) {
+    __m256i zero = _mm256_setzero_si256();
+    __m256i digit = _mm256_sub_epi8(chars, _mm256_set1_epi8('0'));
+    __m256i letter = _mm256_sub_epi8(_mm256_or_si256(chars, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+    __m256i is_digit = _mm256_cmpeq_epi8(_mm256_subs_epu8(digit, _mm256_set1_epi8(9)), zero);
+    __m256i is_letter = _mm256_cmpeq_epi8(_mm256_subs_epu8(letter, _mm256_set1_epi8(5)), zero);
+
+    *valid = _mm256_and_si256(*valid, _mm256_or_si256(is_digit, is_letter));
+    return _mm256_or_si256(_mm256_and_si256(is_digit, digit),
+                           _mm256_and_si256(is_letter, _mm256_add_epi8(letter, _mm256_set1_epi8(10))));
+}
+
+_SIMD_TARGET_AVX2 static inline __m256i hex_pairs_avx2(__m256i nibbles) {
+    __m256i joined = _mm256_or_si256(_mm256_slli_epi16(nibbles, 4), _mm256_srli_epi16(nibbles, 8));
+    return _mm256_and_si256(joined, _mm256_set1_epi16(0xFF));
+}
+
+_SIMD_TARGET_AVX2 static usize hex_encode_avx2(const u8* bytes, usize length, c8* out) {
+    usize i = 0;
+
+    for (; i + 32 <= length; i += 32) {
+        __m256i input = _mm256_loadu_si256((const __m256i*) (bytes + i));
+        __m256i high = hex_digits_avx2(_mm256_and_si256(_mm256_srli_epi16(input, 4), _mm256_set1_epi8(0x0F)));
+        __m256i low = hex_digits_avx2(_mm256_and_si256(input, _mm256_set1_epi8(0x0F)));
+
+        // unpacking interleaves within each 128-bit lane, so the lanes are put back in order on the way out
+        __m256i first = _mm256_unpacklo_epi8(high, low);
+        __m256i second = _mm256_unpackhi_epi8(high, low);
+        _mm256_storeu_si256((__m256i*) (out + i * 2), _mm256_permute2x128_si256(first, second, 0x20));
+        _mm256_storeu_si256((__m256i*) (out + i * 2 + 32), _mm256_permute2x128_si256(first, second, 0x31));
+    }
+
+    return i;
+}
+
+_SIMD_TARGET_AVX2 static usize hex_decode_avx2(const u8* hex, usize length, u8* out) {
+    usize i = 0;
+
+    for (; i + 64 <= length; i += 64) {
+        __m256i valid = _mm256_set1_epi8(-1);
+        __m256i first = hex_nibbles_avx2(_mm256_loadu_si256((const __m256i*) (hex + i)), &valid);
+        __m256i second = hex_nibbles_avx2(_mm256_loadu_si256((const __m256i*) (hex + i + 32)), &valid);
+
+        if ((u32) _mm256_movemask_epi8(valid) != 0xFFFFFFFF) {
+            break;
+        }
+
+        __m256i packed = _mm256_packus_epi16(hex_pairs_avx2(first), hex_pairs_avx2(second));
+        _mm256_storeu_si256((__m256i*) (out + i / 2), _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0)));
+    }
+
+    return i;
+}
+
+/**
+ * @return the number of bytes encoded, a multiple of 24, always leaving at least 4 so the 16 byte loads stay in bounds
+ * @note each lane gathers 12 bytes into 16 bit pairs, the four 6-bit fields are then split out with two multiplies
+ *       and mapped to ascii with one range lookup, per Muła and Lemire
+ */
+_SIMD_TARGET_AVX2 static usize base64_encode_avx2(const u8* bytes, usize length, Base64Alphabet alphabet, c8* out) {
+    const __m256i gather = _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+                                            1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+    const c8 symbol_62 = alphabet == BASE64_URL ? '-' : '+';
+    const c8 symbol_63 = alphabet == BASE64_URL ? '_' : '/';
+    // offset to add to a 6-bit value, picked by the range it falls in
+    const __m256i offsets = _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                             '0' - 52, '0' - 52, '0' - 52, '0' - 52, symbol_62 - 62, symbol_63 - 63, 'A',
+                                             0, 0, 'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                             '0' - 52, '0' - 52, '0' - 52, '0' - 52, symbol_62 - 62, symbol_63 - 63, 'A',
+                                             0, 0);
+    usize i = 0;
+
+    for (; i + 28 <= length; i += 24) {
+        __m128i low = _mm_loadu_si128((const __m128i*) (bytes + i));
+        __m128i high = _mm_loadu_si128((const __m128i*) (bytes + i + 12));
+        __m256i input = _mm256_shuffle_epi8(_mm256_set_m128i(high, low), gather);
+
+        __m256i fields_ac = _mm256_mulhi_epu16(_mm256_and_si256(input, _mm256_set1_epi32(0x0FC0FC00)),
+                                               _mm256_set1_epi32(0x04000040));
+        __m256i fields_bd = _mm256_mullo_epi16(_mm256_and_si256(input, _mm256_set1_epi32(0x003F03F0)),
+                                               _mm256_set1_epi32(0x01000010));
+        __m256i values = _mm256_or_si256(fields_ac, fields_bd);
+
+        // 0..25 -> 13, 26..51 -> 0, 52..61 -> 1..10, 62 -> 11, 63 -> 12
+        __m256i range = _mm256_subs_epu8(values, _mm256_set1_epi8(51));
+        __m256i upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), values);
+        range = _mm256_or_si256(range, _mm256_and_si256(upper, _mm256_set1_epi8(13)));
+
+        __m256i digits = _mm256_add_epi8(values, _mm256_shuffle_epi8(offsets, range));
+        _mm256_storeu_si256((__m256i*) (out + i / 3 * 4), digits);
+    }
+
+    return i;
+}
+
+/**
+ * @return the number of digits decoded, a multiple of 32, which stops short at the first block holding an invalid one
+ * @note digits are classified by a lookup on each nibble, a byte is valid when the two lookups share no bit
+ */
+_SIMD_TARGET_AVX2 static usize base64_decode_avx2(const u8* base64, usize length, Base64Alphabet alphabet, u8* out) {
+    bool url = alphabet == BASE64_URL;
+    // bit per high nibble, 0x10 for the nibbles with no digits at all, 0x20 to tell 0x7_ from 0x5_ apart
+    const __m256i high_classes = _mm256_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, url ? 0x20 : 0x08,
+                                                  0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+                                                  0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, url ? 0x20 : 0x08,
+                                                  0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    // the high nibble classes each low nibble does not form a digit with
+    const __m256i low_classes = url ? _mm256_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                                       0x11, 0x11, 0x13, 0x3B, 0x3B, 0x3A, 0x3B, 0x33,
+                                                       0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                                       0x11, 0x11, 0x13, 0x3B, 0x3B, 0x3A, 0x3B, 0x33)
+                                    : _mm256_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                                       0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+                                                       0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                                       0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    // offset from ascii to value by high nibble, the one symbol sharing a nibble with another range is patched after
+    const i8 symbol_offset = url ? '-' : '+';
+    const __m256i offsets = _mm256_setr_epi8(0, 0, 62 - symbol_offset, 52 - '0', -'A', -'A', 26 - 'a', 26 - 'a',
+                                             0, 0, 0, 0, 0, 0, 0, 0,
+                                             0, 0, 62 - symbol_offset, 52 - '0', -'A', -'A', 26 - 'a', 26 - 'a',
+                                             0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i symbol_63 = _mm256_set1_epi8(url ? '_' : '/');
+    const __m256i symbol_63_offset = _mm256_set1_epi8(url ? 63 - '_' : 63 - '/');
+    const __m256i nibble_mask = _mm256_set1_epi8(0x2F);
+    usize i = 0;
+
+    for (; i + 32 <= length; i += 32) {
+        __m256i input = _mm256_loadu_si256((const __m256i*) (base64 + i));
+        __m256i high_nibbles = _mm256_and_si256(_mm256_srli_epi32(input, 4), nibble_mask);
+        __m256i high = _mm256_shuffle_epi8(high_classes, high_nibbles);
+        __m256i low = _mm256_shuffle_epi8(low_classes, _mm256_and_si256(input, nibble_mask));
+
+        if (!_mm256_testz_si256(low, high)) {
+            break;
+        }
+
+        __m256i offset = _mm256_shuffle_epi8(offsets, high_nibbles);
+        offset = _mm256_blendv_epi8(offset, symbol_63_offset, _mm256_cmpeq_epi8(input, symbol_63));
+        __m256i values = _mm256_add_epi8(input, offset);
+
+        // four 6-bit values to 24 bits per 32-bit lane, then the three bytes of each lane packed together
+        __m256i pairs = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+        __m256i groups = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+        groups = _mm256_shuffle_epi8(groups, _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                                              2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+        groups = _mm256_permutevar8x32_epi32(groups, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+
+        // exactly 24 bytes are stored so the output needs no slack past its exact size
+        _mm_storeu_si128((__m128i*) (out + i / 4 * 3), _mm256_castsi256_si128(groups));
+        _mm_storel_epi64((__m128i*) (out + i / 4 * 3 + 16), _mm256_extracti128_si256(groups, 1));
+    }
+
+    return i;
+}
+#endif
+
+// MARK: Hex
+
+void str_hex_encode(const StrSlice* bytes, StringMut* out) {
+    ASSERT_NONNULL(bytes);
+    ASSERT_NONNULL(out);
+
+    string_mut_reserve(out, hex_encoded_length(bytes->length));
+
+    const u8* input = (const u8*) bytes->buffer;
+    c8* output = string_mut_buffer(out) + string_mut_length(out);
+    usize start = 0;
+
+#ifdef _SIMD_X86
+    if (simd_has_avx2()) {
+        start = hex_encode_avx2(input, bytes->length, output);
+    }
+#endif
+#ifdef _SIMD_SSE2
+    start += hex_encode_sse2(input + start, bytes->length - start, output + start * 2);
+#endif
+
+    hex_encode_scalar(input, start, bytes->length, output);
+    string_mut_set_length(out, string_mut_length(out) + hex_encoded_length(bytes->length));
+}
+
+OptionIndex str_hex_decode(const StrSlice* hex, StringMut* out) {
+    ASSERT_NONNULL(hex);
+    ASSERT_NONNULL(out);
+
+    string_mut_reserve(out, hex->length / 2);
+
+    const u8* input = (const u8*) hex->buffer;
+    u8* output = (u8*) string_mut_buffer(out) + string_mut_length(out);
+    usize start = 0;
+
+#ifdef _SIMD_X86
+    if (simd_has_avx2()) {
+        start = hex_decode_avx2(input, hex->length, output);
+    }
+#endif
+#ifdef _SIMD_SSE2
+    start += hex_decode_sse2(input + start, hex->length - start, output + start / 2);
+#endif
+
+    usize end = hex_decode_scalar(input, start, hex->length, output);
+
+    if (end < hex->length) {
+        return option_index(end);
+    }
+    if (hex->length % 2 != 0) {
+        return option_index(hex_value(input[hex->length - 1]) < 0 ? hex->length - 1 : hex->length);
+    }
+
+    string_mut_set_length(out, string_mut_length(out) + hex->length / 2);
+    return option_index_empty();
+}
+
+// MARK: Base64
+
+void str_base64_encode(const StrSlice* bytes, Base64Alphabet alphabet, StringMut* out) {
+    ASSERT_NONNULL(bytes);
+    ASSERT_NONNULL(out);
+
+    usize length = base64_encoded_length(bytes->length, alphabet);
+    string_mut_reserve(out, length);
+
+    const u8* input = (const u8*) bytes->buffer;
+    c8* output = string_mut_buffer(out) + string_mut_length(out);
+    const c8* digits = alphabet == BASE64_URL ? BASE64_URL_DIGITS : BASE64_STANDARD_DIGITS;
+    usize start = 0;
+
+#ifdef _SIMD_X86
+    if (simd_has_avx2()) {
+        start = base64_encode_avx2(input, bytes->length, alphabet, output);
+    }
+#endif
+
+    base64_encode_scalar(input, start, bytes->length, digits, alphabet == BASE64_STANDARD, output);
+    string_mut_set_length(out, string_mut_length(out) + length);
+}
+
+OptionIndex str_base64_decode(const StrSlice* base64, Base64Alphabet alphabet, StringMut* out) {
+    ASSERT_NONNULL(base64);
+    ASSERT_NONNULL(out);
+
+    const u8* input = (const u8*) base64->buffer;
+    usize length = base64->length;
+
+    // padding only ever closes a whole group of four, anywhere else an '=' is reported as invalid
+    if (length % 4 == 0 && length > 0 && input[length - 1] == '=') {
+        length -= 1 + (input[length - 2] == '=');
+    }
+
+    string_mut_reserve(out, base64_decoded_length(length));
+
+    u8* output = (u8*) string_mut_buffer(out) + string_mut_length(out);
+    const i8* table = alphabet == BASE64_URL ? BASE64_DECODE_URL : BASE64_DECODE_STANDARD;
+    usize start = 0;
+
+#ifdef _SIMD_X86
+    if (simd_has_avx2()) {
+        start = base64_decode_avx2(input, length, alphabet, output);
+    }
+#endif
+
+    usize end = base64_decode_scalar(input, start, length, table, output);
+
+    if (end < length || (end == length && length % 4 == 1)) {
+        return option_index(end < length ? end : base64->length);
+    }
+
+    string_mut_set_length(out, string_mut_length(out) + base64_decoded_length(length));
+    return option_index_empty();
+}
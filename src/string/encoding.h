@@ -0,0 +1,69 @@
+#ifndef CTK_ENCODING_H
+#define CTK_ENCODING_H
+
+#include "../string/string.h"
+
+// MARK: Definition
+
+/**
+ * @brief Alphabet used for base64, per RFC 4648
+ * @note BASE64_STANDARD uses '+' and '/' and pads its output with '=', BASE64_URL uses '-' and '_' and does not pad
+ */
+typedef enum {
+    BASE64_STANDARD,
+    BASE64_URL,
+} Base64Alphabet;
+
+// MARK: Hex
+
+/**
+ * @return the number of bytes hex encoding the given number of bytes produces
+ */
+static inline usize hex_encoded_length(usize length) {
+    return length * 2;
+}
+
+/**
+ * @brief pushes two lowercase hex digits for every byte of the given str onto the end of the mutable string
+ * @note room for the whole output is reserved once up front, and 16 or 32 bytes are converted per step with SSE2 or AVX2
+ */
+void str_hex_encode(const StrSlice* bytes, StringMut* out) __attribute__((nonnull(1, 2)));
+
+/**
+ * @brief pushes the bytes spelled by the given hex digits, in either case, onto the end of the mutable string
+ * @return the index of the first byte that is not a hex digit, or hex->length if the digits end halfway through a byte,
+ *         or an empty optional once everything was decoded
+ * @note on error nothing is pushed, the mutable string is left as it was
+ */
+OptionIndex str_hex_decode(const StrSlice* hex, StringMut* out) __attribute__((nonnull(1, 2)));
+
+// MARK: Base64
+
+/**
+ * @return the number of bytes base64 encoding the given number of bytes produces with the given alphabet
+ */
+static inline usize base64_encoded_length(usize length, Base64Alphabet alphabet) {
+    if (alphabet == BASE64_STANDARD) {
+        return (length + 2) / 3 * 4;
+    }
+
+    return length / 3 * 4 + (length % 3 == 0 ? 0 : length % 3 + 1);
+}
+
+/**
+ * @brief pushes the base64 encoding of the given str onto the end of the mutable string
+ * @note room for the whole output is reserved once up front, and with AVX2 24 bytes are encoded per step
+ */
+void str_base64_encode(const StrSlice* bytes, Base64Alphabet alphabet, StringMut* out) __attribute__((nonnull(1, 3)));
+
+/**
+ * @brief pushes the bytes encoded by the given base64 onto the end of the mutable string
+ * @return the index of the first byte that is not valid base64 of the given alphabet, or base64->length if the input
+ *         ends with a lone character that cannot make up a byte, or an empty optional once everything was decoded
+ * @note padding is optional for either alphabet, but must be correct when present, and no whitespace is skipped
+ * @note on error nothing is pushed, the mutable string is left as it was
+ */
+OptionIndex str_base64_decode(const StrSlice* base64, Base64Alphabet alphabet, StringMut* out)
+    __attribute__((nonnull(1, 3)));
+
+#endif
@@ -0,0 +1,208 @@
+#include "hash.h"
+#include <assert.h>
+#include <string.h>
+#include "../core/memory.h"
+
+// MARK: Internal
+
+static const u64 hash_secret[4] = {0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL, 0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL};
+
+static inline void hash_multiply(u64* low, u64* high) {
+    __uint128_t product = (__uint128_t) *low * *high;
+    *low = (u64) product;
+    *high = (u64) (product >> 64);
+}
+
+static inline u64 hash_mix(u64 one, u64 two) {
+    hash_multiply(&one, &two);
+    return one ^ two;
+}
+
+static inline u64 hash_read8(const u8* bytes) {
+    u64 value;
+    memcpy(&value, bytes, sizeof(u64));
+    return value;
+}
+
+static inline u64 hash_read4(const u8* bytes) {
+    u32 value;
+    memcpy(&value, bytes, sizeof(u32));
+    return value;
+}
+
+static inline u64 hash_seed(u64 seed) {
+    return seed ^ hash_mix(seed ^ hash_secret[0], hash_secret[1]);
+}
+
+/**
+ * @brief folds one 48 byte block into three independent lanes, which keeps the multipliers pipelined
+ */
+static inline void hash_block(u64* seed, u64 lanes[2], const u8* block) {
+    *seed = hash_mix(hash_read8(block) ^ hash_secret[1], hash_read8(block + 8) ^ *seed);
+    lanes[0] = hash_mix(hash_read8(block + 16) ^ hash_secret[2], hash_read8(block + 24) ^ lanes[0]);
+    lanes[1] = hash_mix(hash_read8(block + 32) ^ hash_secret[3], hash_read8(block + 40) ^ lanes[1]);
+}
+
+/**
+ * @brief reads the two final words from a message of at most 16 bytes
+ */
+static inline void hash_short(const u8* bytes, usize length, u64* a, u64* b) {
+    if (length >= 4) {
+        usize middle = (length >> 3) << 2;
+        *a = (hash_read4(bytes) << 32) | hash_read4(bytes + middle);
+        *b = (hash_read4(bytes + length - 4) << 32) | hash_read4(bytes + length - 4 - middle);
+    } else if (length > 0) {
+        *a = ((u64) bytes[0] << 16) | ((u64) bytes[length >> 1] << 8) | bytes[length - 1];
+        *b = 0;
+    } else {
+        *a = 0;
+        *b = 0;
+    }
+}
+
+/**
+ * @brief folds the remaining sub 48 byte tail of a long message, whose final 16 bytes are given in last
+ */
+static inline void hash_tail(u64* seed, const u8* bytes, usize remaining, const u8* last, u64* a, u64* b) {
+    while (remaining > 16) {
+        *seed = hash_mix(hash_read8(bytes) ^ hash_secret[1], hash_read8(bytes + 8) ^ *seed);
+        bytes += 16;
+        remaining -= 16;
+    }
+
+    *a = hash_read8(last);
+    *b = hash_read8(last + 8);
+}
+
+/**
+ * @brief runs the whole construction up to the final multiply, leaving 128 bits of state in a and b
+ */
+static void hash_state(const u8* bytes, usize length, u64 seed, u64* a, u64* b) {
+    seed = hash_seed(seed);
+
+    if (length <= 16) {
+        hash_short(bytes, length, a, b);
+    } else {
+        usize remaining = length;
+
+        if (remaining >= 48) {
+            u64 lanes[2] = {seed, seed};
+            do {
+                hash_block(&seed, lanes, bytes);
+                bytes += 48;
+                remaining -= 48;
+            } while (remaining >= 48);
+            seed ^= lanes[0] ^ lanes[1];
+        }
+
+        hash_tail(&seed, bytes, remaining, bytes + remaining - 16, a, b);
+    }
+
+    *a ^= hash_secret[1];
+    *b ^= seed;
+    hash_multiply(a, b);
+}
+
+// MARK: Query
+
+u64 str_hash64(const StrSlice* str, u64 seed) {
+    ASSERT_NONNULL(str);
+
+    u64 a;
+    u64 b;
+    hash_state((const u8*) str->buffer, str->length, seed, &a, &b);
+
+    return hash_mix(a ^ hash_secret[0] ^ str->length, b ^ hash_secret[1]);
+}
+
+Hash128 str_hash128(const StrSlice* str, u64 seed) {
+    ASSERT_NONNULL(str);
+
+    u64 a;
+    u64 b;
+    hash_state((const u8*) str->buffer, str->length, seed, &a, &b);
+
+    return (Hash128) {
+        hash_mix(a ^ hash_secret[2] ^ str->length, b ^ hash_secret[3]),
+        hash_mix(a ^ hash_secret[3], b ^ hash_secret[0] ^ str->length)};
+}
+
+// MARK: Streaming
+
+void str_hasher_init(StrHasher* hasher, u64 seed) {
+    ASSERT_NONNULL(hasher);
+
+    hasher->seed = hash_seed(seed);
+    hasher->lanes[0] = hasher->seed;
+    hasher->lanes[1] = hasher->seed;
+    hasher->length = 0;
+    hasher->buffered = 0;
+}
+
+void str_hasher_push(StrHasher* hasher, const StrSlice* str) {
+    ASSERT_NONNULL(hasher);
+    ASSERT_NONNULL(str);
+
+    const u8* bytes = (const u8*) str->buffer;
+    usize length = str->length;
+    hasher->length += length;
+
+    if (hasher->buffered + length < 48) {
+        memcpy(hasher->buffer + hasher->buffered, bytes, length);
+        hasher->buffered += length;
+        return;
+    }
+
+    // one-shot hashing consumes every whole 48 byte block greedily, so blocks can be folded as soon as they fill
+    usize fill = 48 - hasher->buffered;
+    memcpy(hasher->buffer + hasher->buffered, bytes, fill);
+    hash_block(&hasher->seed, hasher->lanes, hasher->buffer);
+    bytes += fill;
+    length -= fill;
+
+    const u8* last_block = hasher->buffer;
+    while (length >= 48) {
+        hash_block(&hasher->seed, hasher->lanes, bytes);
+        last_block = bytes;
+        bytes += 48;
+        length -= 48;
+    }
+
+    memcpy(hasher->last, last_block + 32, 16);
+    memcpy(hasher->buffer, bytes, length);
+    hasher->buffered = length;
+}
+
+u64 str_hasher_finish(const StrHasher* hasher) {
+    ASSERT_NONNULL(hasher);
+
+    u64 a;
+    u64 b;
+    u64 seed = hasher->seed;
+
+    if (hasher->length <= 16) {
+        hash_short(hasher->buffer, hasher->length, &a, &b);
+    } else {
+        u8 last[16];
+
+        if (hasher->length >= 48) {
+            seed ^= hasher->lanes[0] ^ hasher->lanes[1];
+        }
+
+        if (hasher->buffered >= 16) {
+            memcpy(last, hasher->buffer + hasher->buffered - 16, 16);
+        } else {
+            // the final 16 bytes straddle the last folded block and the buffer
+            memcpy(last, hasher->last + hasher->buffered, 16 - hasher->buffered);
+            memcpy(last + 16 - hasher->buffered, hasher->buffer, hasher->buffered);
+        }
+
+        hash_tail(&seed, hasher->buffer, hasher->buffered, last, &a, &b);
+    }
+
+    a ^= hash_secret[1];
+    b ^= seed;
+    hash_multiply(&a, &b);
+
+    return hash_mix(a ^ hash_secret[0] ^ hasher->length, b ^ hash_secret[1]);
+}
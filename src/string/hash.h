@@ -0,0 +1,83 @@
+#ifndef CTK_HASH_H
+#define CTK_HASH_H
+
+#include "../string/string.h"
+
+// MARK: Definition
+
+/**
+ * @brief 128-bit hash result
+ */
+typedef struct {
+    u64 low;
+    u64 high;
+} Hash128;
+
+/**
+ * @brief Incremental hasher producing the same value as str_hash64() over the concatenation of every pushed str
+ * @note stack allocated, initialize with str_hasher_init() and never needs to be freed
+ */
+typedef struct {
+    u64 seed;
+    u64 lanes[2];
+    usize length;
+    usize buffered;
+    u8 buffer[48];
+    u8 last[16];
+} StrHasher;
+
+/**
+ * @brief Slice paired with its precomputed hash, so repeated lookups skip rehashing and
+ *        comparisons of different strings usually stop at the hash
+ * @note references the original string, so its lifetime is equal to the lifetime of the original
+ */
+typedef struct {
+    StrSlice str;
+    u64 hash;
+} HashedStr;
+
+// MARK: Query
+
+/**
+ * @return 64-bit non-cryptographic hash of the given str (wyhash construction)
+ * @note stable across runs and platforms for the same seed, but not resistant to hash flooding with a known seed
+ */
+u64 str_hash64(const StrSlice* str, u64 seed) __attribute__((nonnull(1)));
+
+/**
+ * @return 128-bit non-cryptographic hash of the given str, whose low half does not equal str_hash64()
+ */
+Hash128 str_hash128(const StrSlice* str, u64 seed) __attribute__((nonnull(1)));
+
+/**
+ * @return a HashedStr referencing the given str, hashed with seed 0
+ */
+__attribute__((nonnull(1))) static inline HashedStr hashed_str_init(const StrSlice* str) {
+    return (HashedStr) {*str, str_hash64(str, 0)};
+}
+
+/**
+ * @return true if both strs hold the same bytes, comparing the cached hashes first
+ */
+__attribute__((nonnull(1, 2))) static inline bool hashed_str_equals(const HashedStr* one, const HashedStr* two) {
+    return one->hash == two->hash && str_equals(&one->str, &two->str);
+}
+
+// MARK: Streaming
+
+/**
+ * @brief initializes a stack allocated hasher with the given seed
+ */
+void str_hasher_init(StrHasher* hasher, u64 seed) __attribute__((nonnull(1)));
+
+/**
+ * @brief feeds the given str into the hasher
+ */
+void str_hasher_push(StrHasher* hasher, const StrSlice* str) __attribute__((nonnull(1, 2)));
+
+/**
+ * @return hash of everything pushed so far, leaving the hasher usable for further pushes
+ */
+u64 str_hasher_finish(const StrHasher* hasher) __attribute__((nonnull(1)));
+
+#endif
@@ -0,0 +1,198 @@
+#include "interner.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../core/memory.h"
+#include "hash.h"
+
+#define _INTERNER_CHUNK_MIN (1 << 12)
+#define _INTERNER_CHUNK_MAX (1 << 20)
+#define _INTERNER_EMPTY     UINT32_MAX
+
+// MARK: Internal
+
+/**
+ * @return the table slot holding the given str, or the empty slot where it would be inserted
+ */
+static usize interner_slot(const StrInterner* interner, const StrSlice* str, u64 hash) {
+    usize mask = interner->table_capacity - 1;
+    usize slot = hash & mask;
+
+    while (interner->table[slot] != _INTERNER_EMPTY) {
+        u32 symbol = interner->table[slot];
+        if (interner->hashes[symbol] == hash && str_equals(&interner->strings[symbol], str)) {
+            return slot;
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    return slot;
+}
+
+/**
+ * @brief grows the table so it holds at least the given number of symbols at half load
+ */
+static void interner_reserve(StrInterner* interner, usize count) {
+    if (count * 2 <= interner->table_capacity) {
+        return;
+    }
+
+    usize capacity = interner->table_capacity;
+    while (count * 2 > capacity) {
+        capacity *= 2;
+    }
+
+    free(interner->table);
+    interner->table = heap_many(sizeof(u32), capacity);
+    interner->table_capacity = capacity;
+    memset(interner->table, 0xFF, sizeof(u32) * capacity);
+
+    // stored hashes make rehashing a pure table walk, the strings themselves are never touched
+    for (usize symbol = 0; symbol < interner->count; symbol++) {
+        usize slot = interner->hashes[symbol] & (capacity - 1);
+        while (interner->table[slot] != _INTERNER_EMPTY) {
+            slot = (slot + 1) & (capacity - 1);
+        }
+        interner->table[slot] = (u32) symbol;
+    }
+}
+
+/**
+ * @return a stable copy of the given bytes inside the arena
+ */
+static c8* interner_store(StrInterner* interner, const StrSlice* str) {
+    if (str->length <= interner->chunk_size - interner->chunk_used) {
+        c8* stored = interner->chunks[interner->chunk_count - 1] + interner->chunk_used;
+        memcpy(stored, str->buffer, str->length);
+        interner->chunk_used += str->length;
+        return stored;
+    }
+
+    if (interner->chunk_count >= interner->chunk_capacity) {
+        interner->chunk_capacity *= 2;
+        interner->chunks = heap_renew(interner->chunks, sizeof(c8*), interner->chunk_capacity);
+    }
+
+    if (str->length > _INTERNER_CHUNK_MAX / 2) {
+        // oversized strings get a dedicated chunk slotted in behind the current one, which keeps filling
+        c8* stored = heap_many(sizeof(c8), str->length);
+        memcpy(stored, str->buffer, str->length);
+        interner->chunks[interner->chunk_count] = interner->chunks[interner->chunk_count - 1];
+        interner->chunks[interner->chunk_count - 1] = stored;
+        interner->chunk_count++;
+        return stored;
+    }
+
+    usize size = interner->chunk_size;
+    while (size < _INTERNER_CHUNK_MAX && (size < interner->chunk_size * 2 || size < str->length)) {
+        size *= 2;
+    }
+    interner->chunks[interner->chunk_count++] = heap_many(sizeof(c8), size);
+    interner->chunk_size = size;
+    interner->chunk_used = 0;
+
+    return interner_store(interner, str);
+}
+
+// MARK: Lifecycle
+
+StrInterner* str_interner_new() {
+    StrInterner* interner = heap_one(sizeof(StrInterner));
+
+    interner->chunk_capacity = 4;
+    interner->chunks = heap_many(sizeof(c8*), interner->chunk_capacity);
+    interner->chunks[0] = heap_many(sizeof(c8), _INTERNER_CHUNK_MIN);
+    interner->chunk_count = 1;
+    interner->chunk_used = 0;
+    interner->chunk_size = _INTERNER_CHUNK_MIN;
+
+    interner->capacity = 16;
+    interner->strings = heap_many(sizeof(StrSlice), interner->capacity);
+    interner->hashes = heap_many(sizeof(u64), interner->capacity);
+    interner->count = 0;
+
+    interner->table_capacity = 32;
+    interner->table = heap_many(sizeof(u32), interner->table_capacity);
+    memset(interner->table, 0xFF, sizeof(u32) * interner->table_capacity);
+
+    return interner;
+}
+
+void str_interner_free(StrInterner** interner) {
+    ASSERT_NONNULL(interner);
+    ASSERT_NONNULL(*interner);
+
+    for (usize i = 0; i < (*interner)->chunk_count; i++) {
+        free((*interner)->chunks[i]);
+    }
+
+    free((*interner)->chunks);
+    free((*interner)->strings);
+    free((*interner)->hashes);
+    free((*interner)->table);
+    free(*interner);
+    *interner = NULL;
+}
+
+// MARK: Query
+
+OptionSymbol str_interner_lookup(const StrInterner* interner, const StrSlice* str) {
+    ASSERT_NONNULL(interner);
+    ASSERT_NONNULL(str);
+
+    u32 symbol = interner->table[interner_slot(interner, str, str_hash64(str, 0))];
+
+    if (symbol == _INTERNER_EMPTY) {
+        return option_symbol_empty();
+    }
+
+    return option_symbol(symbol);
+}
+
+StrSlice str_interner_resolve(const StrInterner* interner, StrSymbol symbol) {
+    ASSERT_NONNULL(interner);
+    assert(symbol < interner->count);
+
+    return interner->strings[symbol];
+}
+
+// MARK: Mutation
+
+StrSymbol str_interner_intern(StrInterner* interner, const StrSlice* str) {
+    ASSERT_NONNULL(interner);
+    ASSERT_NONNULL(str);
+    assert(interner->count < _INTERNER_EMPTY);
+
+    u64 hash = str_hash64(str, 0);
+    interner_reserve(interner, interner->count + 1);
+    usize slot = interner_slot(interner, str, hash);
+
+    if (interner->table[slot] != _INTERNER_EMPTY) {
+        return interner->table[slot];
+    }
+
+    if (interner->count >= interner->capacity) {
+        interner->capacity *= 2;
+        interner->strings = heap_renew(interner->strings, sizeof(StrSlice), interner->capacity);
+        interner->hashes = heap_renew(interner->hashes, sizeof(u64), interner->capacity);
+    }
+
+    StrSymbol symbol = (StrSymbol) interner->count++;
+    interner->strings[symbol] = (StrSlice) {interner_store(interner, str), str->length};
+    interner->hashes[symbol] = hash;
+    interner->table[slot] = symbol;
+
+    return symbol;
+}
+
+void str_interner_intern_all(StrInterner* interner, const StrSlice* strs, usize count, StrSymbol* symbols) {
+    ASSERT_NONNULL(interner);
+    ASSERT_NONNULL(strs);
+    ASSERT_NONNULL(symbols);
+
+    interner_reserve(interner, interner->count + count);
+
+    for (usize i = 0; i < count; i++) {
+        symbols[i] = str_interner_intern(interner, &strs[i]);
+    }
+}
@@ -0,0 +1,80 @@
+#ifndef CTK_INTERNER_H
+#define CTK_INTERNER_H
+
+#include "../string/string.h"
+
+// MARK: Definition
+
+/**
+ * @brief Handle to a string held by a StrInterner, equal symbols from the same interner always hold equal strings
+ */
+typedef u32 StrSymbol;
+
+DEFINE_OPTION(StrSymbol, Symbol, symbol, 0)
+
+/**
+ * @brief Deduplicating string table handing out dense u32 symbols, numbered from 0 in insertion order
+ * @note interned bytes are copied into chunks that never move, so resolved slices stay valid until the interner is freed
+ * @note symbols only compare meaningfully against symbols from the same interner
+ */
+typedef struct {
+    c8** chunks;
+    usize chunk_count;
+    usize chunk_capacity;
+    usize chunk_used;
+    usize chunk_size;
+    StrSlice* strings;
+    u64* hashes;
+    usize count;
+    usize capacity;
+    u32* table;
+    usize table_capacity;
+} StrInterner;
+
+// MARK: Lifecycle
+
+/**
+ * @return heap allocated, empty interner
+ * @note must be freed
+ */
+StrInterner* str_interner_new() __attribute__((warn_unused_result));
+
+/**
+ * @brief deep free of StrInterner* and every string it holds, and sets pointer to NULL
+ */
+void str_interner_free(StrInterner** interner) __attribute__((nonnull(1)));
+
+// MARK: Query
+
+/**
+ * @return the symbol of the given str if it has been interned, or an empty optional if not
+ */
+OptionSymbol str_interner_lookup(const StrInterner* interner, const StrSlice* str) __attribute__((nonnull(1, 2)));
+
+/**
+ * @return the str held by the given symbol, valid for the lifetime of the interner
+ */
+StrSlice str_interner_resolve(const StrInterner* interner, StrSymbol symbol) __attribute__((nonnull(1)));
+
+/**
+ * @return the number of distinct strings interned
+ */
+__attribute__((nonnull(1))) static inline usize str_interner_count(const StrInterner* interner) {
+    return interner->count;
+}
+
+// MARK: Mutation
+
+/**
+ * @return the symbol of the given str, copying it into the interner the first time it is seen
+ */
+StrSymbol str_interner_intern(StrInterner* interner, const StrSlice* str) __attribute__((nonnull(1, 2)));
+
+/**
+ * @brief interns count strs, storing the symbol of strs[i] in symbols[i]
+ * @note grows the table once up front rather than as it goes
+ */
+void str_interner_intern_all(StrInterner* interner, const StrSlice* strs, usize count, StrSymbol* symbols)
+    __attribute__((nonnull(1, 2, 4)));
+
+#endif
@@ -0,0 +1,266 @@
+#include "multi_match.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../core/memory.h"
+#include "search.h"
+
+#define _MULTI_DEAD  ((u32) 0)
+#define _MULTI_START ((u32) 1)
+#define _MULTI_FAIL  UINT32_MAX
+#define _MULTI_NONE  UINT32_MAX
+
+// MARK: Internal
+
+static inline u32* multi_row(const StrMultiMatcher* matcher, u32 state) {
+    return matcher->transitions + (usize) state * matcher->class_count;
+}
+
+/**
+ * @brief assigns each byte used by a pattern its own class, with every unused byte sharing class 0
+ */
+static void multi_compile_classes(StrMultiMatcher* matcher, const StrSlice* patterns, usize count) {
+    bool used[256] = {0};
+    bool starts[256] = {0};
+    usize start_count = 0;
+
+    for (usize p = 0; p < count; p++) {
+        for (usize i = 0; i < patterns[p].length; i++) {
+            used[(u8) patterns[p].buffer[i]] = true;
+        }
+        if (patterns[p].length > 0 && !starts[(u8) patterns[p].buffer[0]]) {
+            starts[(u8) patterns[p].buffer[0]] = true;
+            matcher->start_byte = patterns[p].buffer[0];
+            start_count++;
+        }
+    }
+
+    matcher->class_count = 1;
+    for (usize byte = 0; byte < 256; byte++) {
+        matcher->classes[byte] = used[byte] ? (u8) matcher->class_count++ : 0;
+    }
+    matcher->single_start = start_count == 1;
+}
+
+/**
+ * @brief builds the trie of all patterns, leaving every missing transition as _MULTI_FAIL
+ */
+static void multi_compile_trie(StrMultiMatcher* matcher, const StrSlice* patterns, usize count) {
+    matcher->state_count = 2;
+
+    for (usize p = 0; p < count; p++) {
+        matcher->pattern_lengths[p] = patterns[p].length;
+
+        if (patterns[p].length == 0) {
+            continue;
+        }
+
+        u32 state = _MULTI_START;
+        for (usize i = 0; i < patterns[p].length; i++) {
+            u32* next = multi_row(matcher, state) + matcher->classes[(u8) patterns[p].buffer[i]];
+            if (*next == _MULTI_FAIL) {
+                *next = (u32) matcher->state_count++;
+            }
+            state = *next;
+        }
+
+        if (matcher->matches[state] == _MULTI_NONE) {
+            matcher->matches[state] = (u32) p;
+        }
+    }
+}
+
+/**
+ * @brief resolves failure links breadth first and folds them into the table, turning the trie into a DFA
+ * @note for leftmost semantics a match state fails into the dead state, so a search stops as soon as no
+ *       longer match can start at or before the one already found
+ */
+static void multi_compile_dfa(StrMultiMatcher* matcher) {
+    u32* fails = heap_many(sizeof(u32), matcher->state_count);
+    u32* queue = heap_many(sizeof(u32), matcher->state_count);
+    usize head = 0;
+    usize tail = 0;
+
+    u32* dead = multi_row(matcher, _MULTI_DEAD);
+    u32* start = multi_row(matcher, _MULTI_START);
+
+    for (usize c = 0; c < matcher->class_count; c++) {
+        dead[c] = _MULTI_DEAD;
+
+        if (start[c] == _MULTI_FAIL) {
+            start[c] = _MULTI_START;
+            continue;
+        }
+
+        fails[start[c]] = matcher->matches[start[c]] != _MULTI_NONE ? _MULTI_DEAD : _MULTI_START;
+        queue[tail++] = start[c];
+    }
+
+    while (head < tail) {
+        u32 state = queue[head++];
+        u32* row = multi_row(matcher, state);
+        const u32* fail_row = multi_row(matcher, fails[state]);
+
+        for (usize c = 0; c < matcher->class_count; c++) {
+            u32 next = row[c];
+
+            if (next == _MULTI_FAIL) {
+                row[c] = fail_row[c];
+                continue;
+            }
+
+            if (matcher->matches[next] != _MULTI_NONE) {
+                fails[next] = _MULTI_DEAD;
+            } else {
+                fails[next] = fail_row[c];
+                matcher->matches[next] = matcher->matches[fails[next]];
+            }
+
+            queue[tail++] = next;
+        }
+    }
+
+    free(fails);
+    free(queue);
+}
+
+// MARK: Lifecycle
+
+StrMultiMatcher* str_multi_matcher_new(const StrSlice* patterns, usize count) {
+    ASSERT_NONNULL(patterns);
+    assert(count < _MULTI_NONE);
+
+    usize total_length = 0;
+    for (usize p = 0; p < count; p++) {
+        total_length += patterns[p].length;
+    }
+
+    assert(total_length + 2 < _MULTI_FAIL);
+
+    StrMultiMatcher* matcher = heap_one(sizeof(StrMultiMatcher));
+    multi_compile_classes(matcher, patterns, count);
+
+    usize capacity = total_length + 2;
+    matcher->pattern_count = count;
+    matcher->pattern_lengths = heap_many(sizeof(usize), count > 0 ? count : 1);
+    matcher->transitions = heap_many(sizeof(u32), capacity * matcher->class_count);
+    matcher->matches = heap_many(sizeof(u32), capacity);
+    memset(matcher->transitions, 0xFF, sizeof(u32) * capacity * matcher->class_count);
+    memset(matcher->matches, 0xFF, sizeof(u32) * capacity);
+
+    multi_compile_trie(matcher, patterns, count);
+    multi_compile_dfa(matcher);
+
+    return matcher;
+}
+
+void str_multi_matcher_free(StrMultiMatcher** matcher) {
+    ASSERT_NONNULL(matcher);
+    ASSERT_NONNULL(*matcher);
+
+    free((*matcher)->transitions);
+    free((*matcher)->matches);
+    free((*matcher)->pattern_lengths);
+    free(*matcher);
+    *matcher = NULL;
+}
+
+void str_multi_matches_free(StrMultiMatches** matches) {
+    ASSERT_NONNULL(matches);
+    ASSERT_NONNULL(*matches);
+
+    free((*matches)->matches);
+    free(*matches);
+    *matches = NULL;
+}
+
+// MARK: Query
+
+OptionMultiMatch str_multi_matcher_find_from(const StrMultiMatcher* matcher, const StrSlice* str, usize start) {
+    ASSERT_NONNULL(matcher);
+    ASSERT_NONNULL(str);
+
+    const u32* transitions = matcher->transitions;
+    usize class_count = matcher->class_count;
+    u32 state = _MULTI_START;
+    u32 pattern = _MULTI_NONE;
+    usize end = 0;
+
+    for (usize i = start; i < str->length; i++) {
+        if (state == _MULTI_START && matcher->single_start) {
+            // nothing is in progress -> jump straight to the next byte that can begin a match
+            i += bytes_find(str->buffer + i, str->length - i, matcher->start_byte);
+            if (i >= str->length) {
+                break;
+            }
+        }
+
+        state = transitions[(usize) state * class_count + matcher->classes[(u8) str->buffer[i]]];
+
+        if (state == _MULTI_DEAD) {
+            break;
+        }
+
+        if (matcher->matches[state] != _MULTI_NONE) {
+            pattern = matcher->matches[state];
+            end = i + 1;
+        }
+    }
+
+    if (pattern == _MULTI_NONE) {
+        return option_multi_match_empty();
+    }
+
+    return option_multi_match((StrMultiMatch) {pattern, end - matcher->pattern_lengths[pattern]});
+}
+
+StrMultiMatches* str_multi_matcher_find_all(const StrMultiMatcher* matcher, const StrSlice* str) {
+    ASSERT_NONNULL(matcher);
+    ASSERT_NONNULL(str);
+
+    usize capacity = 8;
+    StrMultiMatches* matches = heap_one(sizeof(StrMultiMatches));
+    matches->matches = heap_many(sizeof(StrMultiMatch), capacity);
+    matches->count = 0;
+
+    OptionMultiMatch found = str_multi_matcher_find_from(matcher, str, 0);
+
+    while (found.present) {
+        if (matches->count >= capacity) {
+            capacity *= 2;
+            matches->matches = heap_renew(matches->matches, sizeof(StrMultiMatch), capacity);
+        }
+
+        matches->matches[matches->count++] = found.value;
+        usize next = found.value.index + matcher->pattern_lengths[found.value.pattern];
+        found = str_multi_matcher_find_from(matcher, str, next);
+    }
+
+    return matches;
+}
+
+// MARK: Mutation
+
+void str_multi_matcher_replace_all(const StrMultiMatcher* matcher, const StrSlice* str, const StrSlice* replacements, StringMut* output) {
+    ASSERT_NONNULL(matcher);
+    ASSERT_NONNULL(str);
+    ASSERT_NONNULL(replacements);
+    ASSERT_NONNULL(output);
+
+    string_mut_reserve(output, str->length);
+
+    usize read = 0;
+    OptionMultiMatch found = str_multi_matcher_find_from(matcher, str, 0);
+
+    while (found.present) {
+        StrSlice run = {str->buffer + read, found.value.index - read};
+        string_mut_push(output, &run);
+        string_mut_push(output, &replacements[found.value.pattern]);
+
+        read = found.value.index + matcher->pattern_lengths[found.value.pattern];
+        found = str_multi_matcher_find_from(matcher, str, read);
+    }
+
+    StrSlice tail = {str->buffer + read, str->length - read};
+    string_mut_push(output, &tail);
+}
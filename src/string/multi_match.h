@@ -0,0 +1,100 @@
+#ifndef CTK_MULTI_MATCH_H
+#define CTK_MULTI_MATCH_H
+
+#include "../string/string.h"
+
+// MARK: Definition
+
+/**
+ * @brief Aho-Corasick automaton compiled once from a set of patterns, searching for all of them in a single pass
+ * @note compiled into a dense DFA over byte classes, so each haystack byte costs one table lookup whatever the
+ *       number of patterns, at the price of state_count * class_count transitions of memory
+ * @note matches are leftmost-longest and non-overlapping: the earliest starting match wins, and among matches
+ *       starting at the same index the longest pattern wins
+ * @note empty patterns never match, mirroring str_contains()
+ */
+typedef struct {
+    u32* transitions;
+    u32* matches;
+    usize* pattern_lengths;
+    usize pattern_count;
+    usize state_count;
+    usize class_count;
+    u8 classes[256];
+    bool single_start;
+    c8 start_byte;
+} StrMultiMatcher;
+
+/**
+ * @brief A single match of a StrMultiMatcher, where pattern is the index of the matched pattern
+ *        as it was passed to str_multi_matcher_new(), and index is its byte offset in the haystack
+ */
+typedef struct {
+    usize pattern;
+    usize index;
+} StrMultiMatch;
+
+DEFINE_OPTION(StrMultiMatch, MultiMatch, multi_match, ((StrMultiMatch) {0, 0}))
+
+/**
+ * @brief Heap allocated list of matches, ordered by index
+ */
+typedef struct {
+    StrMultiMatch* matches;
+    usize count;
+} StrMultiMatches;
+
+// MARK: Lifecycle
+
+/**
+ * @return heap allocated matcher over the given patterns, which may be freed once this returns
+ * @note if a pattern is given more than once, matches report the first index it was given at
+ * @note must be freed
+ */
+StrMultiMatcher* str_multi_matcher_new(const StrSlice* patterns, usize count)
+    __attribute__((warn_unused_result))
+    __attribute__((nonnull(1)));
+
+/**
+ * @brief deep free of StrMultiMatcher* and sets pointer to NULL
+ */
+void str_multi_matcher_free(StrMultiMatcher** matcher) __attribute__((nonnull(1)));
+
+/**
+ * @brief shallow free of StrMultiMatches and sets pointer to NULL
+ */
+void str_multi_matches_free(StrMultiMatches** matches) __attribute__((nonnull(1)));
+
+// MARK: Query
+
+/**
+ * @return the leftmost-longest match starting at or after start in the given str, or an empty optional if not found
+ */
+OptionMultiMatch str_multi_matcher_find_from(const StrMultiMatcher* matcher, const StrSlice* str, usize start)
+    __attribute__((nonnull(1, 2)));
+
+/**
+ * @return the leftmost-longest match in the given str, or an empty optional if not found
+ */
+__attribute__((nonnull(1, 2))) static inline OptionMultiMatch str_multi_matcher_find(const StrMultiMatcher* matcher, const StrSlice* str) {
+    return str_multi_matcher_find_from(matcher, str, 0);
+}
+
+/**
+ * @return a heap allocated list of every non-overlapping match in the given str, scanning left to right
+ * @note this does need to be freed
+ */
+StrMultiMatches* str_multi_matcher_find_all(const StrMultiMatcher* matcher, const StrSlice* str)
+    __attribute__((nonnull(1, 2)))
+    __attribute__((warn_unused_result));
+
+// MARK: Mutation
+
+/**
+ * @brief pushes the given str onto output with every match replaced by replacements[pattern], in one pass
+ * @note replacements must hold one entry per pattern, in the order the patterns were given
+ */
+void str_multi_matcher_replace_all(const StrMultiMatcher* matcher, const StrSlice* str, const StrSlice* replacements, StringMut* output)
+    __attribute__((nonnull(1, 2, 3, 4)));
+
+#endif
@@ -0,0 +1,1397 @@
+#include "number.h"
+#include <assert.h>
+#include <string.h>
+#include "../core/memory.h"
+#include "number_table.h"
+
+// MARK: Internal
+
+static const c8 DIGIT_PAIRS[200] = "0001020304050607080910111213141516171819"
+                                   "2021222324252627282930313233343536373839"
+                                   "4041424344454647484950515253545556575859"
+                                   "6061626364656667686970717273747576777879"
+                                   "8081828384858687888990919293949596979899";
+
+static const u64 POWERS_OF_TEN[20] = {
+    1ULL,
+    10ULL,
+    100ULL,
+    1000ULL,
+    10000ULL,
+    100000ULL,
+    1000000ULL,
+    10000000ULL,
+    100000000ULL,
+    1000000000ULL,
+    10000000000ULL,
+    100000000000ULL,
+    1000000000000ULL,
+    10000000000000ULL,
+    100000000000000ULL,
+    1000000000000000ULL,
+    10000000000000000ULL,
+    100000000000000000ULL,
+    1000000000000000000ULL,
+    10000000000000000000ULL,
+};
+
+static inline bool is_digit(c8 byte) {
+    return (u8) (byte - '0') < 10;
+}
+
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+/**
+ * @return true if all eight bytes of the little endian word are ASCII digits
+ * @note a byte is a digit when its high nibble is 3 and adding 6 does not carry out of its low nibble
+ */
+static inline bool is_eight_digits(u64 word) {
+    return ((word & 0xF0F0F0F0F0F0F0F0ULL) | (((word + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) ==
+           0x3333333333333333ULL;
+}
+
+/**
+ * @return the value of eight ASCII digits, the first of which sits in the lowest byte
+ * @note pairs, then quads, then the whole word are combined in three multiplies instead of eight
+ */
+static inline u32 parse_eight_digits(u64 word) {
+    word -= 0x3030303030303030ULL;
+    word = (word * 10) + (word >> 8);
+    word = (((word & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+            (((word >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >>
+           32;
+
+    return (u32) word;
+}
+#endif
+
+/**
+ * @return the number of leading digits consumed, storing their value in out, or 0 if there are none or they overflow
+ */
+static usize parse_digits(const c8* buffer, usize length, u64* out) {
+    u64 value = 0;
+    usize i = 0;
+
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    // sixteen digits stay below 10^16, so the first two words need no overflow checks
+    while (i < 16 && i + 8 <= length) {
+        u64 word;
+        memcpy(&word, buffer + i, sizeof(u64));
+        if (!is_eight_digits(word)) {
+            break;
+        }
+        value = value * 100000000 + parse_eight_digits(word);
+        i += 8;
+    }
+#endif
+
+    for (; i < length && is_digit(buffer[i]); i++) {
+        u64 digit = (u64) (buffer[i] - '0');
+
+        // i digits are below 10^i, so one more cannot overflow until the twentieth
+        if (i < 19) {
+            value = value * 10 + digit;
+        } else if (__builtin_mul_overflow(value, 10, &value) || __builtin_add_overflow(value, digit, &value)) {
+            return 0;
+        }
+    }
+
+    *out = value;
+    return i;
+}
+
+static inline usize digit_count(u64 value) {
+    usize estimate = ((usize) (64 - __builtin_clzll(value | 1)) * 1233) >> 12;
+    usize count = estimate + (value >= POWERS_OF_TEN[estimate]);
+
+    return count > 0 ? count : 1;
+}
+
+// MARK: Internal (floats)
+
+typedef unsigned __int128 _u128;
+
+/**
+ * @brief Decimal float as mantissa * 10^exponent, as produced by the shortest conversion
+ */
+typedef struct {
+    u64 mantissa;
+    i32 exponent;
+} DecimalFloat;
+
+/**
+ * @return ceil(log2(5^e)), exact for 0 <= e <= 3528
+ */
+static inline i32 pow5_bits(i32 e) {
+    return (i32) (((u32) e * 1217359) >> 19) + 1;
+}
+
+/**
+ * @return floor(log10(2^e)), exact for 0 <= e <= 1650
+ */
+static inline u32 log10_pow2(i32 e) {
+    return ((u32) e * 78913) >> 18;
+}
+
+/**
+ * @return floor(log10(5^e)), exact for 0 <= e <= 2620
+ */
+static inline u32 log10_pow5(i32 e) {
+    return ((u32) e * 732923) >> 20;
+}
+
+static inline u32 pow5_factor(u64 value) {
+    u32 count = 0;
+
+    while (value % 5 == 0) {
+        value /= 5;
+        count++;
+    }
+
+    return count;
+}
+
+static inline bool multiple_of_pow5(u64 value, u32 p) {
+    return pow5_factor(value) >= p;
+}
+
+static inline bool multiple_of_pow2(u64 value, u32 p) {
+    return (value & ((1ULL << p) - 1)) == 0;
+}
+
+static inline u64 mul_shift64(u64 m, const u64* factor, i32 shift) {
+    _u128 low = (_u128) m * factor[0];
+    _u128 high = (_u128) m * factor[1];
+
+    return (u64) (((low >> 64) + high) >> (shift - 64));
+}
+
+static inline u32 mul_shift32(u32 m, u64 factor, i32 shift) {
+    u64 low = (u64) m * (u32) factor;
+    u64 high = (u64) m * (factor >> 32);
+
+    return (u32) (((low >> 32) + high) >> (shift - 32));
+}
+
+/**
+ * @brief drops digits from vr while the interval (vm, vp) still holds a single shortest candidate
+ * @return the correctly rounded candidate, with the count of dropped digits added to removed
+ * @note the trailing zero flags track whether the dropped digits were exactly zero, which decides ties
+ */
+static u64 shortest_digits(u64 vr, u64 vp, u64 vm, bool accept_bounds, bool vm_zeros, bool vr_zeros, u8 last_removed, i32* removed) {
+    if (!vm_zeros && !vr_zeros) {
+        while (vp / 10 > vm / 10) {
+            last_removed = (u8) (vr % 10);
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            (*removed)++;
+        }
+
+        return vr + (vr == vm || last_removed >= 5);
+    }
+
+    while (vp / 10 > vm / 10) {
+        vm_zeros &= vm % 10 == 0;
+        vr_zeros &= last_removed == 0;
+        last_removed = (u8) (vr % 10);
+        vr /= 10;
+        vp /= 10;
+        vm /= 10;
+        (*removed)++;
+    }
+
+    if (vm_zeros) {
+        while (vm % 10 == 0) {
+            vr_zeros &= last_removed == 0;
+            last_removed = (u8) (vr % 10);
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            (*removed)++;
+        }
+    }
+
+    // an exact tie rounds to even
+    if (vr_zeros && last_removed == 5 && vr % 2 == 0) {
+        last_removed = 4;
+    }
+
+    return vr + ((vr == vm && (!accept_bounds || !vm_zeros)) || last_removed >= 5);
+}
+
+/**
+ * @return the shortest decimal that reads back as the given finite, non zero double
+ * @note Ryu (Adams, 2018): the rounding interval is scaled by a power of ten straight from the tables,
+ *       after which only the digits that do not identify the value are dropped
+ */
+static DecimalFloat shortest_f64(u64 ieee_mantissa, u32 ieee_exponent) {
+    i32 e2;
+    u64 m2;
+
+    if (ieee_exponent == 0) {
+        e2 = 1 - 1023 - 52 - 2;
+        m2 = ieee_mantissa;
+    } else {
+        e2 = (i32) ieee_exponent - 1023 - 52 - 2;
+        m2 = (1ULL << 52) | ieee_mantissa;
+    }
+
+    bool accept_bounds = (m2 & 1) == 0;
+    u64 mv = 4 * m2;
+    u32 mm_shift = ieee_mantissa != 0 || ieee_exponent <= 1;
+    u64 vr;
+    u64 vp;
+    u64 vm;
+    i32 e10;
+    bool vm_zeros = false;
+    bool vr_zeros = false;
+
+    if (e2 >= 0) {
+        u32 q = log10_pow2(e2) - (e2 > 3);
+        i32 k = _DOUBLE_POW5_INV_BITCOUNT + pow5_bits((i32) q) - 1;
+        i32 i = -e2 + (i32) q + k;
+        e10 = (i32) q;
+        vr = mul_shift64(4 * m2, DOUBLE_POW5_INV_SPLIT[q], i);
+        vp = mul_shift64(4 * m2 + 2, DOUBLE_POW5_INV_SPLIT[q], i);
+        vm = mul_shift64(4 * m2 - 1 - mm_shift, DOUBLE_POW5_INV_SPLIT[q], i);
+
+        if (q <= 21) {
+            if (mv % 5 == 0) {
+                vr_zeros = multiple_of_pow5(mv, q);
+            } else if (accept_bounds) {
+                vm_zeros = multiple_of_pow5(mv - 1 - mm_shift, q);
+            } else {
+                vp -= multiple_of_pow5(mv + 2, q);
+            }
+        }
+    } else {
+        u32 q = log10_pow5(-e2) - (-e2 > 1);
+        i32 i = -e2 - (i32) q;
+        i32 k = pow5_bits(i) - _DOUBLE_POW5_BITCOUNT;
+        i32 j = (i32) q - k;
+        e10 = (i32) q + e2;
+        vr = mul_shift64(4 * m2, DOUBLE_POW5_SPLIT[i], j);
+        vp = mul_shift64(4 * m2 + 2, DOUBLE_POW5_SPLIT[i], j);
+        vm = mul_shift64(4 * m2 - 1 - mm_shift, DOUBLE_POW5_SPLIT[i], j);
+
+        if (q <= 1) {
+            vr_zeros = true;
+            if (accept_bounds) {
+                vm_zeros = mm_shift == 1;
+            } else {
+                vp--;
+            }
+        } else if (q < 63) {
+            vr_zeros = multiple_of_pow2(mv, q);
+        }
+    }
+
+    i32 removed = 0;
+    u64 mantissa = shortest_digits(vr, vp, vm, accept_bounds, vm_zeros, vr_zeros, 0, &removed);
+
+    return (DecimalFloat) {mantissa, e10 + removed};
+}
+
+/**
+ * @return the shortest decimal that reads back as the given finite, non zero float
+ * @note same scheme as shortest_f64() over 32-bit products, plus the digit dropped by the scaling itself
+ */
+static DecimalFloat shortest_f32(u32 ieee_mantissa, u32 ieee_exponent) {
+    i32 e2;
+    u32 m2;
+
+    if (ieee_exponent == 0) {
+        e2 = 1 - 127 - 23 - 2;
+        m2 = ieee_mantissa;
+    } else {
+        e2 = (i32) ieee_exponent - 127 - 23 - 2;
+        m2 = (1U << 23) | ieee_mantissa;
+    }
+
+    bool accept_bounds = (m2 & 1) == 0;
+    u32 mv = 4 * m2;
+    u32 mp = 4 * m2 + 2;
+    u32 mm_shift = ieee_mantissa != 0 || ieee_exponent <= 1;
+    u32 mm = 4 * m2 - 1 - mm_shift;
+    u32 vr;
+    u32 vp;
+    u32 vm;
+    i32 e10;
+    bool vm_zeros = false;
+    bool vr_zeros = false;
+    u8 last_removed = 0;
+
+    if (e2 >= 0) {
+        u32 q = log10_pow2(e2);
+        i32 k = _FLOAT_POW5_INV_BITCOUNT + pow5_bits((i32) q) - 1;
+        i32 i = -e2 + (i32) q + k;
+        e10 = (i32) q;
+        vr = mul_shift32(mv, FLOAT_POW5_INV_SPLIT[q], i);
+        vp = mul_shift32(mp, FLOAT_POW5_INV_SPLIT[q], i);
+        vm = mul_shift32(mm, FLOAT_POW5_INV_SPLIT[q], i);
+
+        if (q != 0 && (vp - 1) / 10 <= vm / 10) {
+            i32 l = _FLOAT_POW5_INV_BITCOUNT + pow5_bits((i32) q - 1) - 1;
+            last_removed = (u8) (mul_shift32(mv, FLOAT_POW5_INV_SPLIT[q - 1], -e2 + (i32) q - 1 + l) % 10);
+        }
+
+        if (q <= 9) {
+            if (mv % 5 == 0) {
+                vr_zeros = multiple_of_pow5(mv, q);
+            } else if (accept_bounds) {
+                vm_zeros = multiple_of_pow5(mm, q);
+            } else {
+                vp -= multiple_of_pow5(mp, q);
+            }
+        }
+    } else {
+        u32 q = log10_pow5(-e2);
+        i32 i = -e2 - (i32) q;
+        i32 k = pow5_bits(i) - _FLOAT_POW5_BITCOUNT;
+        i32 j = (i32) q - k;
+        e10 = (i32) q + e2;
+        vr = mul_shift32(mv, FLOAT_POW5_SPLIT[i], j);
+        vp = mul_shift32(mp, FLOAT_POW5_SPLIT[i], j);
+        vm = mul_shift32(mm, FLOAT_POW5_SPLIT[i], j);
+
+        if (q != 0 && (vp - 1) / 10 <= vm / 10) {
+            j = (i32) q - 1 - (pow5_bits(i + 1) - _FLOAT_POW5_BITCOUNT);
+            last_removed = (u8) (mul_shift32(mv, FLOAT_POW5_SPLIT[i + 1], j) % 10);
+        }
+
+        if (q <= 1) {
+            vr_zeros = true;
+            if (accept_bounds) {
+                vm_zeros = mm_shift == 1;
+            } else {
+                vp--;
+            }
+        } else if (q < 31) {
+            vr_zeros = multiple_of_pow2(mv, q - 1);
+        }
+    }
+
+    i32 removed = 0;
+    u64 mantissa = shortest_digits(vr, vp, vm, accept_bounds, vm_zeros, vr_zeros, last_removed, &removed);
+
+    return (DecimalFloat) {mantissa, e10 + removed};
+}
+
+/**
+ * @return bytes written for nan, inf, -inf, 0 or -0, or 0 if the value is an ordinary finite number
+ */
+static usize format_special(c8* buffer, bool negative, bool exponent_max, bool mantissa_zero, bool exponent_zero) {
+    if (exponent_max && !mantissa_zero) {
+        memcpy(buffer, "nan", 3);
+        return 3;
+    }
+
+    usize length = 0;
+    if (negative) {
+        buffer[length++] = '-';
+    }
+
+    if (exponent_max) {
+        memcpy(buffer + length, "inf", 3);
+        return length + 3;
+    }
+
+    if (exponent_zero && mantissa_zero) {
+        buffer[length] = '0';
+        return length + 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @return bytes written for the decimal mantissa * 10^exponent, in plain notation when its leading digit
+ *         sits between 10^-4 and 10^15 and in scientific notation otherwise
+ */
+static usize format_decimal(c8* buffer, bool negative, DecimalFloat decimal) {
+    c8 digits[NUMBER_INT_MAX_CHARS];
+    usize count = number_format_u64(digits, decimal.mantissa);
+    i32 point = decimal.exponent + (i32) count;
+    usize length = 0;
+
+    if (negative) {
+        buffer[length++] = '-';
+    }
+
+    if (point - 1 < -4 || point - 1 >= 16) {
+        buffer[length++] = digits[0];
+        if (count > 1) {
+            buffer[length++] = '.';
+            memcpy(buffer + length, digits + 1, count - 1);
+            length += count - 1;
+        }
+        buffer[length++] = 'e';
+        return length + number_format_i64(buffer + length, point - 1);
+    }
+
+    if (point <= 0) {
+        memcpy(buffer + length, "0.", 2);
+        memset(buffer + length + 2, '0', (usize) -point);
+        length += 2 + (usize) -point;
+        memcpy(buffer + length, digits, count);
+        return length + count;
+    }
+
+    if ((usize) point >= count) {
+        memcpy(buffer + length, digits, count);
+        memset(buffer + length + count, '0', (usize) point - count);
+        return length + (usize) point;
+    }
+
+    memcpy(buffer + length, digits, (usize) point);
+    buffer[length + (usize) point] = '.';
+    memcpy(buffer + length + (usize) point + 1, digits + point, count - (usize) point);
+
+    return length + count + 1;
+}
+
+/**
+ * @return bytes written for the integer m * 2^e, which must not fit in 64 bits
+ * @note only reached for doubles of 2^64 and up, whose digits come from repeated division of a 35 limb integer
+ */
+static usize format_big_integer(c8* buffer, u64 m, i32 e) {
+    u32 limbs[36] = {0};
+    usize limb_count = (usize) (e / 32) + 3;
+    _u128 shifted = (_u128) m << (e % 32);
+
+    limbs[e / 32] = (u32) shifted;
+    limbs[e / 32 + 1] = (u32) (shifted >> 32);
+    limbs[e / 32 + 2] = (u32) (shifted >> 64);
+
+    // nine digit groups are produced least significant first, then written back to front
+    u32 groups[40];
+    usize group_count = 0;
+
+    while (limb_count > 0) {
+        u64 remainder = 0;
+        for (usize i = limb_count; i > 0; i--) {
+            u64 current = (remainder << 32) | limbs[i - 1];
+            limbs[i - 1] = (u32) (current / 1000000000);
+            remainder = current % 1000000000;
+        }
+        groups[group_count++] = (u32) remainder;
+
+        while (limb_count > 0 && limbs[limb_count - 1] == 0) {
+            limb_count--;
+        }
+    }
+
+    usize length = number_format_u64(buffer, groups[group_count - 1]);
+    for (usize i = group_count - 1; i > 0; i--) {
+        u32 group = groups[i - 1];
+        for (usize digit = 9; digit > 0; digit--) {
+            buffer[length + digit - 1] = (c8) ('0' + group % 10);
+            group /= 10;
+        }
+        length += 9;
+    }
+
+    return length;
+}
+
+/**
+ * @return bytes written for the 128-bit value, at most 39 digits
+ */
+static usize format_u128(c8* buffer, _u128 value) {
+    const u64 ten_19 = 10000000000000000000ULL;
+
+    if (value <= UINT64_MAX) {
+        return number_format_u64(buffer, (u64) value);
+    }
+
+    usize length = number_format_u64(buffer, (u64) (value / ten_19));
+    u64 low = (u64) (value % ten_19);
+
+    for (usize digit = 19; digit > 0; digit--) {
+        buffer[length + digit - 1] = (c8) ('0' + low % 10);
+        low /= 10;
+    }
+
+    return length + 19;
+}
+
+// MARK: Internal (float parsing)
+
+static const f64 EXACT_POWERS_F64[23] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+static const f32 EXACT_POWERS_F32[11] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+
+#define _BIG_DECIMAL_DIGITS 800
+#define _BIG_DECIMAL_MAX_SHIFT 60
+#define _DECIMAL_EXPONENT_LIMIT 100000
+
+/**
+ * @brief Layout of an IEEE binary format, so one conversion routine serves both f64 and f32
+ */
+typedef struct {
+    i32 mantissa_bits;
+    i32 minimum_exponent;
+    i32 infinite_power;
+    i32 smallest_power_of_ten;
+    i32 largest_power_of_ten;
+    i32 min_round_to_even;
+    i32 max_round_to_even;
+} FloatFormat;
+
+static const FloatFormat FORMAT_F64 = {52, -1023, 0x7FF, -342, 308, -4, 23};
+static const FloatFormat FORMAT_F32 = {23, -127, 0xFF, -65, 38, -17, 10};
+
+/**
+ * @brief Unsigned binary float as its biased exponent and the mantissa bits below the hidden one
+ */
+typedef struct {
+    u64 mantissa;
+    i32 power2;
+} BinaryFloat;
+
+typedef enum {
+    _DECIMAL_FINITE,
+    _DECIMAL_INFINITE,
+    _DECIMAL_NAN,
+} DecimalKind;
+
+/**
+ * @brief Decimal as read from text, mantissa * 10^exponent with at most the first 19 significant digits kept
+ */
+typedef struct {
+    u64 mantissa;
+    i64 exponent;
+    DecimalKind kind;
+    bool negative;
+    bool truncated;
+} DecimalInput;
+
+/**
+ * @brief Arbitrary precision decimal 0.d1d2d3... * 10^point for the inputs the fast paths cannot settle
+ * @note 800 digits cover the 767 significant digits an exact halfway f64 can need, anything past them
+ *       only matters as being nonzero, which is what truncated records
+ */
+typedef struct {
+    u8 digits[_BIG_DECIMAL_DIGITS + 20];
+    i32 count;
+    i32 point;
+    bool truncated;
+} BigDecimal;
+
+static inline bool matches_ignore_case(const c8* buffer, usize length, const char* word) {
+    usize i = 0;
+
+    for (; word[i] != '\0'; i++) {
+        if (i >= length || (buffer[i] | 0x20) != word[i]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @return the number of bytes of digits starting at buffer, accumulated into value with wrapping multiplies
+ */
+static inline usize scan_digits(const c8* buffer, usize length, u64* value) {
+    usize i = 0;
+
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    while (i + 8 <= length) {
+        u64 word;
+        memcpy(&word, buffer + i, sizeof(u64));
+        if (!is_eight_digits(word)) {
+            break;
+        }
+        *value = *value * 100000000 + parse_eight_digits(word);
+        i += 8;
+    }
+#endif
+
+    for (; i < length && is_digit(buffer[i]); i++) {
+        *value = *value * 10 + (u64) (buffer[i] - '0');
+    }
+
+    return i;
+}
+
+/**
+ * @return the number of bytes of the float at the front of buffer, filling in input, or 0 if there is none
+ */
+static usize scan_decimal(const c8* buffer, usize length, DecimalInput* input) {
+    usize i = 0;
+
+    *input = (DecimalInput) {0, 0, _DECIMAL_FINITE, false, false};
+
+    if (i < length && (buffer[i] == '+' || buffer[i] == '-')) {
+        input->negative = buffer[i] == '-';
+        i++;
+    }
+
+    usize integral_start = i;
+    i += scan_digits(buffer + i, length - i, &input->mantissa);
+    usize integral_end = i;
+    usize fraction_start = i;
+    usize fraction_end = i;
+
+    if (i < length && buffer[i] == '.') {
+        fraction_start = ++i;
+        i += scan_digits(buffer + i, length - i, &input->mantissa);
+        fraction_end = i;
+        input->exponent = -(i64) (fraction_end - fraction_start);
+    }
+
+    usize digits = (integral_end - integral_start) + (fraction_end - fraction_start);
+
+    if (digits == 0) {
+        usize start = integral_start;
+
+        if (matches_ignore_case(buffer + start, length - start, "nan")) {
+            input->kind = _DECIMAL_NAN;
+            return start + 3;
+        }
+        if (matches_ignore_case(buffer + start, length - start, "infinity")) {
+            input->kind = _DECIMAL_INFINITE;
+            return start + 8;
+        }
+        if (matches_ignore_case(buffer + start, length - start, "inf")) {
+            input->kind = _DECIMAL_INFINITE;
+            return start + 3;
+        }
+
+        return 0;
+    }
+
+    // an exponent without digits is not part of the number, just like strtod
+    i64 explicit_exponent = 0;
+
+    if (i < length && (buffer[i] | 0x20) == 'e') {
+        usize j = i + 1;
+        bool negative_exponent = j < length && buffer[j] == '-';
+
+        j += j < length && (buffer[j] == '-' || buffer[j] == '+');
+
+        if (j < length && is_digit(buffer[j])) {
+            for (; j < length && is_digit(buffer[j]); j++) {
+                if (explicit_exponent < _DECIMAL_EXPONENT_LIMIT) {
+                    explicit_exponent = explicit_exponent * 10 + (buffer[j] - '0');
+                }
+            }
+            explicit_exponent = negative_exponent ? -explicit_exponent : explicit_exponent;
+            i = j;
+        }
+    }
+
+    input->exponent += explicit_exponent;
+
+    if (digits <= 19) {
+        return i;
+    }
+
+    // leading zeros do not count towards the 19 digits a u64 can always hold
+    for (usize p = integral_start; p < fraction_end && (buffer[p] == '0' || buffer[p] == '.'); p++) {
+        digits -= buffer[p] == '0';
+    }
+
+    if (digits <= 19) {
+        return i;
+    }
+
+    // keep the first 19 significant digits and scale by however many were left behind
+    u64 mantissa = 0;
+    usize p = integral_start;
+    input->truncated = true;
+
+    while (mantissa < 1000000000000000000ULL && p < integral_end) {
+        mantissa = mantissa * 10 + (u64) (buffer[p++] - '0');
+    }
+
+    if (mantissa >= 1000000000000000000ULL) {
+        input->exponent = (i64) (integral_end - p) + explicit_exponent;
+    } else {
+        p = fraction_start;
+        while (mantissa < 1000000000000000000ULL && p < fraction_end) {
+            mantissa = mantissa * 10 + (u64) (buffer[p++] - '0');
+        }
+        input->exponent = -(i64) (p - fraction_start) + explicit_exponent;
+    }
+
+    input->mantissa = mantissa;
+    return i;
+}
+
+/**
+ * @return w * 10^q correctly rounded to the given format, per Eisel and Lemire
+ * @note a single 64 by 128-bit multiply against a truncated 5^q decides the result for every 19 digit w,
+ *       a second multiply against the lower half of 5^q is only needed when the first leaves the bits in doubt
+ */
+static BinaryFloat eisel_lemire(const FloatFormat* format, i64 q, u64 w) {
+    if (w == 0 || q < format->smallest_power_of_ten) {
+        return (BinaryFloat) {0, 0};
+    }
+    if (q > format->largest_power_of_ten) {
+        return (BinaryFloat) {0, format->infinite_power};
+    }
+
+    i32 leading_zeros = __builtin_clzll(w);
+    w <<= leading_zeros;
+
+    const u64* power = POW5_128[q - _POW5_128_MIN];
+    _u128 product = (_u128) w * power[1];
+    u64 high = (u64) (product >> 64);
+    u64 low = (u64) product;
+    u64 precision_mask = UINT64_MAX >> (format->mantissa_bits + 3);
+
+    if ((high & precision_mask) == precision_mask) {
+        u64 second_high = (u64) (((_u128) w * power[0]) >> 64);
+        low += second_high;
+        high += second_high > low;
+    }
+
+    i32 upper_bit = (i32) (high >> 63);
+    i32 shift = upper_bit + 64 - format->mantissa_bits - 3;
+    BinaryFloat answer;
+    answer.mantissa = high >> shift;
+    // floor(log2(10^q)) + 63, exact over the table's range
+    answer.power2 = (i32) (((((i32) q) * (152170 + 65536)) >> 16) + 63) + upper_bit - leading_zeros - format->minimum_exponent;
+
+    if (answer.power2 <= 0) {
+        // subnormal, the hidden bit survives the shift only when rounding carries into the smallest normal
+        if (-answer.power2 + 1 >= 64) {
+            return (BinaryFloat) {0, 0};
+        }
+        answer.mantissa >>= -answer.power2 + 1;
+        answer.mantissa += answer.mantissa & 1;
+        answer.mantissa >>= 1;
+        answer.power2 = answer.mantissa < (1ULL << format->mantissa_bits) ? 0 : 1;
+        return answer;
+    }
+
+    // an exact halfway product can only come from small q, where it must round to even instead of up
+    if (low <= 1 && q >= format->min_round_to_even && q <= format->max_round_to_even && (answer.mantissa & 3) == 1 &&
+        (answer.mantissa << shift) == high) {
+        answer.mantissa &= ~1ULL;
+    }
+
+    answer.mantissa += answer.mantissa & 1;
+    answer.mantissa >>= 1;
+
+    if (answer.mantissa >= (2ULL << format->mantissa_bits)) {
+        answer.mantissa = 1ULL << format->mantissa_bits;
+        answer.power2++;
+    }
+
+    answer.mantissa &= ~(1ULL << format->mantissa_bits);
+
+    if (answer.power2 >= format->infinite_power) {
+        return (BinaryFloat) {0, format->infinite_power};
+    }
+
+    return answer;
+}
+
+static void big_decimal_trim(BigDecimal* decimal) {
+    while (decimal->count > 0 && decimal->digits[decimal->count - 1] == 0) {
+        decimal->count--;
+    }
+    if (decimal->count == 0) {
+        decimal->point = 0;
+    }
+}
+
+/**
+ * @brief reads the float scan_decimal() accepted in the first length bytes of buffer
+ */
+static void big_decimal_read(BigDecimal* decimal, const c8* buffer, usize length) {
+    i64 point = 0;
+    bool seen_point = false;
+    usize i = buffer[0] == '+' || buffer[0] == '-';
+
+    decimal->count = 0;
+    decimal->truncated = false;
+
+    for (; i < length; i++) {
+        if (buffer[i] == '.') {
+            seen_point = true;
+            continue;
+        }
+        if (!is_digit(buffer[i])) {
+            break;
+        }
+
+        if (decimal->count == 0 && buffer[i] == '0') {
+            point -= seen_point;
+            continue;
+        }
+
+        point += !seen_point;
+
+        if (decimal->count < _BIG_DECIMAL_DIGITS) {
+            decimal->digits[decimal->count++] = (u8) (buffer[i] - '0');
+        } else if (buffer[i] != '0') {
+            decimal->truncated = true;
+        }
+    }
+
+    if (i < length) {
+        i64 exponent = 0;
+        usize j = i + 1;
+        bool negative_exponent = buffer[j] == '-';
+
+        j += buffer[j] == '-' || buffer[j] == '+';
+        for (; j < length; j++) {
+            if (exponent < _DECIMAL_EXPONENT_LIMIT) {
+                exponent = exponent * 10 + (buffer[j] - '0');
+            }
+        }
+        point += negative_exponent ? -exponent : exponent;
+    }
+
+    // anything this far out is already zero or infinite, clamping keeps the arithmetic in range
+    point = point < -_DECIMAL_EXPONENT_LIMIT ? -_DECIMAL_EXPONENT_LIMIT : point;
+    point = point > _DECIMAL_EXPONENT_LIMIT ? _DECIMAL_EXPONENT_LIMIT : point;
+    decimal->point = (i32) point;
+
+    big_decimal_trim(decimal);
+}
+
+/**
+ * @brief multiplies the decimal by 2^shift, for shift <= _BIG_DECIMAL_MAX_SHIFT
+ * @note digits are produced back to front, and since a 60-bit shift adds at most 19 digits the
+ *       write position always stays ahead of the read position inside the slack past the last digit
+ */
+static void big_decimal_shift_left(BigDecimal* decimal, u32 shift) {
+    i32 write = decimal->count + 19;
+    i32 end = write;
+    u64 carry = 0;
+
+    for (i32 read = decimal->count - 1; read >= 0; read--) {
+        carry += (u64) decimal->digits[read] << shift;
+        u64 quotient = carry / 10;
+        decimal->digits[--write] = (u8) (carry - quotient * 10);
+        carry = quotient;
+    }
+
+    while (carry > 0) {
+        u64 quotient = carry / 10;
+        decimal->digits[--write] = (u8) (carry - quotient * 10);
+        carry = quotient;
+    }
+
+    i32 produced = end - write;
+    decimal->point += produced - decimal->count;
+
+    if (produced > _BIG_DECIMAL_DIGITS) {
+        for (i32 i = _BIG_DECIMAL_DIGITS; i < produced; i++) {
+            decimal->truncated |= decimal->digits[write + i] != 0;
+        }
+        produced = _BIG_DECIMAL_DIGITS;
+    }
+
+    memmove(decimal->digits, decimal->digits + write, (usize) produced);
+    decimal->count = produced;
+    big_decimal_trim(decimal);
+}
+
+/**
+ * @brief divides the decimal by 2^shift, for shift <= _BIG_DECIMAL_MAX_SHIFT
+ */
+static void big_decimal_shift_right(BigDecimal* decimal, u32 shift) {
+    i32 read = 0;
+    i32 write = 0;
+    u64 remainder = 0;
+    u64 mask = (1ULL << shift) - 1;
+
+    // pull in digits until the running value reaches 2^shift
+    for (; (remainder >> shift) == 0; read++) {
+        if (read >= decimal->count) {
+            if (remainder == 0) {
+                decimal->count = 0;
+                return;
+            }
+            while ((remainder >> shift) == 0) {
+                remainder *= 10;
+                read++;
+            }
+            break;
+        }
+        remainder = remainder * 10 + decimal->digits[read];
+    }
+
+    decimal->point -= read - 1;
+
+    for (; read < decimal->count; read++) {
+        u8 digit = (u8) (remainder >> shift);
+        remainder &= mask;
+        decimal->digits[write++] = digit;
+        remainder = remainder * 10 + decimal->digits[read];
+    }
+
+    while (remainder > 0) {
+        u8 digit = (u8) (remainder >> shift);
+        remainder &= mask;
+        if (write < _BIG_DECIMAL_DIGITS) {
+            decimal->digits[write++] = digit;
+        } else if (digit > 0) {
+            decimal->truncated = true;
+        }
+        remainder *= 10;
+    }
+
+    decimal->count = write;
+    big_decimal_trim(decimal);
+}
+
+static void big_decimal_shift(BigDecimal* decimal, i32 shift) {
+    if (decimal->count == 0) {
+        return;
+    }
+
+    for (; shift > _BIG_DECIMAL_MAX_SHIFT; shift -= _BIG_DECIMAL_MAX_SHIFT) {
+        big_decimal_shift_left(decimal, _BIG_DECIMAL_MAX_SHIFT);
+    }
+    for (; shift < -_BIG_DECIMAL_MAX_SHIFT; shift += _BIG_DECIMAL_MAX_SHIFT) {
+        big_decimal_shift_right(decimal, _BIG_DECIMAL_MAX_SHIFT);
+    }
+
+    if (shift > 0) {
+        big_decimal_shift_left(decimal, (u32) shift);
+    } else if (shift < 0) {
+        big_decimal_shift_right(decimal, (u32) -shift);
+    }
+}
+
+/**
+ * @return the integer part of the decimal, rounded half to even on the digits that follow
+ */
+static u64 big_decimal_rounded_integer(const BigDecimal* decimal) {
+    u64 value = 0;
+    i32 i = 0;
+
+    for (; i < decimal->point && i < decimal->count; i++) {
+        value = value * 10 + decimal->digits[i];
+    }
+    for (; i < decimal->point; i++) {
+        value *= 10;
+    }
+
+    i32 next = decimal->point;
+
+    if (next >= 0 && next < decimal->count) {
+        bool halfway = decimal->digits[next] == 5 && next + 1 == decimal->count && !decimal->truncated;
+        value += halfway ? (value & 1) : decimal->digits[next] >= 5;
+    }
+
+    return value;
+}
+
+/**
+ * @return the decimal correctly rounded to the given format, by scaling it with exact binary shifts
+ */
+static BinaryFloat big_decimal_to_binary(const FloatFormat* format, BigDecimal* decimal) {
+    // SHIFTS[i] is the largest shift with 2^shift < 10^i, so no step carries the point across zero, and 2^27 < 10^9
+    static const i32 SHIFTS[9] = {1, 3, 6, 9, 13, 16, 19, 23, 26};
+    const i32 step = 27;
+    BinaryFloat infinite = {0, format->infinite_power};
+
+    if (decimal->count == 0 || decimal->point < -330) {
+        return (BinaryFloat) {0, 0};
+    }
+    if (decimal->point > 310) {
+        return infinite;
+    }
+
+    // scale into [1/2, 1), tracking the power of two taken out
+    i32 exponent = 0;
+
+    while (decimal->point > 0) {
+        i32 shift = decimal->point < 9 ? SHIFTS[decimal->point] : step;
+        big_decimal_shift(decimal, -shift);
+        exponent += shift;
+    }
+
+    while (decimal->point < 0 || (decimal->point == 0 && decimal->digits[0] < 5)) {
+        i32 shift = -decimal->point < 9 ? SHIFTS[-decimal->point] : step;
+        big_decimal_shift(decimal, shift);
+        exponent -= shift;
+    }
+
+    // [1, 2) * 2^exponent from here on, denormalized to the smallest exponent if it falls below it
+    exponent--;
+
+    if (exponent < format->minimum_exponent + 1) {
+        i32 shift = format->minimum_exponent + 1 - exponent;
+        big_decimal_shift(decimal, -shift);
+        exponent += shift;
+    }
+
+    if (exponent - format->minimum_exponent >= format->infinite_power) {
+        return infinite;
+    }
+
+    big_decimal_shift(decimal, format->mantissa_bits + 1);
+    u64 mantissa = big_decimal_rounded_integer(decimal);
+
+    if (mantissa == 2ULL << format->mantissa_bits) {
+        mantissa >>= 1;
+        exponent++;
+        if (exponent - format->minimum_exponent >= format->infinite_power) {
+            return infinite;
+        }
+    }
+
+    if ((mantissa & (1ULL << format->mantissa_bits)) == 0) {
+        exponent = format->minimum_exponent;
+    }
+
+    return (BinaryFloat) {mantissa & ((1ULL << format->mantissa_bits) - 1), exponent - format->minimum_exponent};
+}
+
+/**
+ * @return the IEEE bits, without the sign, of the finite decimal scan_decimal() read from the first length bytes of buffer
+ * @note with 19 or fewer significant digits Eisel-Lemire is always exact, with more it is exact whenever
+ *       rounding the truncated digits down and up lands on the same float, which leaves the rare rest to BigDecimal
+ */
+static u64 decimal_to_bits(const FloatFormat* format, const c8* buffer, usize length, const DecimalInput* input) {
+    BinaryFloat result = eisel_lemire(format, input->exponent, input->mantissa);
+
+    if (input->truncated) {
+        BinaryFloat above = eisel_lemire(format, input->exponent, input->mantissa + 1);
+
+        if (above.mantissa != result.mantissa || above.power2 != result.power2) {
+            BigDecimal decimal;
+            big_decimal_read(&decimal, buffer, length);
+            result = big_decimal_to_binary(format, &decimal);
+        }
+    }
+
+    return result.mantissa | ((u64) result.power2 << format->mantissa_bits);
+}
+
+// MARK: Parsing
+
+usize str_parse_u64_prefix(const StrSlice* str, u64* out) {
+    ASSERT_NONNULL(str);
+    ASSERT_NONNULL(out);
+
+    usize sign = str->length > 0 && str->buffer[0] == '+';
+    usize consumed = parse_digits(str->buffer + sign, str->length - sign, out);
+
+    return consumed > 0 ? sign + consumed : 0;
+}
+
+usize str_parse_i64_prefix(const StrSlice* str, i64* out) {
+    ASSERT_NONNULL(str);
+    ASSERT_NONNULL(out);
+
+    bool negative = str->length > 0 && str->buffer[0] == '-';
+    usize sign = str->length > 0 && (negative || str->buffer[0] == '+');
+    u64 magnitude;
+    usize consumed = parse_digits(str->buffer + sign, str->length - sign, &magnitude);
+
+    if (consumed == 0 || magnitude > (u64) INT64_MAX + negative) {
+        return 0;
+    }
+
+    // negating in unsigned space keeps INT64_MIN representable
+    *out = negative ? (i64) (0 - magnitude) : (i64) magnitude;
+    return sign + consumed;
+}
+
+OptionU64 str_parse_u64(const StrSlice* str) {
+    ASSERT_NONNULL(str);
+
+    u64 value;
+
+    if (str->length == 0 || str_parse_u64_prefix(str, &value) != str->length) {
+        return option_u64_empty();
+    }
+
+    return option_u64(value);
+}
+
+OptionI64 str_parse_i64(const StrSlice* str) {
+    ASSERT_NONNULL(str);
+
+    i64 value;
+
+    if (str->length == 0 || str_parse_i64_prefix(str, &value) != str->length) {
+        return option_i64_empty();
+    }
+
+    return option_i64(value);
+}
+
+usize str_parse_f64_prefix(const StrSlice* str, f64* out) {
+    ASSERT_NONNULL(str);
+    ASSERT_NONNULL(out);
+
+    DecimalInput input;
+    usize consumed = scan_decimal(str->buffer, str->length, &input);
+    f64 value;
+
+    if (consumed == 0) {
+        return 0;
+    }
+
+    if (input.kind != _DECIMAL_FINITE) {
+        value = input.kind == _DECIMAL_INFINITE ? __builtin_inf() : __builtin_nan("");
+    } else if (!input.truncated && input.mantissa <= (1ULL << 53) && input.exponent >= -22 && input.exponent <= 22) {
+        // both operands are exact, so the one correctly rounded operation rounds the result correctly (Clinger)
+        value = (f64) input.mantissa;
+        value = input.exponent < 0 ? value / EXACT_POWERS_F64[-input.exponent] : value * EXACT_POWERS_F64[input.exponent];
+    } else {
+        u64 bits = decimal_to_bits(&FORMAT_F64, str->buffer, consumed, &input);
+        memcpy(&value, &bits, sizeof(u64));
+    }
+
+    *out = input.negative ? -value : value;
+    return consumed;
+}
+
+usize str_parse_f32_prefix(const StrSlice* str, f32* out) {
+    ASSERT_NONNULL(str);
+    ASSERT_NONNULL(out);
+
+    DecimalInput input;
+    usize consumed = scan_decimal(str->buffer, str->length, &input);
+    f32 value;
+
+    if (consumed == 0) {
+        return 0;
+    }
+
+    if (input.kind != _DECIMAL_FINITE) {
+        value = input.kind == _DECIMAL_INFINITE ? __builtin_inff() : __builtin_nanf("");
+    } else if (!input.truncated && input.mantissa <= (1ULL << 24) && input.exponent >= -10 && input.exponent <= 10) {
+        value = (f32) input.mantissa;
+        value = input.exponent < 0 ? value / EXACT_POWERS_F32[-input.exponent] : value * EXACT_POWERS_F32[input.exponent];
+    } else {
+        u32 bits = (u32) decimal_to_bits(&FORMAT_F32, str->buffer, consumed, &input);
+        memcpy(&value, &bits, sizeof(u32));
+    }
+
+    *out = input.negative ? -value : value;
+    return consumed;
+}
+
+OptionU32 str_parse_u32(const StrSlice* str) {
+    ASSERT_NONNULL(str);
+
+    OptionU64 value = str_parse_u64(str);
+
+    if (!value.present || value.value > UINT32_MAX) {
+        return option_u32_empty();
+    }
+
+    return option_u32((u32) value.value);
+}
+
+OptionF64 str_parse_f64(const StrSlice* str) {
+    ASSERT_NONNULL(str);
+
+    f64 value;
+
+    if (str->length == 0 || str_parse_f64_prefix(str, &value) != str->length) {
+        return option_f64_empty();
+    }
+
+    return option_f64(value);
+}
+
+OptionF32 str_parse_f32(const StrSlice* str) {
+    ASSERT_NONNULL(str);
+
+    f32 value;
+
+    if (str->length == 0 || str_parse_f32_prefix(str, &value) != str->length) {
+        return option_f32_empty();
+    }
+
+    return option_f32(value);
+}
+
+// MARK: Formatting
+
+void string_mut_push_u64(StringMut* string_mut, u64 value) {
+    ASSERT_NONNULL(string_mut);
+
+    string_mut_reserve(string_mut, NUMBER_INT_MAX_CHARS);
+    usize length = string_mut_length(string_mut);
+    string_mut_set_length(string_mut, length + number_format_u64(string_mut_buffer(string_mut) + length, value));
+}
+
+void string_mut_push_i64(StringMut* string_mut, i64 value) {
+    ASSERT_NONNULL(string_mut);
+
+    string_mut_reserve(string_mut, NUMBER_INT_MAX_CHARS);
+    usize length = string_mut_length(string_mut);
+    string_mut_set_length(string_mut, length + number_format_i64(string_mut_buffer(string_mut) + length, value));
+}
+
+void string_mut_push_f64(StringMut* string_mut, f64 value) {
+    ASSERT_NONNULL(string_mut);
+
+    string_mut_reserve(string_mut, NUMBER_FLOAT_MAX_CHARS);
+    usize length = string_mut_length(string_mut);
+    string_mut_set_length(string_mut, length + number_format_f64(string_mut_buffer(string_mut) + length, value));
+}
+
+void string_mut_push_f32(StringMut* string_mut, f32 value) {
+    ASSERT_NONNULL(string_mut);
+
+    string_mut_reserve(string_mut, NUMBER_FLOAT_MAX_CHARS);
+    usize length = string_mut_length(string_mut);
+    string_mut_set_length(string_mut, length + number_format_f32(string_mut_buffer(string_mut) + length, value));
+}
+
+void string_mut_push_f64_fixed(StringMut* string_mut, f64 value, usize precision) {
+    ASSERT_NONNULL(string_mut);
+    assert(precision <= NUMBER_FLOAT_MAX_PRECISION);
+
+    c8 buffer[NUMBER_FIXED_MAX_CHARS];
+    usize length = number_format_f64_fixed(buffer, value, precision);
+
+    string_mut_push(string_mut, &(StrSlice) {buffer, length});
+}
+
+void string_mut_push_f32_fixed(StringMut* string_mut, f32 value, usize precision) {
+    string_mut_push_f64_fixed(string_mut, (f64) value, precision);
+}
+
+// MARK: Kernels
+
+usize number_format_u64(c8* buffer, u64 value) {
+    usize count = digit_count(value);
+    c8* cursor = buffer + count;
+
+    // the exact length is known up front, so digits are written back to front straight into place
+    while (value >= 100) {
+        u64 pair = value % 100;
+        value /= 100;
+        cursor -= 2;
+        memcpy(cursor, DIGIT_PAIRS + pair * 2, 2);
+    }
+
+    if (value >= 10) {
+        memcpy(cursor - 2, DIGIT_PAIRS + value * 2, 2);
+    } else {
+        cursor[-1] = (c8) ('0' + value);
+    }
+
+    return count;
+}
+
+usize number_format_i64(c8* buffer, i64 value) {
+    if (value >= 0) {
+        return number_format_u64(buffer, (u64) value);
+    }
+
+    buffer[0] = '-';
+    return 1 + number_format_u64(buffer + 1, 0 - (u64) value);
+}
+
+usize number_format_f64(c8* buffer, f64 value) {
+    u64 bits;
+    memcpy(&bits, &value, sizeof(u64));
+
+    bool negative = bits >> 63;
+    u32 ieee_exponent = (u32) (bits >> 52) & 0x7FF;
+    u64 ieee_mantissa = bits & ((1ULL << 52) - 1);
+    usize special = format_special(buffer, negative, ieee_exponent == 0x7FF, ieee_mantissa == 0, ieee_exponent == 0);
+
+    if (special > 0) {
+        return special;
+    }
+
+    return format_decimal(buffer, negative, shortest_f64(ieee_mantissa, ieee_exponent));
+}
+
+usize number_format_f32(c8* buffer, f32 value) {
+    u32 bits;
+    memcpy(&bits, &value, sizeof(u32));
+
+    bool negative = bits >> 31;
+    u32 ieee_exponent = (bits >> 23) & 0xFF;
+    u32 ieee_mantissa = bits & ((1U << 23) - 1);
+    usize special = format_special(buffer, negative, ieee_exponent == 0xFF, ieee_mantissa == 0, ieee_exponent == 0);
+
+    if (special > 0) {
+        return special;
+    }
+
+    return format_decimal(buffer, negative, shortest_f32(ieee_mantissa, ieee_exponent));
+}
+
+usize number_format_f64_fixed(c8* buffer, f64 value, usize precision) {
+    assert(precision <= NUMBER_FLOAT_MAX_PRECISION);
+
+    u64 bits;
+    memcpy(&bits, &value, sizeof(u64));
+
+    bool negative = bits >> 63;
+    u32 ieee_exponent = (u32) (bits >> 52) & 0x7FF;
+    u64 ieee_mantissa = bits & ((1ULL << 52) - 1);
+
+    if (ieee_exponent == 0x7FF) {
+        return format_special(buffer, negative, true, ieee_mantissa == 0, false);
+    }
+
+    u64 m = ieee_exponent == 0 ? ieee_mantissa : (1ULL << 52) | ieee_mantissa;
+    i32 e = (ieee_exponent == 0 ? 1 : (i32) ieee_exponent) - 1075;
+    usize length = 0;
+
+    if (negative) {
+        buffer[length++] = '-';
+    }
+
+    if (e >= 0) {
+        // integral value -> its exact digits, then a zero fraction
+        length += e <= 11 ? number_format_u64(buffer + length, m << e) : format_big_integer(buffer + length, m, e);
+        if (precision > 0) {
+            buffer[length++] = '.';
+            memset(buffer + length, '0', precision);
+            length += precision;
+        }
+        return length;
+    }
+
+    // value * 10^precision = m * 10^precision / 2^shift, rounded half to even on the exact binary value like printf
+    usize shift = (usize) -e;
+    _u128 scaled = (_u128) m * POWERS_OF_TEN[precision];
+    _u128 rounded = 0;
+
+    if (shift < 128) {
+        _u128 half = (_u128) 1 << (shift - 1);
+        _u128 remainder = scaled & (((_u128) 1 << shift) - 1);
+        rounded = scaled >> shift;
+        rounded += remainder > half || (remainder == half && (rounded & 1));
+    }
+
+    c8 digits[40 + NUMBER_FLOAT_MAX_PRECISION];
+    usize count = format_u128(digits, rounded);
+
+    // left pad with zeros so there is always at least one digit ahead of the point
+    if (count <= precision) {
+        usize padding = precision + 1 - count;
+        memmove(digits + padding, digits, count);
+        memset(digits, '0', padding);
+        count += padding;
+    }
+
+    usize integral = count - precision;
+    memcpy(buffer + length, digits, integral);
+    length += integral;
+
+    if (precision > 0) {
+        buffer[length] = '.';
+        length++;
+        memcpy(buffer + length, digits + integral, count - integral);
+        length += count - integral;
+    }
+
+    return length;
+}
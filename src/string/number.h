@@ -0,0 +1,160 @@
+#ifndef CTK_NUMBER_H
+#define CTK_NUMBER_H
+
+#include "../string/string.h"
+
+/**
+ * @brief Most bytes a formatted u64 or i64 can take, u64 max has 20 digits and i64 min has a sign plus 19
+ */
+#define NUMBER_INT_MAX_CHARS 20
+
+/**
+ * @brief Most bytes a shortest formatted f64 or f32 can take, as in -2.2250738585072014e-308
+ */
+#define NUMBER_FLOAT_MAX_CHARS 24
+
+/**
+ * @brief Most digits after the point fixed precision formatting supports, more than any double can meaningfully hold
+ */
+#define NUMBER_FLOAT_MAX_PRECISION 19
+
+/**
+ * @brief Most bytes a fixed precision f64 can take: a sign, 309 integer digits, the point and the fraction
+ */
+#define NUMBER_FIXED_MAX_CHARS (1 + 309 + 1 + NUMBER_FLOAT_MAX_PRECISION)
+
+// MARK: Preprocessor Type Defines
+
+DEFINE_OPTION(u64, U64, u64, 0)
+DEFINE_OPTION(i64, I64, i64, 0)
+DEFINE_OPTION(u32, U32, u32, 0)
+DEFINE_OPTION(f64, F64, f64, 0)
+DEFINE_OPTION(f32, F32, f32, 0)
+
+// MARK: Parsing
+
+/**
+ * @return the value of a str made up entirely of decimal digits with an optional leading '+',
+ *         or an empty optional if any other byte is present or the value does not fit
+ * @note digits are converted eight at a time with SWAR, so long inputs cost roughly one multiply per eight bytes
+ */
+OptionU64 str_parse_u64(const StrSlice* str) __attribute__((nonnull(1)));
+
+/**
+ * @return the value of a str made up entirely of decimal digits with an optional leading '+' or '-',
+ *         or an empty optional if any other byte is present or the value does not fit
+ */
+OptionI64 str_parse_i64(const StrSlice* str) __attribute__((nonnull(1)));
+
+/**
+ * @return the value of a str made up entirely of decimal digits with an optional leading '+',
+ *         or an empty optional if any other byte is present or the value does not fit
+ */
+OptionU32 str_parse_u32(const StrSlice* str) __attribute__((nonnull(1)));
+
+/**
+ * @return the number of bytes of the integer at the front of the given str, storing its value in out,
+ *         or 0 if the str does not start with one or its value does not fit
+ * @note parsing stops at the first byte that is not a digit, which makes this the building block for tokenizers
+ */
+usize str_parse_u64_prefix(const StrSlice* str, u64* out) __attribute__((nonnull(1, 2)));
+
+/**
+ * @return the number of bytes of the signed integer at the front of the given str, storing its value in out,
+ *         or 0 if the str does not start with one or its value does not fit
+ */
+usize str_parse_i64_prefix(const StrSlice* str, i64* out) __attribute__((nonnull(1, 2)));
+
+/**
+ * @return the value of a str made up entirely of a decimal float, or an empty optional if any other byte is present
+ * @note accepts what strtod does for decimal input, [+-]digits[.digits][e[+-]digits] as well as nan, inf and infinity
+ *       in any case, but no leading whitespace or hex floats, and values too large for a f64 come back as infinity
+ * @note the result is always correctly rounded, most inputs need one 128-bit multiply (Eisel-Lemire) and only
+ *       ones with more than 19 digits that sit right on a rounding boundary fall back to big decimal arithmetic
+ */
+OptionF64 str_parse_f64(const StrSlice* str) __attribute__((nonnull(1)));
+
+/**
+ * @return the value of a str made up entirely of a decimal float, rounded once, straight to f32
+ */
+OptionF32 str_parse_f32(const StrSlice* str) __attribute__((nonnull(1)));
+
+/**
+ * @return the number of bytes of the float at the front of the given str, storing its value in out,
+ *         or 0 if the str does not start with one
+ * @note no null terminator is needed, so a field can be parsed in place out of a larger buffer
+ */
+usize str_parse_f64_prefix(const StrSlice* str, f64* out) __attribute__((nonnull(1, 2)));
+
+/**
+ * @return the number of bytes of the float at the front of the given str, storing its value in out,
+ *         or 0 if the str does not start with one
+ */
+usize str_parse_f32_prefix(const StrSlice* str, f32* out) __attribute__((nonnull(1, 2)));
+
+// MARK: Formatting
+
+/**
+ * @brief pushes the decimal digits of the given value onto the end of the mutable string
+ */
+void string_mut_push_u64(StringMut* string_mut, u64 value) __attribute__((nonnull(1)));
+
+/**
+ * @brief pushes the decimal digits of the given value, with a leading '-' if negative, onto the end of the mutable string
+ */
+void string_mut_push_i64(StringMut* string_mut, i64 value) __attribute__((nonnull(1)));
+
+/**
+ * @brief pushes the shortest decimal that reads back as exactly the given value onto the end of the mutable string
+ * @note plain notation is used while the leading digit sits between 10^-4 and 10^15 (0.0001, 12.5, 1000),
+ *       scientific notation otherwise (1e-5, 1.5e16), and non finite values as nan, inf or -inf
+ * @note digits come from Ryu, which needs no big integers and no libc, only a few 128-bit multiplies
+ */
+void string_mut_push_f64(StringMut* string_mut, f64 value) __attribute__((nonnull(1)));
+
+/**
+ * @brief pushes the shortest decimal that reads back as exactly the given float onto the end of the mutable string
+ * @note shortest with respect to f32, so 0.1f is written 0.1 rather than its f64 expansion
+ */
+void string_mut_push_f32(StringMut* string_mut, f32 value) __attribute__((nonnull(1)));
+
+/**
+ * @brief pushes the given value with exactly precision digits after the point, like printf("%.*f")
+ * @note rounds half to even on the exact binary value, and precision must not exceed NUMBER_FLOAT_MAX_PRECISION
+ */
+void string_mut_push_f64_fixed(StringMut* string_mut, f64 value, usize precision) __attribute__((nonnull(1)));
+
+/**
+ * @brief pushes the given float with exactly precision digits after the point, like printf("%.*f")
+ */
+void string_mut_push_f32_fixed(StringMut* string_mut, f32 value, usize precision) __attribute__((nonnull(1)));
+
+// MARK: Kernels
+
+/**
+ * @return the number of bytes written to buffer, which must hold at least NUMBER_INT_MAX_CHARS
+ * @note digits are emitted two at a time from a lookup table, straight into place, with no libc involvement
+ */
+usize number_format_u64(c8* buffer, u64 value) __attribute__((nonnull(1)));
+
+/**
+ * @return the number of bytes written to buffer, which must hold at least NUMBER_INT_MAX_CHARS
+ */
+usize number_format_i64(c8* buffer, i64 value) __attribute__((nonnull(1)));
+
+/**
+ * @return the number of bytes written to buffer, which must hold at least NUMBER_FLOAT_MAX_CHARS
+ */
+usize number_format_f64(c8* buffer, f64 value) __attribute__((nonnull(1)));
+
+/**
+ * @return the number of bytes written to buffer, which must hold at least NUMBER_FLOAT_MAX_CHARS
+ */
+usize number_format_f32(c8* buffer, f32 value) __attribute__((nonnull(1)));
+
+/**
+ * @return the number of bytes written to buffer, which must hold at least NUMBER_FIXED_MAX_CHARS
+ */
+usize number_format_f64_fixed(c8* buffer, f64 value, usize precision) __attribute__((nonnull(1)));
+
+#endif
@@ -0,0 +1,126 @@
+#include "parallel.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../core/memory.h"
+#include "search.h"
+
+// MARK: Internal
+
+typedef struct {
+    StrSlice chunk;
+    c8 byte;
+    usize count;
+    StrSlices* slices;
+} ParallelChunk;
+
+/**
+ * @return the number of chunks worth splitting the given length into for the given pool
+ */
+static usize parallel_chunk_count(const ThreadPool* pool, usize length) {
+    usize chunks = pool->thread_count * 4;
+    usize largest = length / STR_PAR_MIN_CHUNK;
+
+    return chunks < largest ? chunks : (largest > 0 ? largest : 1);
+}
+
+static void parallel_count_task(void* argument) {
+    ParallelChunk* chunk = argument;
+    chunk->count = bytes_count(chunk->chunk.buffer, chunk->chunk.length, chunk->byte);
+}
+
+static void parallel_split_task(void* argument) {
+    ParallelChunk* chunk = argument;
+    chunk->slices = str_split_slices(&chunk->chunk, chunk->byte);
+}
+
+// MARK: Query
+
+StrSlices* str_par_split(ThreadPool* pool, const StrSlice* str, c8 delimiter) {
+    ASSERT_NONNULL(pool);
+    ASSERT_NONNULL(str);
+
+    usize chunk_count = parallel_chunk_count(pool, str->length);
+
+    if (chunk_count == 1) {
+        return str_split_slices(str, delimiter);
+    }
+
+    ParallelChunk* chunks = heap_many(sizeof(ParallelChunk), chunk_count);
+    usize target = str->length / chunk_count;
+    usize start = 0;
+    usize used = 0;
+
+    // every chunk but the last ends just past a delimiter, so no field straddles two chunks
+    while (start < str->length) {
+        usize end = str->length;
+
+        if (used + 1 < chunk_count && start + target < str->length) {
+            usize from = start + target;
+            end = from + bytes_find(str->buffer + from, str->length - from, delimiter);
+            end = end < str->length ? end + 1 : end;
+        }
+
+        chunks[used++] = (ParallelChunk) {.chunk = {str->buffer + start, end - start}, .byte = delimiter};
+        start = end;
+    }
+
+    ThreadPoolGroup group;
+    thread_pool_group_init(&group);
+    for (usize i = 0; i < used; i++) {
+        thread_pool_submit_group(pool, &group, parallel_split_task, &chunks[i]);
+    }
+    thread_pool_group_wait(pool, &group);
+
+    usize total = 0;
+    for (usize i = 0; i < used; i++) {
+        total += chunks[i].slices->count;
+    }
+
+    StrSlices* slices = heap_one(sizeof(StrSlices));
+    slices->slices = heap_many(sizeof(StrSlice), total > 0 ? total : 1);
+    slices->count = 0;
+
+    for (usize i = 0; i < used; i++) {
+        memcpy(slices->slices + slices->count, chunks[i].slices->slices, sizeof(StrSlice) * chunks[i].slices->count);
+        slices->count += chunks[i].slices->count;
+        str_slices_free(&chunks[i].slices);
+    }
+
+    free(chunks);
+
+    return slices;
+}
+
+usize str_par_count_char(ThreadPool* pool, const StrSlice* str, c8 query) {
+    ASSERT_NONNULL(pool);
+    ASSERT_NONNULL(str);
+
+    usize chunk_count = parallel_chunk_count(pool, str->length);
+
+    if (chunk_count == 1) {
+        return bytes_count(str->buffer, str->length, query);
+    }
+
+    ParallelChunk* chunks = heap_many(sizeof(ParallelChunk), chunk_count);
+    usize target = str->length / chunk_count;
+    ThreadPoolGroup group;
+    thread_pool_group_init(&group);
+
+    for (usize i = 0; i < chunk_count; i++) {
+        usize start = i * target;
+        usize length = i + 1 < chunk_count ? target : str->length - start;
+        chunks[i] = (ParallelChunk) {.chunk = {str->buffer + start, length}, .byte = query};
+        thread_pool_submit_group(pool, &group, parallel_count_task, &chunks[i]);
+    }
+    thread_pool_group_wait(pool, &group);
+
+    usize count = 0;
+    for (usize i = 0; i < chunk_count; i++) {
+        count += chunks[i].count;
+    }
+
+    free(chunks);
+
+    return count;
+}
@@ -0,0 +1,30 @@
+#ifndef CTK_PARALLEL_H
+#define CTK_PARALLEL_H
+
+#include "../os/thread_pool.h"
+#include "../string/string.h"
+
+/**
+ * @brief Inputs shorter than this many bytes per chunk are not worth handing to other threads
+ */
+#define STR_PAR_MIN_CHUNK (1 << 20)
+
+// MARK: Query
+
+/**
+ * @return the same slices as str_split_slices(), split across the given pool in delimiter aligned chunks
+ * @note the per chunk results are concatenated in order, so slices stay sorted by position
+ * @note waits only on its own chunks, so the pool may be shared and this may be called from one of its tasks
+ * @note this does need to be freed
+ */
+StrSlices* str_par_split(ThreadPool* pool, const StrSlice* str, c8 delimiter)
+    __attribute__((nonnull(1, 2)))
+    __attribute__((warn_unused_result));
+
+/**
+ * @return the number of times the given query occurs in the given str, counted across the given pool
+ * @note waits only on its own chunks, so the pool may be shared and this may be called from one of its tasks
+ */
+usize str_par_count_char(ThreadPool* pool, const StrSlice* str, c8 query) __attribute__((nonnull(1, 2)));
+
+#endif
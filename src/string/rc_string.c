@@ -0,0 +1,75 @@
+#include "rc_string.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../core/memory.h"
+
+// MARK: Internal
+
+/**
+ * @return the allocation the given string's bytes live in, which is the string itself unless it is a by value copy
+ *         of the header, such as the element vec_*_push_back() takes
+ */
+static inline RcString* rc_string_owner(const RcString* string) {
+    return (RcString*) string->buffer - 1;
+}
+
+// MARK: Lifecycle
+
+RcString* rc_string_from_str(const StrSlice* str) {
+    ASSERT_NONNULL(str);
+
+    RcString* string = heap_one(sizeof(RcString) + str->length);
+    string->buffer = (c8*) (string + 1);
+    string->length = str->length;
+    string->references = 1;
+    memcpy(string->buffer, str->buffer, str->length);
+
+    return string;
+}
+
+RcString* rc_string_new(const c8* cstr_literal) {
+    ASSERT_NONNULL(cstr_literal);
+
+    return rc_string_from_str(&(StrSlice) {cstr_literal, strlen(cstr_literal)});
+}
+
+RcString* rc_string_clone(const RcString* string) {
+    ASSERT_NONNULL(string);
+
+    // the string is immutable, only its count changes, and a new owner needs no ordering with the others
+    RcString* shared = rc_string_owner(string);
+    __atomic_fetch_add(&shared->references, 1, __ATOMIC_RELAXED);
+
+    return shared;
+}
+
+void rc_string_free(RcString** string) {
+    ASSERT_NONNULL(string);
+    ASSERT_NONNULL(*string);
+    // a by value copy would decrement a count it does not own and free memory that was never allocated
+    assert(*string == rc_string_owner(*string));
+
+    // release so every owner is done with the bytes before the last one, which acquires, frees them
+    if (__atomic_fetch_sub(&(*string)->references, 1, __ATOMIC_RELEASE) == 1) {
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        free(*string);
+    }
+
+    *string = NULL;
+}
+
+// MARK: Query
+
+usize rc_string_references(const RcString* string) {
+    ASSERT_NONNULL(string);
+
+    return __atomic_load_n(&rc_string_owner(string)->references, __ATOMIC_RELAXED);
+}
+
+i32 rc_string_compare(const RcString** one, const RcString** two) {
+    ASSERT_NONNULL(one);
+    ASSERT_NONNULL(two);
+
+    return str_compare(rc_string_as_ref(*one), rc_string_as_ref(*two));
+}
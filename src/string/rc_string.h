@@ -0,0 +1,81 @@
+#ifndef CTK_RC_STRING_H
+#define CTK_RC_STRING_H
+
+#include "../string/string.h"
+
+// MARK: Definition
+
+/**
+ * @brief Heap allocated, immutable, non-null terminated string shared between owners by an atomic reference count
+ * @note Shares the buffer and length layout of Str, with the bytes stored in the same allocation right after it
+ * @note has no flexible array member, so it may be passed by value, as vec_*_push_back() does, without a changed ABI
+ * @note cloning only increments the count and freeing only decrements it, the bytes are released with the last owner,
+ *       which makes it the cheap choice for strings copied into several collections or across threads
+ */
+typedef struct {
+    c8* buffer;
+    usize length;
+    usize references;
+} RcString;
+
+// MARK: Lifecycle
+
+/**
+ * @param cstr_literal as a null terminated raw c string
+ * @return heap allocated RcString with a single reference
+ * @note must be freed
+ */
+RcString* rc_string_new(const c8* cstr_literal)
+    __attribute__((warn_unused_result))
+    __attribute__((nonnull(1)));
+
+/**
+ * @return heap allocated RcString with a single reference, holding a copy of the given str
+ * @note must be freed
+ */
+RcString* rc_string_from_str(const StrSlice* str)
+    __attribute__((warn_unused_result))
+    __attribute__((nonnull(1)));
+
+/**
+ * @return the given string with one more reference, no bytes are copied
+ * @note every clone must be freed, this is the clone hook to hand to DEFINE_VEC()
+ * @note the count lives with the bytes, so a by value copy of the header, such as the element vec_*_push_back()
+ *       takes, still clones the string it was copied from
+ */
+RcString* rc_string_clone(const RcString* string)
+    __attribute__((warn_unused_result))
+    __attribute__((nonnull(1)));
+
+/**
+ * @brief drops one reference, freeing the string along with the last one, and sets pointer to NULL
+ * @note this is the destroy hook to hand to DEFINE_VEC(), it must be given a string returned by a constructor or
+ *       rc_string_clone(), never a by value copy of one
+ */
+void rc_string_free(RcString** string) __attribute__((nonnull(1)));
+
+// MARK: Shallow conversions
+
+/**
+ * @brief takes a reference to the given string without cloning
+ * @note the slice is valid for as long as the caller holds a reference
+ */
+__attribute__((nonnull(1))) static inline StrSlice* rc_string_as_ref(const RcString* string) {
+    return (StrSlice*) string;
+}
+
+// MARK: Query
+
+/**
+ * @return the number of owners currently sharing the given string
+ * @note only a snapshot when other threads clone or free it concurrently
+ */
+usize rc_string_references(const RcString* string) __attribute__((nonnull(1)));
+
+/**
+ * @return same as str_compare() on the strings the given elements point to
+ * @note this is the compare hook to hand to DEFINE_VEC()
+ */
+i32 rc_string_compare(const RcString** one, const RcString** two) __attribute__((nonnull(1, 2)));
+
+#endif
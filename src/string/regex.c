@@ -0,0 +1,1742 @@
+#include "regex.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../core/memory.h"
+#include "hash.h"
+
+#define _REGEX_NONE UINT32_MAX
+
+#define _OP_CLASS  0
+#define _OP_MATCH  1
+#define _OP_SPLIT  2
+#define _OP_SAVE   3
+#define _OP_ASSERT 4
+
+#define _ASSERT_START    0
+#define _ASSERT_END      1
+#define _ASSERT_WORD     2
+#define _ASSERT_NOT_WORD 3
+
+#define _NODE_EMPTY     0
+#define _NODE_SET       1
+#define _NODE_ASSERT    2
+#define _NODE_CONCAT    3
+#define _NODE_ALTERNATE 4
+#define _NODE_REPEAT    5
+#define _NODE_GROUP     6
+
+#define _FLAG_IGNORE_CASE 1
+#define _FLAG_DOT_ALL     2
+
+#define _REGEX_MAX_DEPTH  256
+#define _REGEX_MAX_REPEAT 1000
+#define _REGEX_MAX_INSTS  (1 << 17)
+#define _REGEX_MAX_CLEARS 8
+
+#define _DFA_DEAD       ((u32) 0)
+#define _DFA_DEAD_MATCH ((u32) 1)
+#define _DFA_QUIT       (UINT32_MAX - 1)
+#define _DFA_UNKNOWN    UINT32_MAX
+
+// transitions hold each state's row offset, premultiplied by the stride, tagged with what a search must stop for
+#define _TAG_UNKNOWN 0x80000000u
+#define _TAG_MATCH   0x40000000u
+#define _TAG_DEAD    0x20000000u
+#define _TAG_START   0x10000000u
+#define _TAG_MASK    0xF0000000u
+
+_Static_assert(REGEX_CACHE_CAPACITY / sizeof(u32) < _TAG_START, "regex cache rows must fit below the tag bits");
+
+#define _STATE_MATCH      1
+#define _STATE_WORD       2
+#define _STATE_TEXT_START 4
+#define _STATE_KEY        7
+#define _STATE_START      8
+
+#define _SEARCH_NONE  0
+#define _SEARCH_FOUND 1
+#define _SEARCH_QUIT  2
+
+// MARK: Internal (byte sets)
+
+static inline bool set_contains(const u64* set, u8 byte) {
+    return (set[byte >> 6] >> (byte & 63)) & 1;
+}
+
+static inline void set_add(u64* set, u8 byte) {
+    set[byte >> 6] |= (u64) 1 << (byte & 63);
+}
+
+static void set_add_range(u64* set, u8 low, u8 high) {
+    for (usize byte = low; byte <= high; byte++) {
+        set_add(set, (u8) byte);
+    }
+}
+
+static void set_negate(u64* set) {
+    for (usize i = 0; i < 4; i++) {
+        set[i] = ~set[i];
+    }
+}
+
+/**
+ * @brief adds the other case of every ASCII letter already in the set
+ */
+static void set_fold_case(u64* set) {
+    for (u8 byte = 'a'; byte <= 'z'; byte++) {
+        if (set_contains(set, byte) || set_contains(set, (u8) (byte - 0x20))) {
+            set_add(set, byte);
+            set_add(set, (u8) (byte - 0x20));
+        }
+    }
+}
+
+static inline bool regex_is_word(u8 byte) {
+    return (u8) ((byte | 0x20) - 'a') < 26 || (u8) (byte - '0') < 10 || byte == '_';
+}
+
+/**
+ * @return true and adds \d, \w, \s or one of their negations to the set, or false if the escape is none of them
+ */
+static bool set_add_escape(u64* set, c8 escape) {
+    u64 class[4] = {0};
+
+    switch (escape | 0x20) {
+        case 'd':
+            set_add_range(class, '0', '9');
+            break;
+        case 'w':
+            set_add_range(class, '0', '9');
+            set_add_range(class, 'A', 'Z');
+            set_add_range(class, 'a', 'z');
+            set_add(class, '_');
+            break;
+        case 's':
+            set_add_range(class, '\t', '\r');
+            set_add(class, ' ');
+            break;
+        default:
+            return false;
+    }
+
+    // the uppercase escapes are the negated classes
+    if (escape >= 'A' && escape <= 'Z') {
+        set_negate(class);
+    }
+    for (usize i = 0; i < 4; i++) {
+        set[i] |= class[i];
+    }
+
+    return true;
+}
+
+// MARK: Internal (parsing)
+
+/**
+ * @brief Node of the syntax tree, where children are linked through next, and min holds the byte set of a
+ *        set node or the capture index of a group node
+ */
+typedef struct {
+    u8 kind;
+    u8 assertion;
+    bool greedy;
+    u32 child;
+    u32 next;
+    u32 min;
+    u32 max;
+} RegexNode;
+
+typedef struct {
+    const c8* buffer;
+    usize length;
+    usize index;
+    usize error;
+    RegexNode* nodes;
+    usize node_count;
+    usize node_capacity;
+    u64* sets;
+    usize set_count;
+    usize set_capacity;
+    usize group_count;
+    usize depth;
+} RegexParser;
+
+static u32 parse_alternation(RegexParser* parser, u8 flags);
+
+static u32 parser_fail(RegexParser* parser, usize index) {
+    if (parser->error == SIZE_MAX) {
+        parser->error = index;
+    }
+
+    return _REGEX_NONE;
+}
+
+static u32 parser_node(RegexParser* parser, u8 kind) {
+    if (parser->node_count >= parser->node_capacity) {
+        parser->node_capacity *= 2;
+        parser->nodes = heap_renew(parser->nodes, sizeof(RegexNode), parser->node_capacity);
+    }
+
+    RegexNode* node = &parser->nodes[parser->node_count];
+    memset(node, 0, sizeof(RegexNode));
+    node->kind = kind;
+    node->child = _REGEX_NONE;
+    node->next = _REGEX_NONE;
+
+    return (u32) parser->node_count++;
+}
+
+/**
+ * @return a set node holding the given bytes
+ */
+static u32 parser_set(RegexParser* parser, const u64* set) {
+    if (parser->set_count >= parser->set_capacity) {
+        parser->set_capacity *= 2;
+        parser->sets = heap_renew(parser->sets, sizeof(u64) * 4, parser->set_capacity);
+    }
+
+    memcpy(parser->sets + parser->set_count * 4, set, sizeof(u64) * 4);
+    u32 node = parser_node(parser, _NODE_SET);
+    parser->nodes[node].min = (u32) parser->set_count++;
+
+    return node;
+}
+
+static u32 parser_literal(RegexParser* parser, u8 byte, u8 flags) {
+    u64 set[4] = {0};
+    set_add(set, byte);
+    if (flags & _FLAG_IGNORE_CASE) {
+        set_fold_case(set);
+    }
+
+    return parser_set(parser, set);
+}
+
+static u32 parser_assertion(RegexParser* parser, u8 assertion) {
+    u32 node = parser_node(parser, _NODE_ASSERT);
+    parser->nodes[node].assertion = assertion;
+
+    return node;
+}
+
+static inline bool parser_peek(const RegexParser* parser, c8 byte) {
+    return parser->index < parser->length && parser->buffer[parser->index] == byte;
+}
+
+/**
+ * @return the byte spelled by the escape at index - 1, or -1 after failing if it spells none
+ */
+static i32 parse_escape_byte(RegexParser* parser, c8 escape) {
+    switch (escape) {
+        case 'n':
+            return '\n';
+        case 't':
+            return '\t';
+        case 'r':
+            return '\r';
+        case 'f':
+            return '\f';
+        case 'v':
+            return '\v';
+        case '0':
+            return '\0';
+        case 'x': {
+            i32 value = 0;
+            for (usize i = 0; i < 2; i++) {
+                if (parser->index >= parser->length) {
+                    parser_fail(parser, parser->length);
+                    return -1;
+                }
+
+                u8 digit = (u8) parser->buffer[parser->index];
+                if ((u8) (digit - '0') < 10) {
+                    value = value * 16 + digit - '0';
+                } else if ((u8) ((digit | 0x20) - 'a') < 6) {
+                    value = value * 16 + (digit | 0x20) - 'a' + 10;
+                } else {
+                    parser_fail(parser, parser->index);
+                    return -1;
+                }
+                parser->index++;
+            }
+            return value;
+        }
+        default:
+            // any escaped ASCII punctuation stands for itself
+            if ((escape >= '!' && escape <= '/') || (escape >= ':' && escape <= '@') ||
+                (escape >= '[' && escape <= '`') || (escape >= '{' && escape <= '~')) {
+                return (u8) escape;
+            }
+            parser_fail(parser, parser->index - 1);
+            return -1;
+    }
+}
+
+static u32 parse_escape(RegexParser* parser, u8 flags) {
+    parser->index++;
+    if (parser->index >= parser->length) {
+        return parser_fail(parser, parser->length);
+    }
+
+    c8 escape = parser->buffer[parser->index++];
+    u64 set[4] = {0};
+
+    switch (escape) {
+        case 'b':
+            return parser_assertion(parser, _ASSERT_WORD);
+        case 'B':
+            return parser_assertion(parser, _ASSERT_NOT_WORD);
+        case 'A':
+            return parser_assertion(parser, _ASSERT_START);
+        case 'z':
+            return parser_assertion(parser, _ASSERT_END);
+        default:
+            break;
+    }
+
+    if (set_add_escape(set, escape)) {
+        return parser_set(parser, set);
+    }
+
+    i32 byte = parse_escape_byte(parser, escape);
+    return byte < 0 ? _REGEX_NONE : parser_literal(parser, (u8) byte, flags);
+}
+
+/**
+ * @return the byte at the front of a class, or -1 after failing, and adds any class escape straight to the set
+ */
+static i32 parse_class_byte(RegexParser* parser, u64* set, bool* escaped_class) {
+    c8 byte = parser->buffer[parser->index++];
+    *escaped_class = false;
+
+    if (byte != '\\') {
+        return (u8) byte;
+    }
+    if (parser->index >= parser->length) {
+        parser_fail(parser, parser->length);
+        return -1;
+    }
+
+    c8 escape = parser->buffer[parser->index++];
+    if (set_add_escape(set, escape)) {
+        *escaped_class = true;
+        return -1;
+    }
+
+    return parse_escape_byte(parser, escape);
+}
+
+static u32 parse_class(RegexParser* parser, u8 flags) {
+    u64 set[4] = {0};
+    bool negated = false;
+    bool first = true;
+
+    parser->index++;
+    if (parser_peek(parser, '^')) {
+        negated = true;
+        parser->index++;
+    }
+
+    for (;;) {
+        if (parser->index >= parser->length) {
+            return parser_fail(parser, parser->length);
+        }
+        if (parser->buffer[parser->index] == ']' && !first) {
+            parser->index++;
+            break;
+        }
+        first = false;
+
+        bool escaped_class;
+        i32 low = parse_class_byte(parser, set, &escaped_class);
+        if (escaped_class) {
+            continue;
+        }
+        if (low < 0) {
+            return _REGEX_NONE;
+        }
+
+        i32 high = low;
+        if (parser_peek(parser, '-') && parser->index + 1 < parser->length && parser->buffer[parser->index + 1] != ']') {
+            usize range = parser->index - 1;
+            parser->index++;
+            usize start = parser->index;
+            high = parse_class_byte(parser, set, &escaped_class);
+            if (escaped_class) {
+                return parser_fail(parser, start);
+            }
+            if (high < 0) {
+                return _REGEX_NONE;
+            }
+            if (high < low) {
+                return parser_fail(parser, range);
+            }
+        }
+        set_add_range(set, (u8) low, (u8) high);
+    }
+
+    if (flags & _FLAG_IGNORE_CASE) {
+        set_fold_case(set);
+    }
+    if (negated) {
+        set_negate(set);
+    }
+
+    return parser_set(parser, set);
+}
+
+static u32 parse_group(RegexParser* parser, u8* flags) {
+    usize open = parser->index++;
+    u8 inner = *flags;
+    bool capture = true;
+
+    if (++parser->depth > _REGEX_MAX_DEPTH) {
+        return parser_fail(parser, open);
+    }
+
+    if (parser_peek(parser, '?')) {
+        u8 on = 0;
+        u8 off = 0;
+        bool negate = false;
+
+        parser->index++;
+        for (;;) {
+            if (parser->index >= parser->length) {
+                return parser_fail(parser, parser->length);
+            }
+
+            c8 byte = parser->buffer[parser->index++];
+            if (byte == 'i' || byte == 's') {
+                u8 flag = byte == 'i' ? _FLAG_IGNORE_CASE : _FLAG_DOT_ALL;
+                *(negate ? &off : &on) |= flag;
+            } else if (byte == '-' && !negate) {
+                negate = true;
+            } else if (byte == ':') {
+                inner = (u8) ((inner | on) & ~off);
+                capture = false;
+                break;
+            } else if (byte == ')') {
+                // (?i) on its own changes the flags for the rest of the enclosing group
+                *flags = (u8) ((*flags | on) & ~off);
+                parser->depth--;
+                return parser_node(parser, _NODE_EMPTY);
+            } else {
+                return parser_fail(parser, parser->index - 1);
+            }
+        }
+    }
+
+    u32 group = capture ? (u32) parser->group_count++ : _REGEX_NONE;
+    u32 child = parse_alternation(parser, inner);
+    if (child == _REGEX_NONE) {
+        return _REGEX_NONE;
+    }
+    if (!parser_peek(parser, ')')) {
+        return parser_fail(parser, parser->length);
+    }
+    parser->index++;
+    parser->depth--;
+
+    if (!capture) {
+        return child;
+    }
+
+    u32 node = parser_node(parser, _NODE_GROUP);
+    parser->nodes[node].child = child;
+    parser->nodes[node].min = group;
+
+    return node;
+}
+
+static u32 parse_atom(RegexParser* parser, u8* flags) {
+    c8 byte = parser->buffer[parser->index];
+    u64 set[4] = {0};
+
+    switch (byte) {
+        case '(':
+            return parse_group(parser, flags);
+        case '[':
+            return parse_class(parser, *flags);
+        case '\\':
+            return parse_escape(parser, *flags);
+        case '.':
+            parser->index++;
+            set_negate(set);
+            if (!(*flags & _FLAG_DOT_ALL)) {
+                set[0] &= ~((u64) 1 << '\n');
+            }
+            return parser_set(parser, set);
+        case '^':
+            parser->index++;
+            return parser_assertion(parser, _ASSERT_START);
+        case '$':
+            parser->index++;
+            return parser_assertion(parser, _ASSERT_END);
+        case '*':
+        case '+':
+        case '?':
+            return parser_fail(parser, parser->index);
+        default:
+            parser->index++;
+            return parser_literal(parser, (u8) byte, *flags);
+    }
+}
+
+/**
+ * @return 1 and advances past a counted repetition {n}, {n,} or {n,m}, 0 if the brace does not start one and is
+ *         a literal instead, or -1 after failing on an out of range count
+ */
+static i32 parse_counted(RegexParser* parser, u32* min, u32* max) {
+    usize index = parser->index + 1;
+    usize open = parser->index;
+    u32 counts[2] = {0, 0};
+    usize digits[2] = {0, 0};
+    bool comma = false;
+
+    for (; index < parser->length; index++) {
+        c8 byte = parser->buffer[index];
+
+        if ((u8) (byte - '0') < 10) {
+            u32* count = &counts[comma];
+            if (*count > _REGEX_MAX_REPEAT) {
+                continue;
+            }
+            *count = *count * 10 + (u32) (byte - '0');
+            digits[comma]++;
+        } else if (byte == ',' && !comma) {
+            comma = true;
+        } else if (byte == '}') {
+            break;
+        } else {
+            return 0;
+        }
+    }
+
+    if (index >= parser->length || digits[0] == 0) {
+        return 0;
+    }
+
+    *min = counts[0];
+    *max = !comma ? counts[0] : digits[1] == 0 ? _REGEX_NONE : counts[1];
+    if (*min > _REGEX_MAX_REPEAT || (*max != _REGEX_NONE && (*max > _REGEX_MAX_REPEAT || *max < *min))) {
+        parser_fail(parser, open);
+        return -1;
+    }
+
+    parser->index = index + 1;
+    return 1;
+}
+
+static u32 parse_repeat(RegexParser* parser, u32 atom) {
+    if (parser->index >= parser->length) {
+        return atom;
+    }
+
+    u32 min;
+    u32 max;
+
+    switch (parser->buffer[parser->index]) {
+        case '*':
+            min = 0;
+            max = _REGEX_NONE;
+            parser->index++;
+            break;
+        case '+':
+            min = 1;
+            max = _REGEX_NONE;
+            parser->index++;
+            break;
+        case '?':
+            min = 0;
+            max = 1;
+            parser->index++;
+            break;
+        case '{': {
+            i32 counted = parse_counted(parser, &min, &max);
+            if (counted <= 0) {
+                return counted == 0 ? atom : _REGEX_NONE;
+            }
+            break;
+        }
+        default:
+            return atom;
+    }
+
+    bool greedy = true;
+    if (parser_peek(parser, '?')) {
+        greedy = false;
+        parser->index++;
+    }
+
+    // a quantifier may not follow another one, as a** or a{2}{3} would be ambiguous
+    if (parser->index < parser->length) {
+        c8 byte = parser->buffer[parser->index];
+        u32 ignored;
+        usize index = parser->index;
+        if (byte == '*' || byte == '+' || byte == '?' || (byte == '{' && parse_counted(parser, &ignored, &ignored) != 0)) {
+            return parser_fail(parser, index);
+        }
+    }
+
+    u32 node = parser_node(parser, _NODE_REPEAT);
+    parser->nodes[node].child = atom;
+    parser->nodes[node].min = min;
+    parser->nodes[node].max = max;
+    parser->nodes[node].greedy = greedy;
+
+    return node;
+}
+
+static u32 parse_concat(RegexParser* parser, u8* flags) {
+    u32 first = _REGEX_NONE;
+    u32 last = _REGEX_NONE;
+    usize count = 0;
+
+    while (parser->index < parser->length) {
+        c8 byte = parser->buffer[parser->index];
+        if (byte == '|' || byte == ')') {
+            break;
+        }
+
+        u32 atom = parse_atom(parser, flags);
+        if (atom == _REGEX_NONE) {
+            return _REGEX_NONE;
+        }
+        atom = parse_repeat(parser, atom);
+        if (atom == _REGEX_NONE) {
+            return _REGEX_NONE;
+        }
+
+        if (first == _REGEX_NONE) {
+            first = atom;
+        } else {
+            parser->nodes[last].next = atom;
+        }
+        last = atom;
+        count++;
+    }
+
+    if (count <= 1) {
+        return count == 0 ? parser_node(parser, _NODE_EMPTY) : first;
+    }
+
+    u32 node = parser_node(parser, _NODE_CONCAT);
+    parser->nodes[node].child = first;
+
+    return node;
+}
+
+static u32 parse_alternation(RegexParser* parser, u8 flags) {
+    u32 first = parse_concat(parser, &flags);
+    if (first == _REGEX_NONE || !parser_peek(parser, '|')) {
+        return first;
+    }
+
+    u32 last = first;
+    while (parser_peek(parser, '|')) {
+        parser->index++;
+        u32 branch = parse_concat(parser, &flags);
+        if (branch == _REGEX_NONE) {
+            return _REGEX_NONE;
+        }
+        parser->nodes[last].next = branch;
+        last = branch;
+    }
+
+    u32 node = parser_node(parser, _NODE_ALTERNATE);
+    parser->nodes[node].child = first;
+
+    return node;
+}
+
+// MARK: Internal (compiling)
+
+typedef struct {
+    const RegexParser* parser;
+    RegexInst* insts;
+    usize count;
+    usize capacity;
+    bool reverse;
+    bool overflow;
+} RegexCompiler;
+
+static u32 compiler_push(RegexCompiler* compiler, u8 op, u32 out, u32 arg) {
+    if (compiler->count >= _REGEX_MAX_INSTS) {
+        compiler->overflow = true;
+        return 0;
+    }
+    if (compiler->count >= compiler->capacity) {
+        compiler->capacity *= 2;
+        compiler->insts = heap_renew(compiler->insts, sizeof(RegexInst), compiler->capacity);
+    }
+
+    compiler->insts[compiler->count] = (RegexInst) {op, out, arg};
+    return (u32) compiler->count++;
+}
+
+/**
+ * @return the child nodes of a concat or alternation in order, in a heap allocated array
+ */
+static u32* compile_children(const RegexParser* parser, u32 node, usize* count) {
+    *count = 0;
+    for (u32 child = parser->nodes[node].child; child != _REGEX_NONE; child = parser->nodes[child].next) {
+        (*count)++;
+    }
+
+    u32* children = heap_many(sizeof(u32), *count);
+    usize i = 0;
+    for (u32 child = parser->nodes[node].child; child != _REGEX_NONE; child = parser->nodes[child].next) {
+        children[i++] = child;
+    }
+
+    return children;
+}
+
+/**
+ * @return true if the given node can match without consuming a byte
+ */
+static bool node_nullable(const RegexParser* parser, u32 index) {
+    const RegexNode* node = &parser->nodes[index];
+    switch (node->kind) {
+        case _NODE_SET:
+            return false;
+        case _NODE_CONCAT:
+            for (u32 child = node->child; child != _REGEX_NONE; child = parser->nodes[child].next) {
+                if (!node_nullable(parser, child)) {
+                    return false;
+                }
+            }
+            return true;
+        case _NODE_ALTERNATE:
+            for (u32 child = node->child; child != _REGEX_NONE; child = parser->nodes[child].next) {
+                if (node_nullable(parser, child)) {
+                    return true;
+                }
+            }
+            return false;
+        case _NODE_REPEAT:
+            return node->min == 0 || node_nullable(parser, node->child);
+        case _NODE_GROUP:
+            return node_nullable(parser, node->child);
+        default:
+            return true;
+    }
+}
+
+/**
+ * @return the first instruction of the given node, compiled back to front so that it continues at next
+ * @note a reverse compile emits concatenations last to first, swaps ^ and $, and drops capture slots
+ */
+static u32 compile_node(RegexCompiler* compiler, u32 index, u32 next) {
+    if (compiler->overflow) {
+        return 0;
+    }
+
+    const RegexNode node = compiler->parser->nodes[index];
+    switch (node.kind) {
+        case _NODE_EMPTY:
+            return next;
+        case _NODE_SET:
+            return compiler_push(compiler, _OP_CLASS, next, node.min);
+        case _NODE_ASSERT: {
+            u32 assertion = node.assertion;
+            if (compiler->reverse && assertion <= _ASSERT_END) {
+                assertion = assertion == _ASSERT_START ? _ASSERT_END : _ASSERT_START;
+            }
+            return compiler_push(compiler, _OP_ASSERT, next, assertion);
+        }
+        case _NODE_CONCAT: {
+            usize count;
+            u32* children = compile_children(compiler->parser, index, &count);
+            for (usize i = 0; i < count; i++) {
+                next = compile_node(compiler, children[compiler->reverse ? i : count - 1 - i], next);
+            }
+            free(children);
+            return next;
+        }
+        case _NODE_ALTERNATE: {
+            usize count;
+            u32* children = compile_children(compiler->parser, index, &count);
+            u32 branch = compile_node(compiler, children[count - 1], next);
+            for (usize i = count - 1; i > 0; i--) {
+                branch = compiler_push(compiler, _OP_SPLIT, compile_node(compiler, children[i - 1], next), branch);
+            }
+            free(children);
+            return branch;
+        }
+        case _NODE_REPEAT: {
+            u32 tail = next;
+            u32 min = node.min;
+
+            if (node.max == _REGEX_NONE) {
+                u32 loop = compiler_push(compiler, _OP_SPLIT, next, next);
+                u32 body = compile_node(compiler, node.child, loop);
+                if (compiler->overflow) {
+                    return 0;
+                }
+                compiler->insts[loop].out = node.greedy ? body : next;
+                compiler->insts[loop].arg = node.greedy ? next : body;
+                tail = loop;
+
+                // a body matching empty would loop back into a split already visited and lose its exit there, so
+                // x* is compiled as (?:x+)? and x{n,} as x{n-1}x+, where it is the second pass over the body that
+                // gets dropped instead
+                if (node_nullable(compiler->parser, node.child)) {
+                    if (min == 0) {
+                        tail = node.greedy ? compiler_push(compiler, _OP_SPLIT, body, next)
+                                           : compiler_push(compiler, _OP_SPLIT, next, body);
+                    } else {
+                        tail = body;
+                        min--;
+                    }
+                }
+            } else {
+                // x{0,2} nests as (x(x)?)?, built from the innermost optional outwards
+                for (u32 i = node.min; i < node.max; i++) {
+                    u32 body = compile_node(compiler, node.child, tail);
+                    tail = node.greedy ? compiler_push(compiler, _OP_SPLIT, body, next)
+                                       : compiler_push(compiler, _OP_SPLIT, next, body);
+                }
+            }
+
+            for (u32 i = 0; i < min; i++) {
+                tail = compile_node(compiler, node.child, tail);
+            }
+            return tail;
+        }
+        default: {
+            if (compiler->reverse) {
+                return compile_node(compiler, node.child, next);
+            }
+
+            u32 end = compiler_push(compiler, _OP_SAVE, next, node.min * 2 + 1);
+            u32 body = compile_node(compiler, node.child, end);
+            return compiler_push(compiler, _OP_SAVE, body, node.min * 2);
+        }
+    }
+}
+
+/**
+ * @return true and fills in the program, or false if it would grow past _REGEX_MAX_INSTS
+ * @note the unanchored start lazily loops over any byte before falling into the anchored start, so threads that
+ *       began earlier keep priority over ones that begin later
+ */
+static bool compile_program(RegexProgram* program, const RegexParser* parser, u32 root, bool reverse, u32 any) {
+    RegexCompiler compiler = {parser, NULL, 0, 64, reverse, false};
+    compiler.insts = heap_many(sizeof(RegexInst), compiler.capacity);
+
+    u32 match = compiler_push(&compiler, _OP_MATCH, 0, 0);
+    if (reverse) {
+        program->start_anchored = compile_node(&compiler, root, match);
+    } else {
+        u32 end = compiler_push(&compiler, _OP_SAVE, match, 1);
+        program->start_anchored = compiler_push(&compiler, _OP_SAVE, compile_node(&compiler, root, end), 0);
+    }
+
+    u32 loop = compiler_push(&compiler, _OP_SPLIT, program->start_anchored, 0);
+    u32 skip = compiler_push(&compiler, _OP_CLASS, loop, any);
+    if (compiler.overflow) {
+        free(compiler.insts);
+        return false;
+    }
+    compiler.insts[loop].arg = skip;
+
+    program->start_unanchored = loop;
+    program->insts = compiler.insts;
+    program->inst_count = compiler.count;
+    return true;
+}
+
+/**
+ * @brief splits the bytes into classes that every byte set, and \b when it is used, treats alike,
+ *        so the DFA only needs one transition per class, plus one more for the end of the str
+ */
+static void regex_compile_classes(Regex* regex) {
+    bool words = false;
+    for (usize i = 0; i < regex->forward.inst_count; i++) {
+        const RegexInst* inst = &regex->forward.insts[i];
+        words |= inst->op == _OP_ASSERT && inst->arg >= _ASSERT_WORD;
+    }
+
+    regex->classes[0] = 0;
+    regex->class_bytes[0] = 0;
+    regex->class_count = 1;
+
+    for (usize byte = 1; byte < 256; byte++) {
+        bool boundary = words && regex_is_word((u8) byte) != regex_is_word((u8) (byte - 1));
+        for (usize i = 0; i < regex->set_count && !boundary; i++) {
+            const u64* set = regex->sets + i * 4;
+            boundary = set_contains(set, (u8) byte) != set_contains(set, (u8) (byte - 1));
+        }
+
+        if (boundary) {
+            regex->class_bytes[regex->class_count++] = (u8) byte;
+        }
+        regex->classes[byte] = (u8) (regex->class_count - 1);
+    }
+
+    for (usize class = 0; class < regex->class_count; class++) {
+        regex->class_words[class] = regex_is_word(regex->class_bytes[class]);
+    }
+    regex->class_bytes[regex->class_count] = 0;
+    regex->class_words[regex->class_count] = false;
+}
+
+/**
+ * @brief finds whether every match starts at the front of the str, and the literal bytes every match starts with
+ */
+static void regex_compile_prefix(Regex* regex, const RegexParser* parser, u32 root) {
+    const RegexNode* nodes = parser->nodes;
+    u32 child = nodes[root].kind == _NODE_CONCAT ? nodes[root].child : root;
+    bool whole = true;
+
+    regex->anchored = nodes[child].kind == _NODE_ASSERT && nodes[child].assertion == _ASSERT_START;
+    regex->prefix = heap_many(sizeof(c8), parser->node_count + 1);
+    regex->prefix_length = 0;
+
+    for (; child != _REGEX_NONE; child = nodes[root].kind == _NODE_CONCAT ? nodes[child].next : _REGEX_NONE) {
+        if (nodes[child].kind != _NODE_SET) {
+            whole = false;
+            break;
+        }
+
+        const u64* set = regex->sets + (usize) nodes[child].min * 4;
+        usize count = 0;
+        for (usize i = 0; i < 4; i++) {
+            count += (usize) __builtin_popcountll(set[i]);
+        }
+        if (count != 1) {
+            whole = false;
+            break;
+        }
+
+        usize word = set[0] != 0 ? 0 : set[1] != 0 ? 1 : set[2] != 0 ? 2 : 3;
+        regex->prefix[regex->prefix_length++] = (c8) (word * 64 + (usize) __builtin_ctzll(set[word]));
+    }
+
+    regex->literal = whole && regex->prefix_length > 0;
+    StrSlice prefix = {regex->prefix, regex->prefix_length};
+    str_searcher_init(&regex->prefix_searcher, &prefix);
+}
+
+// MARK: Internal (lazy DFA)
+
+static inline usize cache_stride(const Regex* regex) {
+    return regex->class_count + 1;
+}
+
+static usize cache_memory(const Regex* regex, const RegexCache* cache, usize states, usize seeds) {
+    return states * (cache_stride(regex) * sizeof(u32) + 2 * sizeof(u32) + 1) + seeds * sizeof(u32) +
+           cache->table_capacity * sizeof(u32);
+}
+
+/**
+ * @brief appends a state without looking it up, growing the state arrays as needed
+ */
+static u32 cache_push(const Regex* regex, RegexCache* cache, const u32* seeds, usize count, u8 flags) {
+    usize stride = cache_stride(regex);
+
+    if (cache->state_count >= cache->state_capacity) {
+        cache->state_capacity = cache->state_capacity == 0 ? 16 : cache->state_capacity * 2;
+        cache->transitions = heap_renew(cache->transitions, sizeof(u32), cache->state_capacity * stride);
+        cache->flags = heap_renew(cache->flags, sizeof(u8), cache->state_capacity);
+        cache->seed_starts = heap_renew(cache->seed_starts, sizeof(u32), cache->state_capacity);
+        cache->seed_counts = heap_renew(cache->seed_counts, sizeof(u32), cache->state_capacity);
+    }
+    if (cache->seed_count + count > cache->seed_capacity) {
+        while (cache->seed_count + count > cache->seed_capacity) {
+            cache->seed_capacity = cache->seed_capacity == 0 ? 64 : cache->seed_capacity * 2;
+        }
+        cache->seeds = heap_renew(cache->seeds, sizeof(u32), cache->seed_capacity);
+    }
+
+    u32 state = (u32) cache->state_count++;
+    memset(cache->transitions + state * stride, 0xFF, sizeof(u32) * stride);
+    cache->flags[state] = flags;
+    cache->seed_starts[state] = (u32) cache->seed_count;
+    cache->seed_counts[state] = (u32) count;
+    if (count > 0) {
+        memcpy(cache->seeds + cache->seed_count, seeds, sizeof(u32) * count);
+    }
+    cache->seed_count += count;
+
+    return state;
+}
+
+/**
+ * @brief forgets every state but the two dead ones, keeping the memory around for the states still to come
+ */
+static void cache_reset(const Regex* regex, RegexCache* cache) {
+    cache->state_count = 0;
+    cache->seed_count = 0;
+    memset(cache->starts, 0xFF, sizeof(cache->starts));
+    if (cache->table != NULL) {
+        memset(cache->table, 0xFF, sizeof(u32) * cache->table_capacity);
+    }
+
+    cache_push(regex, cache, NULL, 0, 0);
+    cache_push(regex, cache, NULL, 0, _STATE_MATCH);
+}
+
+static void cache_init(const Regex* regex, RegexCache* cache, const RegexProgram* program, bool leftmost_first) {
+    memset(cache, 0, sizeof(RegexCache));
+    cache->program = program;
+    cache->leftmost_first = leftmost_first;
+    cache->stack = heap_many(sizeof(u32), program->inst_count * 2);
+    cache->list = heap_many(sizeof(u32), program->inst_count);
+    cache->next_seeds = heap_many(sizeof(u32), program->inst_count);
+    cache->marks = heap_clear(sizeof(u32), program->inst_count);
+    cache->table_capacity = 64;
+    cache->table = heap_many(sizeof(u32), cache->table_capacity);
+
+    cache_reset(regex, cache);
+}
+
+static void cache_free(RegexCache* cache) {
+    free(cache->transitions);
+    free(cache->flags);
+    free(cache->seed_starts);
+    free(cache->seed_counts);
+    free(cache->seeds);
+    free(cache->table);
+    free(cache->stack);
+    free(cache->list);
+    free(cache->next_seeds);
+    free(cache->marks);
+}
+
+/**
+ * @return a fresh generation for marks, which stands in for clearing a visited set between uses
+ */
+static u32 cache_generation(RegexCache* cache) {
+    if (++cache->generation == 0) {
+        memset(cache->marks, 0, sizeof(u32) * cache->program->inst_count);
+        cache->generation = 1;
+    }
+
+    return cache->generation;
+}
+
+static inline usize cache_hash(const u32* seeds, usize count, u8 flags) {
+    StrSlice bytes = {(const c8*) seeds, count * sizeof(u32)};
+    return (usize) str_hash64(&bytes, flags);
+}
+
+static void cache_table_insert(RegexCache* cache, u32 state, usize hash) {
+    usize mask = cache->table_capacity - 1;
+    usize slot = hash & mask;
+
+    while (cache->table[slot] != _DFA_UNKNOWN) {
+        slot = (slot + 1) & mask;
+    }
+    cache->table[slot] = state;
+}
+
+static void cache_table_grow(RegexCache* cache) {
+    cache->table_capacity *= 2;
+    free(cache->table);
+    cache->table = heap_many(sizeof(u32), cache->table_capacity);
+    memset(cache->table, 0xFF, sizeof(u32) * cache->table_capacity);
+
+    for (u32 state = _DFA_DEAD_MATCH + 1; state < cache->state_count; state++) {
+        const u32* seeds = cache->seeds + cache->seed_starts[state];
+        cache_table_insert(cache, state, cache_hash(seeds, cache->seed_counts[state], cache->flags[state] & _STATE_KEY));
+    }
+}
+
+/**
+ * @return the state made of the given seeds and flags, adding it if it is new, or _DFA_QUIT if it does not fit
+ * @note adding may clear the whole cache, which invalidates every state id the caller still holds
+ */
+static u32 cache_intern(const Regex* regex, RegexCache* cache, const u32* seeds, usize count, u8 flags) {
+    usize hash = cache_hash(seeds, count, flags);
+    usize mask = cache->table_capacity - 1;
+
+    for (usize slot = hash & mask; cache->table[slot] != _DFA_UNKNOWN; slot = (slot + 1) & mask) {
+        u32 state = cache->table[slot];
+        if ((cache->flags[state] & _STATE_KEY) == flags && cache->seed_counts[state] == count &&
+            memcmp(cache->seeds + cache->seed_starts[state], seeds, sizeof(u32) * count) == 0) {
+            return state;
+        }
+    }
+
+    if (cache_memory(regex, cache, cache->state_count + 1, cache->seed_count + count) > REGEX_CACHE_CAPACITY) {
+        if (cache->clears >= _REGEX_MAX_CLEARS) {
+            return _DFA_QUIT;
+        }
+        cache->clears++;
+        cache_reset(regex, cache);
+
+        if (cache_memory(regex, cache, cache->state_count + 1, cache->seed_count + count) > REGEX_CACHE_CAPACITY) {
+            return _DFA_QUIT;
+        }
+    }
+
+    if ((cache->state_count + 1) * 2 > cache->table_capacity) {
+        cache_table_grow(cache);
+    }
+
+    u8 start = count == 1 && seeds[0] == cache->program->start_unanchored ? _STATE_START : 0;
+    u32 state = cache_push(regex, cache, seeds, count, flags | start);
+    cache_table_insert(cache, state, hash);
+
+    return state;
+}
+
+/**
+ * @return the id the given state is stored as in transitions
+ * @note start states are only tagged when there is a prefix to skip to, so they stay on the fast path otherwise
+ */
+static u32 cache_id(const Regex* regex, const RegexCache* cache, u32 state) {
+    u32 id = state * (u32) cache_stride(regex);
+
+    if (cache->flags[state] & _STATE_MATCH) {
+        id |= _TAG_MATCH;
+    }
+    if (state <= _DFA_DEAD_MATCH) {
+        id |= _TAG_DEAD;
+    }
+    if ((cache->flags[state] & _STATE_START) && regex->prefix_length > 0) {
+        id |= _TAG_START;
+    }
+
+    return id;
+}
+
+static inline bool assertion_holds(u32 assertion, bool at_start, bool at_end, bool previous_word, bool next_word) {
+    switch (assertion) {
+        case _ASSERT_START:
+            return at_start;
+        case _ASSERT_END:
+            return at_end;
+        case _ASSERT_WORD:
+            return previous_word != next_word;
+        default:
+            return previous_word == next_word;
+    }
+}
+
+/**
+ * @return the start state for the given context, which is _STATE_TEXT_START at the front of the str,
+ *         _STATE_WORD after a word byte, or 0
+ */
+static u32 cache_start(const Regex* regex, RegexCache* cache, bool anchored, u8 context) {
+    u32* start = &cache->starts[anchored][context >> 1];
+    if (*start != _DFA_UNKNOWN) {
+        return *start;
+    }
+
+    u32 seed = anchored ? cache->program->start_anchored : cache->program->start_unanchored;
+    u32 state = cache_intern(regex, cache, &seed, 1, context);
+    if (state == _DFA_QUIT) {
+        return _DFA_QUIT;
+    }
+
+    cache->starts[anchored][context >> 1] = cache_id(regex, cache, state);
+    return cache->starts[anchored][context >> 1];
+}
+
+/**
+ * @return the state reached from the given state on the given class, computing and caching the transition
+ * @note states hold the threads waiting to read a byte before their epsilon closure, which is only taken here
+ *       once the next class is known, so \b and $ can look one byte ahead; a match found in that closure is
+ *       therefore reported by the state it leads to, one byte late
+ * @note for leftmost-first searches the closure stops at the first match, as every thread after it has lower
+ *       priority and could only ever lose to it
+ */
+static u32 cache_compute(const Regex* regex, RegexCache* cache, u32 from_id, usize class) {
+    const RegexProgram* program = cache->program;
+    u32 from = (from_id & ~_TAG_MASK) / (u32) cache_stride(regex);
+    const u32* seeds = cache->seeds + cache->seed_starts[from];
+    usize seed_count = cache->seed_counts[from];
+    u8 flags = cache->flags[from];
+    bool at_end = class == regex->class_count;
+    bool next_word = regex->class_words[class];
+    u32 generation = cache_generation(cache);
+    usize stack_count = 0;
+    usize list_count = 0;
+    bool matched = false;
+
+    for (usize i = seed_count; i > 0; i--) {
+        cache->stack[stack_count++] = seeds[i - 1];
+    }
+
+    while (stack_count > 0) {
+        u32 pc = cache->stack[--stack_count];
+
+        while (cache->marks[pc] != generation) {
+            cache->marks[pc] = generation;
+            const RegexInst* inst = &program->insts[pc];
+
+            if (inst->op == _OP_CLASS) {
+                cache->list[list_count++] = pc;
+                break;
+            } else if (inst->op == _OP_MATCH) {
+                matched = true;
+                if (cache->leftmost_first) {
+                    stack_count = 0;
+                }
+                break;
+            } else if (inst->op == _OP_SPLIT) {
+                cache->stack[stack_count++] = inst->arg;
+            } else if (inst->op == _OP_ASSERT &&
+                       !assertion_holds(inst->arg, flags & _STATE_TEXT_START, at_end, flags & _STATE_WORD, next_word)) {
+                break;
+            }
+            pc = inst->out;
+        }
+    }
+
+    usize next_count = 0;
+    if (!at_end) {
+        u8 byte = regex->class_bytes[class];
+        generation = cache_generation(cache);
+
+        for (usize i = 0; i < list_count; i++) {
+            const RegexInst* inst = &program->insts[cache->list[i]];
+            if (set_contains(regex->sets + (usize) inst->arg * 4, byte) && cache->marks[inst->out] != generation) {
+                cache->marks[inst->out] = generation;
+                cache->next_seeds[next_count++] = inst->out;
+            }
+        }
+    }
+
+    u32 next;
+    if (next_count == 0) {
+        next = matched ? _DFA_DEAD_MATCH : _DFA_DEAD;
+    } else {
+        usize clears = cache->clears;
+        u8 next_flags = (u8) ((matched ? _STATE_MATCH : 0) | (next_word ? _STATE_WORD : 0));
+        next = cache_intern(regex, cache, cache->next_seeds, next_count, next_flags);
+        if (next == _DFA_QUIT) {
+            return _DFA_QUIT;
+        }
+        if (clears != cache->clears) {
+            return cache_id(regex, cache, next);
+        }
+    }
+
+    cache->transitions[(from_id & ~_TAG_MASK) + class] = cache_id(regex, cache, next);
+    return cache->transitions[(from_id & ~_TAG_MASK) + class];
+}
+
+static inline u32 cache_next(const Regex* regex, RegexCache* cache, u32 id, usize class) {
+    u32 next = cache->transitions[(id & ~_TAG_MASK) + class];
+    return (next & _TAG_UNKNOWN) ? cache_compute(regex, cache, id, class) : next;
+}
+
+static inline u8 regex_context(const StrSlice* str, usize index) {
+    if (index == 0) {
+        return _STATE_TEXT_START;
+    }
+
+    return regex_is_word((u8) str->buffer[index - 1]) ? _STATE_WORD : 0;
+}
+
+/**
+ * @brief runs the forward DFA from start, storing where the leftmost-first match ends in end
+ * @note while the DFA sits in its unanchored start state no match is under way, so the literal prefix is skipped to
+ *       with the substring searcher instead of stepping through every byte in between
+ */
+static u8 dfa_find_end(Regex* regex, const StrSlice* str, usize start, bool anchored, bool earliest, usize* end) {
+    RegexCache* cache = &regex->forward_cache;
+    const u8* buffer = (const u8*) str->buffer;
+    bool prefilter = !anchored && regex->prefix_length > 0;
+    usize resume = start;
+    u8 result = _SEARCH_NONE;
+
+    u32 state = cache_start(regex, cache, anchored, regex_context(str, start));
+    if (state == _DFA_QUIT) {
+        return _SEARCH_QUIT;
+    }
+
+    for (usize i = start; i < str->length; i++) {
+        if ((state & _TAG_START) && prefilter && i >= resume) {
+            OptionIndex found = str_searcher_find_from(&regex->prefix_searcher, str, i);
+            if (!found.present) {
+                return result;
+            }
+
+            resume = found.value + 1;
+            if (found.value > i) {
+                i = found.value;
+                state = cache_start(regex, cache, false, regex_context(str, i));
+                if (state == _DFA_QUIT) {
+                    return _SEARCH_QUIT;
+                }
+            }
+        }
+
+        u32 next = cache->transitions[(state & ~_TAG_MASK) + regex->classes[buffer[i]]];
+        if (next & _TAG_MASK) {
+            if (next & _TAG_UNKNOWN) {
+                next = cache_compute(regex, cache, state, regex->classes[buffer[i]]);
+                if (next == _DFA_QUIT) {
+                    return _SEARCH_QUIT;
+                }
+            }
+            if (next & _TAG_MATCH) {
+                *end = i;
+                result = _SEARCH_FOUND;
+                if (earliest) {
+                    return result;
+                }
+            }
+            if (next & _TAG_DEAD) {
+                return result;
+            }
+        }
+        state = next;
+    }
+
+    state = cache_next(regex, cache, state, regex->class_count);
+    if (state == _DFA_QUIT) {
+        return _SEARCH_QUIT;
+    }
+    if (state & _TAG_MATCH) {
+        *end = str->length;
+        result = _SEARCH_FOUND;
+    }
+
+    return result;
+}
+
+/**
+ * @brief runs the reverse DFA from end back down to start, storing where the longest match ending at end starts
+ * @note as no match can start before the leftmost one, the longest match backwards is exactly the leftmost match
+ */
+static u8 dfa_find_start(Regex* regex, const StrSlice* str, usize start, usize end, usize* found) {
+    RegexCache* cache = &regex->reverse_cache;
+    const u8* buffer = (const u8*) str->buffer;
+    u8 result = _SEARCH_NONE;
+    u8 context = end == str->length ? _STATE_TEXT_START : regex_is_word(buffer[end]) ? _STATE_WORD : 0;
+
+    u32 state = cache_start(regex, cache, true, context);
+    if (state == _DFA_QUIT) {
+        return _SEARCH_QUIT;
+    }
+
+    for (usize i = end; i > start; i--) {
+        u32 next = cache->transitions[(state & ~_TAG_MASK) + regex->classes[buffer[i - 1]]];
+        if (next & _TAG_MASK) {
+            if (next & _TAG_UNKNOWN) {
+                next = cache_compute(regex, cache, state, regex->classes[buffer[i - 1]]);
+                if (next == _DFA_QUIT) {
+                    return _SEARCH_QUIT;
+                }
+            }
+            if (next & _TAG_MATCH) {
+                *found = i;
+                result = _SEARCH_FOUND;
+            }
+            if (next & _TAG_DEAD) {
+                return result;
+            }
+        }
+        state = next;
+    }
+
+    // the byte before start is only looked at, so \b and ^ see the real str
+    state = cache_next(regex, cache, state, start == 0 ? regex->class_count : regex->classes[buffer[start - 1]]);
+    if (state == _DFA_QUIT) {
+        return _SEARCH_QUIT;
+    }
+    if (state & _TAG_MATCH) {
+        *found = start;
+        result = _SEARCH_FOUND;
+    }
+
+    return result;
+}
+
+// MARK: Internal (PikeVM)
+
+typedef struct {
+    u32* dense;
+    u32* sparse;
+    usize count;
+    usize* slots;
+} PikeList;
+
+typedef struct {
+    u32 pc;
+    u32 slot;
+    usize value;
+} PikeFrame;
+
+typedef struct {
+    const Regex* regex;
+    const StrSlice* str;
+    usize slot_count;
+    PikeList lists[2];
+    PikeFrame* stack;
+    usize* slots;
+} PikeVm;
+
+static void pike_init(PikeVm* vm, const Regex* regex, const StrSlice* str) {
+    usize inst_count = regex->forward.inst_count;
+
+    vm->regex = regex;
+    vm->str = str;
+    vm->slot_count = regex->group_count * 2;
+    vm->stack = heap_many(sizeof(PikeFrame), inst_count * 2);
+    vm->slots = heap_many(sizeof(usize), vm->slot_count);
+
+    for (usize i = 0; i < 2; i++) {
+        vm->lists[i].dense = heap_many(sizeof(u32), inst_count);
+        vm->lists[i].sparse = heap_clear(sizeof(u32), inst_count);
+        vm->lists[i].slots = heap_many(sizeof(usize), inst_count * vm->slot_count);
+        vm->lists[i].count = 0;
+    }
+}
+
+static void pike_free(PikeVm* vm) {
+    for (usize i = 0; i < 2; i++) {
+        free(vm->lists[i].dense);
+        free(vm->lists[i].sparse);
+        free(vm->lists[i].slots);
+    }
+    free(vm->stack);
+    free(vm->slots);
+}
+
+static inline bool pike_contains(const PikeList* list, u32 pc) {
+    return list->sparse[pc] < list->count && list->dense[list->sparse[pc]] == pc;
+}
+
+/**
+ * @brief adds the thread at pc and everything reachable from it without reading a byte, in priority order,
+ *        each taking a copy of vm->slots as it was along the path there
+ * @note save instructions push the slot value they overwrite, which is put back once the path is explored
+ */
+static void pike_add(PikeVm* vm, PikeList* list, u32 pc, usize index) {
+    const RegexInst* insts = vm->regex->forward.insts;
+    const u8* buffer = (const u8*) vm->str->buffer;
+    usize length = vm->str->length;
+    bool previous_word = index > 0 && regex_is_word(buffer[index - 1]);
+    bool next_word = index < length && regex_is_word(buffer[index]);
+    usize stack_count = 0;
+
+    vm->stack[stack_count++] = (PikeFrame) {pc, _REGEX_NONE, 0};
+
+    while (stack_count > 0) {
+        PikeFrame frame = vm->stack[--stack_count];
+        if (frame.slot != _REGEX_NONE) {
+            vm->slots[frame.slot] = frame.value;
+            continue;
+        }
+
+        pc = frame.pc;
+        while (!pike_contains(list, pc)) {
+            list->sparse[pc] = (u32) list->count;
+            list->dense[list->count++] = pc;
+            const RegexInst* inst = &insts[pc];
+
+            if (inst->op == _OP_CLASS || inst->op == _OP_MATCH) {
+                memcpy(list->slots + pc * vm->slot_count, vm->slots, sizeof(usize) * vm->slot_count);
+                break;
+            } else if (inst->op == _OP_SPLIT) {
+                vm->stack[stack_count++] = (PikeFrame) {inst->arg, _REGEX_NONE, 0};
+            } else if (inst->op == _OP_SAVE) {
+                vm->stack[stack_count++] = (PikeFrame) {0, inst->arg, vm->slots[inst->arg]};
+                vm->slots[inst->arg] = index;
+            } else if (inst->op == _OP_ASSERT &&
+                       !assertion_holds(inst->arg, index == 0, index == length, previous_word, next_word)) {
+                break;
+            }
+            pc = inst->out;
+        }
+    }
+}
+
+/**
+ * @return true and stores the capture slots of the leftmost-first match starting at or after start in slots
+ * @note runs every thread in lockstep, so it is linear in the str like the DFA but tracks where groups begin and
+ *       end, and works in bounded memory where the DFA cache would have to give up
+ */
+static bool pike_search(const Regex* regex, const StrSlice* str, usize start, bool anchored, usize* slots) {
+    PikeVm vm;
+    pike_init(&vm, regex, str);
+    PikeList* current = &vm.lists[0];
+    PikeList* next = &vm.lists[1];
+    const u8* buffer = (const u8*) str->buffer;
+    bool matched = false;
+
+    for (usize index = start;; index++) {
+        if (!matched && (!anchored || index == start)) {
+            memset(vm.slots, 0xFF, sizeof(usize) * vm.slot_count);
+            pike_add(&vm, current, regex->forward.start_anchored, index);
+        }
+        if (current->count == 0) {
+            break;
+        }
+
+        next->count = 0;
+        for (usize i = 0; i < current->count; i++) {
+            u32 pc = current->dense[i];
+            const RegexInst* inst = &regex->forward.insts[pc];
+            const usize* thread = current->slots + pc * vm.slot_count;
+
+            if (inst->op == _OP_CLASS) {
+                if (index < str->length && set_contains(regex->sets + (usize) inst->arg * 4, buffer[index])) {
+                    memcpy(vm.slots, thread, sizeof(usize) * vm.slot_count);
+                    pike_add(&vm, next, inst->out, index + 1);
+                }
+            } else if (inst->op == _OP_MATCH) {
+                matched = true;
+                memcpy(slots, thread, sizeof(usize) * vm.slot_count);
+                break;
+            }
+        }
+
+        PikeList* swap = current;
+        current = next;
+        next = swap;
+
+        if (index >= str->length) {
+            break;
+        }
+    }
+
+    pike_free(&vm);
+    return matched;
+}
+
+// MARK: Internal (searching)
+
+/**
+ * @brief stores the leftmost-first match starting at or after start in match, running the forward DFA to find
+ *        its end and the reverse DFA to find its start, or the PikeVM once either cache gives up
+ */
+static bool regex_search(Regex* regex, const StrSlice* str, usize start, RegexMatch* match) {
+    if (start > str->length || (regex->anchored && start > 0)) {
+        return false;
+    }
+
+    if (regex->literal) {
+        OptionIndex found = str_searcher_find_from(&regex->prefix_searcher, str, start);
+        *match = (RegexMatch) {found.value, found.value + regex->prefix_length};
+        return found.present;
+    }
+
+    regex->forward_cache.clears = 0;
+    regex->reverse_cache.clears = 0;
+
+    usize end;
+    u8 result = dfa_find_end(regex, str, start, regex->anchored, false, &end);
+    if (result == _SEARCH_NONE) {
+        return false;
+    }
+
+    if (result == _SEARCH_FOUND) {
+        usize begin = start;
+        if (regex->anchored || dfa_find_start(regex, str, start, end, &begin) == _SEARCH_FOUND) {
+            *match = (RegexMatch) {begin, end};
+            return true;
+        }
+    }
+
+    usize* slots = heap_many(sizeof(usize), regex->group_count * 2);
+    bool found = pike_search(regex, str, start, regex->anchored, slots);
+    *match = (RegexMatch) {slots[0], slots[1]};
+    free(slots);
+
+    return found;
+}
+
+/**
+ * @return the compiled regex, or NULL after storing the index of the syntax error in error
+ */
+static Regex* regex_compile(const StrSlice* pattern, usize* error) {
+    RegexParser parser = {pattern->buffer, pattern->length, 0, SIZE_MAX, NULL, 0, 16, NULL, 0, 16, 1, 0};
+    parser.nodes = heap_many(sizeof(RegexNode), parser.node_capacity);
+    parser.sets = heap_many(sizeof(u64) * 4, parser.set_capacity);
+
+    u32 root = parse_alternation(&parser, 0);
+    if (root != _REGEX_NONE && parser.index < parser.length) {
+        // only an unbalanced ')' stops the top level early
+        root = parser_fail(&parser, parser.index);
+    }
+
+    // the unanchored start loops over every byte
+    u64 any[4] = {0};
+    set_negate(any);
+    u32 any_node = parser_set(&parser, any);
+    u32 any_set = parser.nodes[any_node].min;
+
+    Regex* regex = NULL;
+    if (root != _REGEX_NONE) {
+        regex = heap_one(sizeof(Regex));
+        memset(regex, 0, sizeof(Regex));
+
+        if (!compile_program(&regex->forward, &parser, root, false, any_set)) {
+            free(regex);
+            regex = NULL;
+            parser_fail(&parser, parser.length);
+        } else if (!compile_program(&regex->reverse, &parser, root, true, any_set)) {
+            free(regex->forward.insts);
+            free(regex);
+            regex = NULL;
+            parser_fail(&parser, parser.length);
+        }
+    }
+
+    if (regex != NULL) {
+        regex->sets = parser.sets;
+        regex->set_count = parser.set_count;
+        regex->group_count = parser.group_count;
+        regex_compile_classes(regex);
+        regex_compile_prefix(regex, &parser, root);
+        cache_init(regex, &regex->forward_cache, &regex->forward, true);
+        cache_init(regex, &regex->reverse_cache, &regex->reverse, false);
+    } else {
+        free(parser.sets);
+    }
+
+    *error = parser.error;
+    free(parser.nodes);
+    return regex;
+}
+
+// MARK: Lifecycle
+
+Regex* regex_new(const StrSlice* pattern) {
+    ASSERT_NONNULL(pattern);
+
+    usize error;
+    return regex_compile(pattern, &error);
+}
+
+void regex_free(Regex** regex) {
+    ASSERT_NONNULL(regex);
+    ASSERT_NONNULL(*regex);
+
+    cache_free(&(*regex)->forward_cache);
+    cache_free(&(*regex)->reverse_cache);
+    free((*regex)->forward.insts);
+    free((*regex)->reverse.insts);
+    free((*regex)->sets);
+    free((*regex)->prefix);
+    free(*regex);
+    *regex = NULL;
+}
+
+void regex_matches_free(RegexMatches** matches) {
+    ASSERT_NONNULL(matches);
+    ASSERT_NONNULL(*matches);
+
+    free((*matches)->matches);
+    free(*matches);
+    *matches = NULL;
+}
+
+// MARK: Query
+
+OptionIndex regex_syntax_error(const StrSlice* pattern) {
+    ASSERT_NONNULL(pattern);
+
+    usize error;
+    Regex* regex = regex_compile(pattern, &error);
+    if (regex == NULL) {
+        return option_index(error);
+    }
+
+    regex_free(&regex);
+    return option_index_empty();
+}
+
+bool regex_is_match(Regex* regex, const StrSlice* str) {
+    ASSERT_NONNULL(regex);
+    ASSERT_NONNULL(str);
+
+    if (regex->literal) {
+        return str_searcher_find(&regex->prefix_searcher, str).present;
+    }
+
+    regex->forward_cache.clears = 0;
+
+    usize end;
+    u8 result = dfa_find_end(regex, str, 0, regex->anchored, true, &end);
+    if (result != _SEARCH_QUIT) {
+        return result == _SEARCH_FOUND;
+    }
+
+    usize* slots = heap_many(sizeof(usize), regex->group_count * 2);
+    bool found = pike_search(regex, str, 0, regex->anchored, slots);
+    free(slots);
+
+    return found;
+}
+
+OptionRegexMatch regex_find_from(Regex* regex, const StrSlice* str, usize start) {
+    ASSERT_NONNULL(regex);
+    ASSERT_NONNULL(str);
+
+    RegexMatch match;
+    return regex_search(regex, str, start, &match) ? option_regex_match(match) : option_regex_match_empty();
+}
+
+RegexMatches* regex_find_all(Regex* regex, const StrSlice* str) {
+    ASSERT_NONNULL(regex);
+    ASSERT_NONNULL(str);
+
+    usize capacity = 8;
+    RegexMatches* matches = heap_one(sizeof(RegexMatches));
+    matches->matches = heap_many(sizeof(RegexMatch), capacity);
+    matches->count = 0;
+
+    usize start = 0;
+    RegexMatch match;
+
+    while (regex_search(regex, str, start, &match)) {
+        if (match.start == match.end && matches->count > 0 && match.end == matches->matches[matches->count - 1].end) {
+            if (start >= str->length) {
+                break;
+            }
+            start++;
+            continue;
+        }
+
+        if (matches->count >= capacity) {
+            capacity *= 2;
+            matches->matches = heap_renew(matches->matches, sizeof(RegexMatch), capacity);
+        }
+        matches->matches[matches->count++] = match;
+        start = match.end;
+    }
+
+    return matches;
+}
+
+bool regex_captures_from(Regex* regex, const StrSlice* str, usize start, OptionRegexMatch* groups) {
+    ASSERT_NONNULL(regex);
+    ASSERT_NONNULL(str);
+    ASSERT_NONNULL(groups);
+
+    RegexMatch match;
+    if (!regex_search(regex, str, start, &match)) {
+        return false;
+    }
+
+    groups[0] = option_regex_match(match);
+    if (regex->group_count == 1) {
+        return true;
+    }
+
+    // the PikeVM only has to resolve the groups of a match already known to start here
+    usize* slots = heap_many(sizeof(usize), regex->group_count * 2);
+    bool found = pike_search(regex, str, match.start, true, slots);
+    assert(found && slots[1] == match.end);
+    (void) found;
+
+    for (usize group = 1; group < regex->group_count; group++) {
+        usize first = slots[group * 2];
+        usize last = slots[group * 2 + 1];
+        groups[group] = first != SIZE_MAX && last != SIZE_MAX ? option_regex_match((RegexMatch) {first, last})
+                                                              : option_regex_match_empty();
+    }
+    free(slots);
+
+    return true;
+}
@@ -0,0 +1,190 @@
+#ifndef CTK_REGEX_H
+#define CTK_REGEX_H
+
+#include "../string/search.h"
+#include "../string/string.h"
+
+// MARK: Definition
+
+/**
+ * @brief bytes of lazily built DFA states a Regex keeps per direction before it clears them and starts over
+ * @note a search that has to clear more than a few times falls back to the PikeVM, so memory stays bounded either way
+ */
+#define REGEX_CACHE_CAPACITY (1 << 21)
+
+/**
+ * @brief One instruction of a RegexProgram, where arg is the second branch of a split, the slot of a save,
+ *        the byte set of a class or the kind of an assertion
+ */
+typedef struct {
+    u8 op;
+    u32 out;
+    u32 arg;
+} RegexInst;
+
+/**
+ * @brief A compiled Thompson NFA, run directly by the PikeVM and determinized on demand by a RegexCache
+ * @note internal to Regex, each regex holds one program running forwards and one running backwards
+ */
+typedef struct {
+    RegexInst* insts;
+    usize inst_count;
+    u32 start_anchored;
+    u32 start_unanchored;
+} RegexProgram;
+
+/**
+ * @brief Lazily built DFA over a RegexProgram, where each state is computed the first time a search needs it
+ * @note internal to Regex, states are deduplicated through an open addressed table and the whole cache is
+ *       cleared once it grows past REGEX_CACHE_CAPACITY bytes
+ */
+typedef struct {
+    const RegexProgram* program;
+    u32* transitions;
+    u8* flags;
+    u32* seed_starts;
+    u32* seed_counts;
+    usize state_count;
+    usize state_capacity;
+    u32* seeds;
+    usize seed_count;
+    usize seed_capacity;
+    u32* table;
+    usize table_capacity;
+    u32 starts[2][3];
+    bool leftmost_first;
+    usize clears;
+    u32* stack;
+    u32* list;
+    u32* next_seeds;
+    u32* marks;
+    u32 generation;
+} RegexCache;
+
+/**
+ * @brief Regular expression compiled once and matched against any number of strs without copying them
+ * @note matching is byte oriented with the leftmost-first semantics of RE2 and Go, so a repeat whose body can match
+ *       empty may end elsewhere than in Perl or Python, and supports literals, '.', classes
+ *       such as [a-z_] or [^\d], \d \w \s and their negations, \xHH, groups (...) and (?:...), alternation,
+ *       greedy and lazy * + ? {n} {n,} {n,m}, the assertions ^ $ \A \z \b \B, and the flags (?i) and (?s)
+ * @note ^ and $ only match at the very start and end of the str, and '.' matches any byte but '\n' unless (?s)
+ * @note searches run on a lazy DFA, a forward pass finding where the match ends and a reverse pass finding where
+ *       it starts, while a literal prefix every match has to begin with is skipped to with the SIMD substring search
+ * @note capture groups are resolved afterwards by a PikeVM run only over the match itself
+ * @note searching fills in the DFA caches, so a Regex must not be shared between threads while in use
+ */
+typedef struct {
+    RegexProgram forward;
+    RegexProgram reverse;
+    RegexCache forward_cache;
+    RegexCache reverse_cache;
+    u64* sets;
+    usize set_count;
+    u8 classes[256];
+    u8 class_bytes[257];
+    bool class_words[257];
+    usize class_count;
+    usize group_count;
+    bool anchored;
+    bool literal;
+    c8* prefix;
+    usize prefix_length;
+    StrSearcher prefix_searcher;
+} Regex;
+
+/**
+ * @brief A single match of a Regex, spanning the bytes [start, end) of the searched str
+ */
+typedef struct {
+    usize start;
+    usize end;
+} RegexMatch;
+
+DEFINE_OPTION(RegexMatch, RegexMatch, regex_match, ((RegexMatch) {0, 0}))
+
+/**
+ * @brief Heap allocated list of matches, ordered by start
+ */
+typedef struct {
+    RegexMatch* matches;
+    usize count;
+} RegexMatches;
+
+// MARK: Lifecycle
+
+/**
+ * @return heap allocated regex compiled from the given pattern, or NULL if the pattern is not valid
+ * @note the pattern may be freed once this returns, see regex_syntax_error() for why a pattern was rejected
+ * @note must be freed
+ */
+Regex* regex_new(const StrSlice* pattern) __attribute__((warn_unused_result)) __attribute__((nonnull(1)));
+
+/**
+ * @brief deep free of Regex* and sets pointer to NULL
+ */
+void regex_free(Regex** regex) __attribute__((nonnull(1)));
+
+/**
+ * @brief shallow free of RegexMatches and sets pointer to NULL
+ */
+void regex_matches_free(RegexMatches** matches) __attribute__((nonnull(1)));
+
+// MARK: Query
+
+/**
+ * @return the index of the first byte of the pattern that could not be parsed, or pattern->length if the pattern
+ *         ends early or compiles to a program too large to run, or an empty optional if the pattern is valid
+ */
+OptionIndex regex_syntax_error(const StrSlice* pattern) __attribute__((nonnull(1)));
+
+/**
+ * @return the number of capture groups in the regex, counting the whole match as group 0
+ */
+__attribute__((nonnull(1))) static inline usize regex_group_count(const Regex* regex) {
+    return regex->group_count;
+}
+
+/**
+ * @return true if the regex matches anywhere in the given str
+ * @note stops at the first byte a match is known to end at, without working out where it starts
+ */
+bool regex_is_match(Regex* regex, const StrSlice* str) __attribute__((nonnull(1, 2)));
+
+/**
+ * @return the leftmost-first match starting at or after start in the given str, or an empty optional if not found
+ * @note the bytes before start are still looked at by \b and \B, and ^ never matches past the front of the str
+ */
+OptionRegexMatch regex_find_from(Regex* regex, const StrSlice* str, usize start) __attribute__((nonnull(1, 2)));
+
+/**
+ * @return the leftmost-first match in the given str, or an empty optional if not found
+ */
+__attribute__((nonnull(1, 2))) static inline OptionRegexMatch regex_find(Regex* regex, const StrSlice* str) {
+    return regex_find_from(regex, str, 0);
+}
+
+/**
+ * @return a heap allocated list of every non-overlapping match in the given str, scanning left to right
+ * @note an empty match right where the previous match ended is skipped, so the scan always makes progress
+ * @note this does need to be freed
+ */
+RegexMatches* regex_find_all(Regex* regex, const StrSlice* str)
+    __attribute__((nonnull(1, 2)))
+    __attribute__((warn_unused_result));
+
+/**
+ * @return true and stores the span of every capture group of the leftmost-first match starting at or after start
+ *         in groups, or false if there is no match
+ * @note groups must hold regex_group_count() entries, and a group that took no part in the match is left empty
+ */
+bool regex_captures_from(Regex* regex, const StrSlice* str, usize start, OptionRegexMatch* groups)
+    __attribute__((nonnull(1, 2, 4)));
+
+/**
+ * @return true and stores the span of every capture group of the leftmost-first match in groups, or false
+ */
+__attribute__((nonnull(1, 2, 3))) static inline bool regex_captures(Regex* regex, const StrSlice* str, OptionRegexMatch* groups) {
+    return regex_captures_from(regex, str, 0, groups);
+}
+
+#endif
@@ -0,0 +1,409 @@
+#include "rope.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../core/memory.h"
+
+// MARK: Internal
+
+static u64 rope_count = 0;
+
+/**
+ * @return xorshift state unique to each rope, so the priorities of ropes later split and concatenated are unrelated
+ */
+static u64 rope_seed(const Rope* rope) {
+    u64 seed = (u64) (uintptr_t) rope ^ __atomic_fetch_add(&rope_count, 0x9E3779B97F4A7C15ULL, __ATOMIC_RELAXED);
+
+    // splitmix64 finalizer spreads the few bits that differ between seeds over the whole word
+    seed = (seed ^ (seed >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    seed = (seed ^ (seed >> 27)) * 0x94D049BB133111EBULL;
+    seed ^= seed >> 31;
+
+    return seed != 0 ? seed : 0x9E3779B97F4A7C15ULL;
+}
+
+static u64 rope_random(Rope* rope) {
+    rope->state ^= rope->state << 13;
+    rope->state ^= rope->state >> 7;
+    rope->state ^= rope->state << 17;
+    return rope->state;
+}
+
+static inline usize node_length(const RopeNode* node) {
+    return node != NULL ? node->length : 0;
+}
+
+static inline void node_update(RopeNode* node) {
+    node->length = node_length(node->left) + node->chunk_length + node_length(node->right);
+}
+
+static RopeNode* node_new(Rope* rope, const c8* bytes, usize length) {
+    assert(length <= ROPE_CHUNK_CAPACITY);
+
+    RopeNode* node = heap_one(sizeof(RopeNode) + ROPE_CHUNK_CAPACITY);
+    node->left = NULL;
+    node->right = NULL;
+    node->priority = rope_random(rope);
+    node->chunk_length = length;
+    node->length = length;
+    memcpy(node->chunk, bytes, length);
+
+    return node;
+}
+
+static void node_free(RopeNode* node) {
+    if (node == NULL) {
+        return;
+    }
+
+    node_free(node->left);
+    node_free(node->right);
+    free(node);
+}
+
+/**
+ * @return root of the tree holding every byte of left followed by every byte of right
+ */
+static RopeNode* node_merge(RopeNode* left, RopeNode* right) {
+    if (left == NULL) {
+        return right;
+    }
+    if (right == NULL) {
+        return left;
+    }
+
+    if (left->priority > right->priority) {
+        left->right = node_merge(left->right, right);
+        node_update(left);
+        return left;
+    }
+
+    right->left = node_merge(left, right->left);
+    node_update(right);
+    return right;
+}
+
+/**
+ * @brief splits the tree into the bytes before index and the bytes from index on
+ */
+static void node_split(Rope* rope, RopeNode* node, usize index, RopeNode** left, RopeNode** right) {
+    if (node == NULL) {
+        *left = NULL;
+        *right = NULL;
+        return;
+    }
+
+    usize left_length = node_length(node->left);
+
+    if (index <= left_length) {
+        node_split(rope, node->left, index, left, &node->left);
+        node_update(node);
+        *right = node;
+    } else if (index >= left_length + node->chunk_length) {
+        node_split(rope, node->right, index - left_length - node->chunk_length, &node->right, right);
+        node_update(node);
+        *left = node;
+    } else {
+        // index falls inside this chunk -> its tail becomes a new node in front of the right subtree
+        usize offset = index - left_length;
+        RopeNode* tail = node_new(rope, node->chunk + offset, node->chunk_length - offset);
+        RopeNode* after = node->right;
+
+        node->chunk_length = offset;
+        node->right = NULL;
+        node_update(node);
+
+        *left = node;
+        *right = node_merge(tail, after);
+    }
+}
+
+static RopeNode* node_build(Rope* rope, const c8* bytes, usize length) {
+    RopeNode* root = NULL;
+
+    for (usize i = 0; i < length; i += ROPE_CHUNK_FILL) {
+        usize chunk_length = length - i < ROPE_CHUNK_FILL ? length - i : ROPE_CHUNK_FILL;
+        root = node_merge(root, node_new(rope, bytes + i, chunk_length));
+    }
+
+    return root;
+}
+
+/**
+ * @return true if the str fit into the chunk holding index, in which case every length on the path is updated
+ */
+static bool node_insert_in_place(RopeNode* node, usize index, const StrSlice* str) {
+    if (node == NULL) {
+        return false;
+    }
+
+    usize left_length = node_length(node->left);
+    bool inserted;
+
+    if (index < left_length) {
+        inserted = node_insert_in_place(node->left, index, str);
+    } else if (index <= left_length + node->chunk_length) {
+        if (node->chunk_length + str->length > ROPE_CHUNK_CAPACITY) {
+            return false;
+        }
+
+        usize offset = index - left_length;
+        memmove(node->chunk + offset + str->length, node->chunk + offset, node->chunk_length - offset);
+        memcpy(node->chunk + offset, str->buffer, str->length);
+        node->chunk_length += str->length;
+        inserted = true;
+    } else {
+        inserted = node_insert_in_place(node->right, index - left_length - node->chunk_length, str);
+    }
+
+    if (inserted) {
+        node->length += str->length;
+    }
+
+    return inserted;
+}
+
+/**
+ * @return true if the range lay strictly inside one chunk, in which case every length on the path is updated
+ * @note a range that would empty its chunk is left to the split path, so chunks are never empty
+ */
+static bool node_delete_in_place(RopeNode* node, usize start, usize length) {
+    if (node == NULL) {
+        return false;
+    }
+
+    usize left_length = node_length(node->left);
+    bool deleted;
+
+    if (start + length <= left_length) {
+        deleted = node_delete_in_place(node->left, start, length);
+    } else if (start >= left_length + node->chunk_length) {
+        deleted = node_delete_in_place(node->right, start - left_length - node->chunk_length, length);
+    } else if (start >= left_length && start + length <= left_length + node->chunk_length && length < node->chunk_length) {
+        usize offset = start - left_length;
+        memmove(node->chunk + offset, node->chunk + offset + length, node->chunk_length - offset - length);
+        node->chunk_length -= length;
+        deleted = true;
+    } else {
+        return false;
+    }
+
+    if (deleted) {
+        node->length -= length;
+    }
+
+    return deleted;
+}
+
+/**
+ * @return the node holding the byte at index, with index rewritten to its offset inside that chunk
+ */
+static const RopeNode* node_find(const RopeNode* node, usize* index) {
+    while (node != NULL) {
+        usize left_length = node_length(node->left);
+
+        if (*index < left_length) {
+            node = node->left;
+        } else if (*index < left_length + node->chunk_length) {
+            *index -= left_length;
+            return node;
+        } else {
+            *index -= left_length + node->chunk_length;
+            node = node->right;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief pushes onto the stack of the iterator, which overwrites its oldest entry once full
+ */
+static void chunks_push(RopeChunks* chunks, const RopeNode* node) {
+    chunks->stack[chunks->top % ROPE_CHUNKS_DEPTH] = node;
+    chunks->top++;
+
+    if (chunks->count < ROPE_CHUNKS_DEPTH) {
+        chunks->count++;
+    }
+}
+
+/**
+ * @brief refills the stack with the path from the root to the chunk holding the current position
+ */
+static void chunks_seek(RopeChunks* chunks) {
+    const RopeNode* node = chunks->rope->root;
+    usize index = chunks->position;
+    chunks->top = 0;
+    chunks->count = 0;
+
+    while (node != NULL) {
+        usize left_length = node_length(node->left);
+
+        if (index < left_length) {
+            chunks_push(chunks, node);
+            node = node->left;
+        } else if (index < left_length + node->chunk_length) {
+            chunks_push(chunks, node);
+            chunks->offset = index - left_length;
+            return;
+        } else {
+            index -= left_length + node->chunk_length;
+            node = node->right;
+        }
+    }
+}
+
+// MARK: Lifecycle
+
+Rope* rope_new() {
+    Rope* rope = heap_one(sizeof(Rope));
+    rope->root = NULL;
+    rope->state = rope_seed(rope);
+
+    return rope;
+}
+
+Rope* rope_from_str(const StrSlice* str) {
+    ASSERT_NONNULL(str);
+
+    Rope* rope = rope_new();
+    rope->root = node_build(rope, str->buffer, str->length);
+
+    return rope;
+}
+
+void rope_free(Rope** rope) {
+    ASSERT_NONNULL(rope);
+    ASSERT_NONNULL(*rope);
+
+    node_free((*rope)->root);
+    free(*rope);
+    *rope = NULL;
+}
+
+// MARK: Conversions
+
+String* rope_to_string(const Rope* rope) {
+    ASSERT_NONNULL(rope);
+
+    StringMut* string_mut = string_mut_new_sized(rope_length(rope));
+    RopeChunks chunks = rope_chunks(rope);
+    StrSlice chunk;
+
+    while (rope_chunks_next(&chunks, &chunk)) {
+        string_mut_push(string_mut, &chunk);
+    }
+
+    return string_mut_to_string_owned(string_mut);
+}
+
+Rope* rope_slice(const Rope* rope, usize start, usize length) {
+    ASSERT_NONNULL(rope);
+    assert(start + length <= rope_length(rope));
+
+    Rope* slice = rope_new();
+    RopeChunks chunks = rope_chunks(rope);
+    StrSlice chunk;
+    chunks.position = start;
+    chunks.end = start + length;
+
+    while (rope_chunks_next(&chunks, &chunk)) {
+        slice->root = node_merge(slice->root, node_build(slice, chunk.buffer, chunk.length));
+    }
+
+    return slice;
+}
+
+// MARK: Query
+
+c8 rope_at(const Rope* rope, usize index) {
+    ASSERT_NONNULL(rope);
+    assert(index < rope_length(rope));
+
+    const RopeNode* node = node_find(rope->root, &index);
+
+    return node->chunk[index];
+}
+
+RopeChunks rope_chunks(const Rope* rope) {
+    ASSERT_NONNULL(rope);
+
+    return (RopeChunks) {.rope = rope, .position = 0, .end = rope_length(rope)};
+}
+
+bool rope_chunks_next(RopeChunks* chunks, StrSlice* out) {
+    ASSERT_NONNULL(chunks);
+    ASSERT_NONNULL(out);
+
+    if (chunks->position >= chunks->end) {
+        return false;
+    }
+
+    if (chunks->count == 0) {
+        // first call, or the stack overflowed on a deep path and lost the nodes above it
+        chunks_seek(chunks);
+    }
+
+    chunks->top--;
+    chunks->count--;
+    const RopeNode* node = chunks->stack[chunks->top % ROPE_CHUNKS_DEPTH];
+    usize length = node->chunk_length - chunks->offset;
+
+    if (length > chunks->end - chunks->position) {
+        length = chunks->end - chunks->position;
+    }
+
+    *out = (StrSlice) {(c8*) node->chunk + chunks->offset, length};
+    chunks->position += length;
+    chunks->offset = 0;
+
+    // in order successor is the leftmost node of the right subtree, or else the nearest ancestor still stacked
+    for (const RopeNode* next = node->right; next != NULL && chunks->position < chunks->end; next = next->left) {
+        chunks_push(chunks, next);
+    }
+
+    return true;
+}
+
+// MARK: Mutation
+
+void rope_insert(Rope* rope, usize index, const StrSlice* str) {
+    ASSERT_NONNULL(rope);
+    ASSERT_NONNULL(str);
+    assert(index <= rope_length(rope));
+
+    if (str->length == 0 || node_insert_in_place(rope->root, index, str)) {
+        return;
+    }
+
+    RopeNode* left;
+    RopeNode* right;
+    node_split(rope, rope->root, index, &left, &right);
+    rope->root = node_merge(node_merge(left, node_build(rope, str->buffer, str->length)), right);
+}
+
+void rope_delete(Rope* rope, usize start, usize length) {
+    ASSERT_NONNULL(rope);
+    assert(start + length <= rope_length(rope));
+
+    if (length == 0 || node_delete_in_place(rope->root, start, length)) {
+        return;
+    }
+
+    RopeNode* left;
+    RopeNode* middle;
+    RopeNode* right;
+    node_split(rope, rope->root, start, &left, &right);
+    node_split(rope, right, length, &middle, &right);
+    node_free(middle);
+    rope->root = node_merge(left, right);
+}
+
+void rope_concat_owned(Rope* rope, Rope* other) {
+    ASSERT_NONNULL(rope);
+    ASSERT_NONNULL(other);
+
+    rope->root = node_merge(rope->root, other->root);
+    free(other);
+}
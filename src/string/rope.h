@@ -0,0 +1,144 @@
+#ifndef CTK_ROPE_H
+#define CTK_ROPE_H
+
+#include "../string/string.h"
+
+/**
+ * @brief Bytes each rope chunk can hold, chunks built from bulk text are filled to ROPE_CHUNK_FILL
+ *        so small edits can land inside an existing chunk without restructuring the tree
+ */
+#define ROPE_CHUNK_CAPACITY 1024
+#define ROPE_CHUNK_FILL     768
+
+/**
+ * @brief Nodes a RopeChunks keeps on its own stack, deeper paths drop their top and walk down from the root again
+ */
+#define ROPE_CHUNKS_DEPTH 64
+
+// MARK: Definition
+
+typedef struct RopeNode RopeNode;
+
+struct RopeNode {
+    RopeNode* left;
+    RopeNode* right;
+    u64 priority;
+    usize length;
+    usize chunk_length;
+    c8 chunk[];
+};
+
+/**
+ * @brief Heap allocated, mutable byte sequence stored as a balanced tree of chunks
+ * @note the tree is a treap ordered by position, so insert, delete, split, concat and indexing
+ *       all run in O(log n) expected time independent of where in the text they happen
+ * @note use a plain StringMut for short or append-only text, a rope pays off for mid-buffer edits of large text
+ */
+typedef struct {
+    RopeNode* root;
+    u64 state;
+} Rope;
+
+/**
+ * @brief Stack resident iterator over the chunks of a rope, front to back
+ * @note keeps the nodes still to be visited on an explicit stack, so a full walk descends the tree once
+ * @note the rope must not be modified while iterating
+ */
+typedef struct {
+    const Rope* rope;
+    usize position;
+    usize end;
+    usize offset;
+    const RopeNode* stack[ROPE_CHUNKS_DEPTH];
+    usize top;
+    usize count;
+} RopeChunks;
+
+// MARK: Lifecycle
+
+/**
+ * @return heap allocated, empty rope
+ * @note must be freed
+ */
+Rope* rope_new() __attribute__((warn_unused_result));
+
+/**
+ * @return heap allocated rope holding a copy of the given str
+ * @note must be freed
+ */
+Rope* rope_from_str(const StrSlice* str)
+    __attribute__((warn_unused_result))
+    __attribute__((nonnull(1)));
+
+/**
+ * @brief deep free of Rope* and every chunk it holds, and sets pointer to NULL
+ */
+void rope_free(Rope** rope) __attribute__((nonnull(1)));
+
+// MARK: Conversions
+
+/**
+ * @return heap allocated string holding a copy of the whole rope
+ */
+String* rope_to_string(const Rope* rope)
+    __attribute__((warn_unused_result))
+    __attribute__((nonnull(1)));
+
+/**
+ * @return heap allocated rope holding a copy of length bytes starting at start
+ * @note the bytes are copied rather than shared with the given rope, so this costs O(log n + length)
+ */
+Rope* rope_slice(const Rope* rope, usize start, usize length)
+    __attribute__((warn_unused_result))
+    __attribute__((nonnull(1)));
+
+// MARK: Query
+
+/**
+ * @return number of bytes held by the rope
+ */
+__attribute__((nonnull(1))) static inline usize rope_length(const Rope* rope) {
+    return rope->root != NULL ? rope->root->length : 0;
+}
+
+/**
+ * @return the byte at the given index, which must be in bounds
+ */
+c8 rope_at(const Rope* rope, usize index) __attribute__((nonnull(1)));
+
+/**
+ * @return iterator over every chunk of the rope, see rope_chunks_next()
+ */
+RopeChunks rope_chunks(const Rope* rope) __attribute__((nonnull(1)));
+
+/**
+ * @return true and stores the next chunk in out, or false once every chunk has been yielded
+ * @note the first call costs O(log n) and the rest O(1) amortized, and chunks are never empty
+ */
+bool rope_chunks_next(RopeChunks* chunks, StrSlice* out) __attribute__((nonnull(1, 2)));
+
+// MARK: Mutation
+
+/**
+ * @brief inserts a copy of the given str before the byte at the given index, which may equal the length
+ */
+void rope_insert(Rope* rope, usize index, const StrSlice* str) __attribute__((nonnull(1, 3)));
+
+/**
+ * @brief appends a copy of the given str
+ */
+__attribute__((nonnull(1, 2))) static inline void rope_push(Rope* rope, const StrSlice* str) {
+    rope_insert(rope, rope_length(rope), str);
+}
+
+/**
+ * @brief removes length bytes starting at start
+ */
+void rope_delete(Rope* rope, usize start, usize length) __attribute__((nonnull(1)));
+
+/**
+ * @brief appends other onto rope without copying any bytes, freeing other
+ */
+void rope_concat_owned(Rope* rope, Rope* other) __attribute__((nonnull(1, 2)));
+
+#endif
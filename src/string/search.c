@@ -0,0 +1,1046 @@
+#include "search.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../core/memory.h"
+#include "../core/simd.h"
+
+#define _SEARCH_SHORT_NEEDLE 32
+#define _SEARCH_BYTESET_BITS (8 * sizeof(usize))
+#define _SEARCH_FOLD_WINDOW  4096
+
+// MARK: Internal
+
+static inline bool byteset_contains(const usize* byteset, u8 byte) {
+    return (byteset[byte / _SEARCH_BYTESET_BITS] >> (byte % _SEARCH_BYTESET_BITS)) & 1;
+}
+
+/**
+ * @brief computes the maximal suffix of the needle under the given byte ordering
+ * @note returns the critical position minus one (which may wrap to SIZE_MAX) and stores the period of the suffix
+ */
+static usize maximal_suffix(const u8* needle, usize length, bool reversed, usize* period) {
+    usize suffix = (usize) -1;
+    usize candidate = 0;
+    usize offset = 1;
+    *period = 1;
+
+    while (candidate + offset < length) {
+        u8 current = needle[suffix + offset];
+        u8 next = needle[candidate + offset];
+
+        if (current == next) {
+            if (offset == *period) {
+                candidate += *period;
+                offset = 1;
+            } else {
+                offset++;
+            }
+        } else if (reversed ? current < next : current > next) {
+            candidate += offset;
+            offset = 1;
+            *period = candidate - suffix;
+        } else {
+            suffix = candidate++;
+            offset = *period = 1;
+        }
+    }
+
+    return suffix;
+}
+
+/**
+ * @brief precomputes the Two-Way critical factorization and the last byte shift table for the needle
+ * @note shift entries are only written for bytes in the byteset, which guards every read, so the table is never cleared
+ * @note a distance that does not fit a u32 is stored as zero, which falls back to the plain Two-Way comparison
+ */
+static void searcher_compile(StrSearcher* searcher) {
+    const u8* needle = (const u8*) searcher->needle;
+    usize length = searcher->length;
+
+    memset(searcher->byteset, 0, sizeof(searcher->byteset));
+
+    for (usize i = 0; i < length; i++) {
+        usize distance = length - i - 1;
+        searcher->byteset[needle[i] / _SEARCH_BYTESET_BITS] |= (usize) 1 << (needle[i] % _SEARCH_BYTESET_BITS);
+        searcher->shift[needle[i]] = distance <= UINT32_MAX ? (u32) distance : 0;
+    }
+
+    if (length == 0) {
+        searcher->critical = 0;
+        searcher->period = 1;
+        searcher->memory = 0;
+        return;
+    }
+
+    usize period;
+    usize period_reversed;
+    usize critical = maximal_suffix(needle, length, false, &period);
+    usize critical_reversed = maximal_suffix(needle, length, true, &period_reversed);
+
+    if (critical_reversed + 1 > critical + 1) {
+        critical = critical_reversed;
+        period = period_reversed;
+    }
+
+    if (memcmp(needle, needle + period, critical + 1) != 0) {
+        usize left = critical;
+        usize right = length - critical - 1;
+        searcher->memory = 0;
+        searcher->period = (left + 1 > right + 1 ? left : right) + 1;
+    } else {
+        searcher->memory = length - period;
+        searcher->period = period;
+    }
+
+    searcher->critical = critical;
+}
+
+static OptionIndex two_way_find(const StrSearcher* searcher, const StrSlice* str, usize start) {
+    const u8* needle = (const u8*) searcher->needle;
+    const u8* haystack = (const u8*) str->buffer;
+    usize length = searcher->length;
+    usize critical = searcher->critical;
+    usize memory = 0;
+    usize position = start;
+
+    while (position <= str->length && str->length - position >= length) {
+        const u8* window = haystack + position;
+        u8 last = window[length - 1];
+
+        if (!byteset_contains(searcher->byteset, last)) {
+            position += length;
+            memory = 0;
+            continue;
+        }
+
+        usize skip = searcher->shift[last];
+        if (skip > 0) {
+            if (searcher->memory > 0 && memory > 0 && skip < searcher->period) {
+                skip = length - searcher->period;
+            }
+            position += skip;
+            memory = 0;
+            continue;
+        }
+
+        usize right = critical + 1 > memory ? critical + 1 : memory;
+        while (right < length && needle[right] == window[right]) {
+            right++;
+        }
+
+        if (right < length) {
+            position += right - critical;
+            memory = 0;
+            continue;
+        }
+
+        usize left = critical + 1;
+        while (left > memory && needle[left - 1] == window[left - 1]) {
+            left--;
+        }
+
+        if (left <= memory) {
+            return option_index(position);
+        }
+
+        position += searcher->period;
+        memory = searcher->memory;
+    }
+
+    return option_index_empty();
+}
+
+/**
+ * @brief checks the remaining candidates that do not fill a whole vector
+ */
+static OptionIndex filter_find_tail(const StrSearcher* searcher, const StrSlice* str, usize start) {
+    const c8* needle = searcher->needle;
+    usize length = searcher->length;
+
+    for (usize i = start; i + length <= str->length; i++) {
+        if (str->buffer[i] == needle[0] && str->buffer[i + length - 1] == needle[length - 1] &&
+            memcmp(str->buffer + i + 1, needle + 1, length - 2) == 0) {
+            return option_index(i);
+        }
+    }
+
+    return option_index_empty();
+}
+
+/**
+ * @return true once false candidates cost more than twice the bytes scanned, at which point Two-Way takes over
+ */
+static inline bool filter_over_budget(usize wasted, usize scanned) {
+    return wasted > 2 * scanned + 4096;
+}
+
+#ifdef _SIMD_X86
+_SIMD_TARGET_AVX2 static OptionIndex filter_find_avx2(const StrSearcher* searcher, const StrSlice* str, usize start, usize* resume) {
+    const c8* needle = searcher->needle;
+    usize length = searcher->length;
+    __m256i first = _mm256_set1_epi8(needle[0]);
+    __m256i last = _mm256_set1_epi8(needle[length - 1]);
+    usize wasted = 0;
+    usize i = start;
+
+    for (; i + length - 1 + 32 <= str->length; i += 32) {
+        __m256i block_first = _mm256_loadu_si256((const __m256i*) (str->buffer + i));
+        __m256i block_last = _mm256_loadu_si256((const __m256i*) (str->buffer + i + length - 1));
+        u32 mask = (u32) _mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(first, block_first), _mm256_cmpeq_epi8(last, block_last)));
+
+        while (mask != 0) {
+            usize offset = __builtin_ctz(mask);
+            if (memcmp(str->buffer + i + offset + 1, needle + 1, length - 2) == 0) {
+                return option_index(i + offset);
+            }
+            wasted += length;
+            mask &= mask - 1;
+        }
+
+        if (filter_over_budget(wasted, i + 32 - start)) {
+            *resume = i + 32;
+            return option_index_empty();
+        }
+    }
+
+    *resume = str->length;
+    return filter_find_tail(searcher, str, i);
+}
+#endif
+
+#ifdef _SIMD_SSE2
+static OptionIndex filter_find_sse2(const StrSearcher* searcher, const StrSlice* str, usize start, usize* resume) {
+    const c8* needle = searcher->needle;
+    usize length = searcher->length;
+    __m128i first = _mm_set1_epi8(needle[0]);
+    __m128i last = _mm_set1_epi8(needle[length - 1]);
+    usize wasted = 0;
+    usize i = start;
+
+    for (; i + length - 1 + 16 <= str->length; i += 16) {
+        __m128i block_first = _mm_loadu_si128((const __m128i*) (str->buffer + i));
+        __m128i block_last = _mm_loadu_si128((const __m128i*) (str->buffer + i + length - 1));
+        u32 mask = (u32) _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, block_first), _mm_cmpeq_epi8(last, block_last)));
+
+        while (mask != 0) {
+            usize offset = __builtin_ctz(mask);
+            if (memcmp(str->buffer + i + offset + 1, needle + 1, length - 2) == 0) {
+                return option_index(i + offset);
+            }
+            wasted += length;
+            mask &= mask - 1;
+        }
+
+        if (filter_over_budget(wasted, i + 16 - start)) {
+            *resume = i + 16;
+            return option_index_empty();
+        }
+    }
+
+    *resume = str->length;
+    return filter_find_tail(searcher, str, i);
+}
+#endif
+
+/**
+ * @brief runs the SIMD candidate filter for short needles, if available, and stores where it stopped in resume
+ * @note resume is left at start when no filter ran and at str->length when the filter scanned everything
+ */
+static OptionIndex filter_find(const StrSearcher* searcher, const StrSlice* str, usize start, usize* resume) {
+    *resume = start;
+
+    if (searcher->length < 2 || searcher->length > _SEARCH_SHORT_NEEDLE) {
+        return option_index_empty();
+    }
+
+#ifdef _SIMD_X86
+    if (simd_has_avx2()) {
+        return filter_find_avx2(searcher, str, start, resume);
+    }
+#endif
+#ifdef _SIMD_SSE2
+    return filter_find_sse2(searcher, str, start, resume);
+#else
+    (void) str;
+    return option_index_empty();
+#endif
+}
+
+static OptionIndex byte_find(const StrSlice* str, c8 query, usize start) {
+    usize found = start + bytes_find(str->buffer + start, str->length - start, query);
+
+    if (found >= str->length) {
+        return option_index_empty();
+    }
+
+    return option_index(found);
+}
+
+static void str_indices_push(StrIndices* indices, usize* capacity, usize index) {
+    if (indices->count >= *capacity) {
+        *capacity *= 2;
+        indices->indices = heap_renew(indices->indices, sizeof(usize), *capacity);
+    }
+
+    indices->indices[indices->count++] = index;
+}
+
+// MARK: Lifecycle
+
+StrSearcher* str_searcher_new(const StrSlice* needle) {
+    ASSERT_NONNULL(needle);
+
+    StrSearcher* searcher = heap_one(sizeof(StrSearcher));
+    c8* copy = heap_many(sizeof(c8), needle->length > 0 ? needle->length : 1);
+    memcpy(copy, needle->buffer, needle->length);
+
+    searcher->needle = copy;
+    searcher->length = needle->length;
+    searcher->owned = true;
+    searcher_compile(searcher);
+
+    return searcher;
+}
+
+void str_searcher_init(StrSearcher* searcher, const StrSlice* needle) {
+    ASSERT_NONNULL(searcher);
+    ASSERT_NONNULL(needle);
+
+    searcher->needle = needle->buffer;
+    searcher->length = needle->length;
+    searcher->owned = false;
+    searcher_compile(searcher);
+}
+
+void str_searcher_free(StrSearcher** searcher) {
+    ASSERT_NONNULL(searcher);
+    ASSERT_NONNULL(*searcher);
+
+    if ((*searcher)->owned) {
+        free((c8*) (*searcher)->needle);
+    }
+    free(*searcher);
+    *searcher = NULL;
+}
+
+void str_indices_free(StrIndices** indices) {
+    ASSERT_NONNULL(indices);
+    ASSERT_NONNULL(*indices);
+
+    free((*indices)->indices);
+    free(*indices);
+    *indices = NULL;
+}
+
+// MARK: Query
+
+OptionIndex str_searcher_find_from(const StrSearcher* searcher, const StrSlice* str, usize start) {
+    ASSERT_NONNULL(searcher);
+    ASSERT_NONNULL(str);
+
+    if (searcher->length == 0 || start > str->length || str->length - start < searcher->length) {
+        return option_index_empty();
+    }
+
+    if (searcher->length == 1) {
+        return byte_find(str, searcher->needle[0], start);
+    }
+
+    usize resume;
+    OptionIndex found = filter_find(searcher, str, start, &resume);
+
+    if (found.present || resume >= str->length) {
+        return found;
+    }
+
+    return two_way_find(searcher, str, resume);
+}
+
+StrIndices* str_searcher_find_all(const StrSearcher* searcher, const StrSlice* str) {
+    return str_searcher_find_n(searcher, str, SIZE_MAX);
+}
+
+StrIndices* str_searcher_find_n(const StrSearcher* searcher, const StrSlice* str, usize limit) {
+    ASSERT_NONNULL(searcher);
+    ASSERT_NONNULL(str);
+
+    usize capacity = 8;
+    StrIndices* indices = heap_one(sizeof(StrIndices));
+    indices->indices = heap_many(sizeof(usize), capacity);
+    indices->count = 0;
+
+    OptionIndex found = str_searcher_find_from(searcher, str, 0);
+
+    while (found.present && indices->count < limit) {
+        str_indices_push(indices, &capacity, found.value);
+        found = str_searcher_find_from(searcher, str, found.value + searcher->length);
+    }
+
+    return indices;
+}
+
+OptionIndex str_find_str(const StrSlice* str, const StrSlice* query) {
+    ASSERT_NONNULL(str);
+    ASSERT_NONNULL(query);
+
+    if (query->length == 0 || str->length < query->length) {
+        return option_index_empty();
+    }
+
+    if (query->length == 1) {
+        return byte_find(str, query->buffer[0], 0);
+    }
+
+    // The filter only needs the needle, so Two-Way tables are compiled lazily if it gives up
+    StrSearcher searcher;
+    searcher.needle = query->buffer;
+    searcher.length = query->length;
+    searcher.owned = false;
+
+    usize resume;
+    OptionIndex found = filter_find(&searcher, str, 0, &resume);
+
+    if (found.present || resume >= str->length) {
+        return found;
+    }
+
+    searcher_compile(&searcher);
+
+    return two_way_find(&searcher, str, resume);
+}
+
+StrIndices* str_find_all(const StrSlice* str, const StrSlice* query) {
+    ASSERT_NONNULL(str);
+    ASSERT_NONNULL(query);
+
+    StrSearcher searcher;
+    str_searcher_init(&searcher, query);
+
+    return str_searcher_find_all(&searcher, str);
+}
+
+OptionIndex str_find_str_ignore_case(const StrSlice* str, const StrSlice* query) {
+    ASSERT_NONNULL(str);
+    ASSERT_NONNULL(query);
+
+    if (query->length == 0 || str->length < query->length) {
+        return option_index_empty();
+    }
+
+    // the haystack is folded a window at a time, consecutive windows overlapping by one byte less than the needle
+    c8 stack_window[_SEARCH_FOLD_WINDOW];
+    c8 stack_needle[_SEARCH_FOLD_WINDOW / 2];
+    bool heap = query->length > _SEARCH_FOLD_WINDOW / 2;
+    usize window = heap ? query->length * 2 : _SEARCH_FOLD_WINDOW;
+    c8* folded = heap ? heap_many(sizeof(c8), window) : stack_window;
+    c8* folded_needle = heap ? heap_many(sizeof(c8), query->length) : stack_needle;
+    StrSlice needle = {folded_needle, query->length};
+
+    memcpy(folded_needle, query->buffer, query->length);
+    ascii_to_lower(folded_needle, query->length);
+
+    OptionIndex found = option_index_empty();
+
+    for (usize offset = 0; offset + needle.length <= str->length; offset += window - needle.length + 1) {
+        StrSlice chunk = {folded, str->length - offset < window ? str->length - offset : window};
+        memcpy(folded, str->buffer + offset, chunk.length);
+        ascii_to_lower(folded, chunk.length);
+
+        OptionIndex hit = str_find_str(&chunk, &needle);
+        if (hit.present) {
+            found = option_index(offset + hit.value);
+            break;
+        }
+    }
+
+    if (heap) {
+        free(folded);
+        free(folded_needle);
+    }
+
+    return found;
+}
+
+// MARK: Kernels
+
+static inline usize mask_nth_low(u32 mask, usize n) {
+    for (usize i = 1; i < n; i++) {
+        mask &= mask - 1;
+    }
+
+    return __builtin_ctz(mask);
+}
+
+static inline usize mask_nth_high(u32 mask, usize n) {
+    for (usize i = 1; i < n; i++) {
+        mask &= ~(0x80000000u >> __builtin_clz(mask));
+    }
+
+    return 31 - __builtin_clz(mask);
+}
+
+static usize byte_find_scalar(const c8* buffer, usize length, c8 query) {
+    for (usize i = 0; i < length; i++) {
+        if (buffer[i] == query) {
+            return i;
+        }
+    }
+
+    return length;
+}
+
+static usize byte_find_last_scalar(const c8* buffer, usize length, c8 query) {
+    for (usize i = length; i > 0; i--) {
+        if (buffer[i - 1] == query) {
+            return i - 1;
+        }
+    }
+
+    return length;
+}
+
+static usize byte_find_nth_scalar(const c8* buffer, usize length, c8 query, usize n) {
+    for (usize i = 0; i < length; i++) {
+        if (buffer[i] == query && --n == 0) {
+            return i;
+        }
+    }
+
+    return length;
+}
+
+static usize byte_find_last_nth_scalar(const c8* buffer, usize length, c8 query, usize n) {
+    for (usize i = length; i > 0; i--) {
+        if (buffer[i - 1] == query && --n == 0) {
+            return i - 1;
+        }
+    }
+
+    return length;
+}
+
+static usize byte_count_scalar(const c8* buffer, usize length, c8 query) {
+    usize count = 0;
+
+    for (usize i = 0; i < length; i++) {
+        count += buffer[i] == query;
+    }
+
+    return count;
+}
+
+static inline c8 ascii_lower(c8 byte) {
+    return byte >= 'A' && byte <= 'Z' ? (c8) (byte | 0x20) : byte;
+}
+
+/**
+ * @brief flips the case bit of every byte in [first, first + 26), which is A-Z or a-z
+ */
+static void ascii_flip_scalar(c8* buffer, usize length, c8 first) {
+    for (usize i = 0; i < length; i++) {
+        if ((u8) (buffer[i] - first) < 26) {
+            buffer[i] ^= 0x20;
+        }
+    }
+}
+
+static usize ascii_mismatch_scalar(const c8* one, const c8* two, usize length) {
+    for (usize i = 0; i < length; i++) {
+        if (ascii_lower(one[i]) != ascii_lower(two[i])) {
+            return i;
+        }
+    }
+
+    return length;
+}
+
+static usize whitespace_find_scalar(const c8* buffer, usize length, bool whitespace) {
+    for (usize i = 0; i < length; i++) {
+        if (ascii_is_whitespace(buffer[i]) == whitespace) {
+            return i;
+        }
+    }
+
+    return length;
+}
+
+static usize whitespace_find_last_scalar(const c8* buffer, usize length, bool whitespace) {
+    for (usize i = length; i > 0; i--) {
+        if (ascii_is_whitespace(buffer[i - 1]) == whitespace) {
+            return i - 1;
+        }
+    }
+
+    return length;
+}
+
+#ifdef _SIMD_X86
+_SIMD_TARGET_AVX2 static inline u32 byte_mask_avx2(const c8* buffer, __m256i query) {
+    return (u32) _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*) buffer), query));
+}
+
+_SIMD_TARGET_AVX2 static usize byte_find_avx2(const c8* buffer, usize length, c8 query) {
+    __m256i broadcast = _mm256_set1_epi8(query);
+    usize i = 0;
+
+    for (; i + 64 <= length; i += 64) {
+        u32 low = byte_mask_avx2(buffer + i, broadcast);
+        u32 high = byte_mask_avx2(buffer + i + 32, broadcast);
+        if ((low | high) != 0) {
+            return low != 0 ? i + __builtin_ctz(low) : i + 32 + __builtin_ctz(high);
+        }
+    }
+
+    for (; i + 32 <= length; i += 32) {
+        u32 mask = byte_mask_avx2(buffer + i, broadcast);
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+
+    return i + byte_find_scalar(buffer + i, length - i, query);
+}
+
+_SIMD_TARGET_AVX2 static usize byte_find_last_avx2(const c8* buffer, usize length, c8 query) {
+    __m256i broadcast = _mm256_set1_epi8(query);
+    usize i = length;
+
+    while (i >= 32) {
+        i -= 32;
+        u32 mask = byte_mask_avx2(buffer + i, broadcast);
+        if (mask != 0) {
+            return i + 31 - __builtin_clz(mask);
+        }
+    }
+
+    usize found = byte_find_last_scalar(buffer, i, query);
+    return found < i ? found : length;
+}
+
+_SIMD_TARGET_AVX2 static usize byte_find_nth_avx2(const c8* buffer, usize length, c8 query, usize n) {
+    __m256i broadcast = _mm256_set1_epi8(query);
+    usize i = 0;
+
+    for (; i + 32 <= length; i += 32) {
+        u32 mask = byte_mask_avx2(buffer + i, broadcast);
+        usize count = __builtin_popcount(mask);
+        if (count >= n) {
+            return i + mask_nth_low(mask, n);
+        }
+        n -= count;
+    }
+
+    return i + byte_find_nth_scalar(buffer + i, length - i, query, n);
+}
+
+_SIMD_TARGET_AVX2 static usize byte_find_last_nth_avx2(const c8* buffer, usize length, c8 query, usize n) {
+    __m256i broadcast = _mm256_set1_epi8(query);
+    usize i = length;
+
+    while (i >= 32) {
+        i -= 32;
+        u32 mask = byte_mask_avx2(buffer + i, broadcast);
+        usize count = __builtin_popcount(mask);
+        if (count >= n) {
+            return i + mask_nth_high(mask, n);
+        }
+        n -= count;
+    }
+
+    usize found = byte_find_last_nth_scalar(buffer, i, query, n);
+    return found < i ? found : length;
+}
+
+_SIMD_TARGET_AVX2 static usize byte_count_avx2(const c8* buffer, usize length, c8 query) {
+    __m256i broadcast = _mm256_set1_epi8(query);
+    __m256i zero = _mm256_setzero_si256();
+    __m256i totals = zero;
+    usize i = 0;
+
+    while (i + 32 <= length) {
+        // Byte counters overflow after 255 blocks, so they are widened into 64-bit lanes per batch
+        __m256i counts = zero;
+        for (usize block = 0; block < 255 && i + 32 <= length; block++, i += 32) {
+            __m256i matches = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*) (buffer + i)), broadcast);
+            counts = _mm256_sub_epi8(counts, matches);
+        }
+        totals = _mm256_add_epi64(totals, _mm256_sad_epu8(counts, zero));
+    }
+
+    usize count = (usize) _mm256_extract_epi64(totals, 0) + (usize) _mm256_extract_epi64(totals, 1) +
+                  (usize) _mm256_extract_epi64(totals, 2) + (usize) _mm256_extract_epi64(totals, 3);
+
+    return count + byte_count_scalar(buffer + i, length - i, query);
+}
+
+/**
+ * @return the given bytes with the case bit flipped on every byte in [first, first + 26)
+ * @note the bias moves that range onto the 26 lowest signed values, so one signed compare selects it
+ */
+_SIMD_TARGET_AVX2 static inline __m256i ascii_flip_avx2(__m256i bytes, c8 first) {
+    __m256i biased = _mm256_add_epi8(bytes, _mm256_set1_epi8((i8) (0x80 - first)));
+    __m256i in_range = _mm256_cmpgt_epi8(_mm256_set1_epi8(-128 + 26), biased);
+
+    return _mm256_xor_si256(bytes, _mm256_and_si256(in_range, _mm256_set1_epi8(0x20)));
+}
+
+_SIMD_TARGET_AVX2 static void ascii_flip_buffer_avx2(c8* buffer, usize length, c8 first) {
+    usize i = 0;
+
+    for (; i + 32 <= length; i += 32) {
+        __m256i bytes = _mm256_loadu_si256((const __m256i*) (buffer + i));
+        _mm256_storeu_si256((__m256i*) (buffer + i), ascii_flip_avx2(bytes, first));
+    }
+
+    ascii_flip_scalar(buffer + i, length - i, first);
+}
+
+_SIMD_TARGET_AVX2 static usize ascii_mismatch_avx2(const c8* one, const c8* two, usize length) {
+    usize i = 0;
+
+    for (; i + 32 <= length; i += 32) {
+        __m256i folded_one = ascii_flip_avx2(_mm256_loadu_si256((const __m256i*) (one + i)), 'A');
+        __m256i folded_two = ascii_flip_avx2(_mm256_loadu_si256((const __m256i*) (two + i)), 'A');
+        u32 mask = ~(u32) _mm256_movemask_epi8(_mm256_cmpeq_epi8(folded_one, folded_two));
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+
+    return i + ascii_mismatch_scalar(one + i, two + i, length - i);
+}
+
+/**
+ * @brief marks ' ' and the control characters '\t' through '\r', which sit next to each other in [9, 13]
+ * @note flip is all ones to mark the bytes that are not whitespace instead
+ */
+_SIMD_TARGET_AVX2 static inline u32 whitespace_mask_avx2(const c8* buffer, u32 flip) {
+    __m256i bytes = _mm256_loadu_si256((const __m256i*) buffer);
+    __m256i shifted = _mm256_sub_epi8(bytes, _mm256_set1_epi8('\t'));
+    __m256i control = _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, _mm256_set1_epi8('\r' - '\t')), shifted);
+    __m256i space = _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(' '));
+    return (u32) _mm256_movemask_epi8(_mm256_or_si256(control, space)) ^ flip;
+}
+
+_SIMD_TARGET_AVX2 static usize whitespace_find_avx2(const c8* buffer, usize length, bool whitespace) {
+    u32 flip = whitespace ? 0 : 0xFFFFFFFF;
+    usize i = 0;
+
+    for (; i + 32 <= length; i += 32) {
+        u32 mask = whitespace_mask_avx2(buffer + i, flip);
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+
+    return i + whitespace_find_scalar(buffer + i, length - i, whitespace);
+}
+
+_SIMD_TARGET_AVX2 static usize whitespace_find_last_avx2(const c8* buffer, usize length, bool whitespace) {
+    u32 flip = whitespace ? 0 : 0xFFFFFFFF;
+    usize i = length;
+
+    while (i >= 32) {
+        i -= 32;
+        u32 mask = whitespace_mask_avx2(buffer + i, flip);
+        if (mask != 0) {
+            return i + 31 - __builtin_clz(mask);
+        }
+    }
+
+    usize found = whitespace_find_last_scalar(buffer, i, whitespace);
+    return found < i ? found : length;
+}
+#endif
+
+#ifdef _SIMD_SSE2
+static inline u32 byte_mask_sse2(const c8* buffer, __m128i query) {
+    return (u32) _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*) buffer), query));
+}
+
+static usize byte_find_sse2(const c8* buffer, usize length, c8 query) {
+    __m128i broadcast = _mm_set1_epi8(query);
+    usize i = 0;
+
+    for (; i + 16 <= length; i += 16) {
+        u32 mask = byte_mask_sse2(buffer + i, broadcast);
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+
+    return i + byte_find_scalar(buffer + i, length - i, query);
+}
+
+static usize byte_find_last_sse2(const c8* buffer, usize length, c8 query) {
+    __m128i broadcast = _mm_set1_epi8(query);
+    usize i = length;
+
+    while (i >= 16) {
+        i -= 16;
+        u32 mask = byte_mask_sse2(buffer + i, broadcast);
+        if (mask != 0) {
+            return i + 31 - __builtin_clz(mask);
+        }
+    }
+
+    usize found = byte_find_last_scalar(buffer, i, query);
+    return found < i ? found : length;
+}
+
+static usize byte_find_nth_sse2(const c8* buffer, usize length, c8 query, usize n) {
+    __m128i broadcast = _mm_set1_epi8(query);
+    usize i = 0;
+
+    for (; i + 16 <= length; i += 16) {
+        u32 mask = byte_mask_sse2(buffer + i, broadcast);
+        usize count = __builtin_popcount(mask);
+        if (count >= n) {
+            return i + mask_nth_low(mask, n);
+        }
+        n -= count;
+    }
+
+    return i + byte_find_nth_scalar(buffer + i, length - i, query, n);
+}
+
+static usize byte_find_last_nth_sse2(const c8* buffer, usize length, c8 query, usize n) {
+    __m128i broadcast = _mm_set1_epi8(query);
+    usize i = length;
+
+    while (i >= 16) {
+        i -= 16;
+        u32 mask = byte_mask_sse2(buffer + i, broadcast);
+        usize count = __builtin_popcount(mask);
+        if (count >= n) {
+            return i + mask_nth_high(mask, n);
+        }
+        n -= count;
+    }
+
+    usize found = byte_find_last_nth_scalar(buffer, i, query, n);
+    return found < i ? found : length;
+}
+
+static usize byte_count_sse2(const c8* buffer, usize length, c8 query) {
+    __m128i broadcast = _mm_set1_epi8(query);
+    __m128i zero = _mm_setzero_si128();
+    __m128i totals = zero;
+    usize i = 0;
+
+    while (i + 16 <= length) {
+        __m128i counts = zero;
+        for (usize block = 0; block < 255 && i + 16 <= length; block++, i += 16) {
+            counts = _mm_sub_epi8(counts, _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*) (buffer + i)), broadcast));
+        }
+        totals = _mm_add_epi64(totals, _mm_sad_epu8(counts, zero));
+    }
+
+    usize count = (usize) _mm_cvtsi128_si64(totals) + (usize) _mm_cvtsi128_si64(_mm_unpackhi_epi64(totals, totals));
+
+    return count + byte_count_scalar(buffer + i, length - i, query);
+}
+
+static inline __m128i ascii_flip_sse2(__m128i bytes, c8 first) {
+    __m128i biased = _mm_add_epi8(bytes, _mm_set1_epi8((i8) (0x80 - first)));
+    __m128i in_range = _mm_cmplt_epi8(biased, _mm_set1_epi8(-128 + 26));
+
+    return _mm_xor_si128(bytes, _mm_and_si128(in_range, _mm_set1_epi8(0x20)));
+}
+
+static void ascii_flip_buffer_sse2(c8* buffer, usize length, c8 first) {
+    usize i = 0;
+
+    for (; i + 16 <= length; i += 16) {
+        __m128i bytes = _mm_loadu_si128((const __m128i*) (buffer + i));
+        _mm_storeu_si128((__m128i*) (buffer + i), ascii_flip_sse2(bytes, first));
+    }
+
+    ascii_flip_scalar(buffer + i, length - i, first);
+}
+
+static usize ascii_mismatch_sse2(const c8* one, const c8* two, usize length) {
+    usize i = 0;
+
+    for (; i + 16 <= length; i += 16) {
+        __m128i folded_one = ascii_flip_sse2(_mm_loadu_si128((const __m128i*) (one + i)), 'A');
+        __m128i folded_two = ascii_flip_sse2(_mm_loadu_si128((const __m128i*) (two + i)), 'A');
+        u32 mask = ~(u32) _mm_movemask_epi8(_mm_cmpeq_epi8(folded_one, folded_two)) & 0xFFFF;
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+
+    return i + ascii_mismatch_scalar(one + i, two + i, length - i);
+}
+
+static inline u32 whitespace_mask_sse2(const c8* buffer, u32 flip) {
+    __m128i bytes = _mm_loadu_si128((const __m128i*) buffer);
+    __m128i shifted = _mm_sub_epi8(bytes, _mm_set1_epi8('\t'));
+    __m128i control = _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8('\r' - '\t')), shifted);
+    __m128i space = _mm_cmpeq_epi8(bytes, _mm_set1_epi8(' '));
+    return ((u32) _mm_movemask_epi8(_mm_or_si128(control, space)) ^ flip) & 0xFFFF;
+}
+
+static usize whitespace_find_sse2(const c8* buffer, usize length, bool whitespace) {
+    u32 flip = whitespace ? 0 : 0xFFFF;
+    usize i = 0;
+
+    for (; i + 16 <= length; i += 16) {
+        u32 mask = whitespace_mask_sse2(buffer + i, flip);
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+
+    return i + whitespace_find_scalar(buffer + i, length - i, whitespace);
+}
+
+static usize whitespace_find_last_sse2(const c8* buffer, usize length, bool whitespace) {
+    u32 flip = whitespace ? 0 : 0xFFFF;
+    usize i = length;
+
+    while (i >= 16) {
+        i -= 16;
+        u32 mask = whitespace_mask_sse2(buffer + i, flip);
+        if (mask != 0) {
+            return i + 31 - __builtin_clz(mask);
+        }
+    }
+
+    usize found = whitespace_find_last_scalar(buffer, i, whitespace);
+    return found < i ? found : length;
+}
+#endif
+
+usize bytes_find(const c8* buffer, usize length, c8 query) {
+#ifdef _SIMD_X86
+    if (simd_has_avx2()) {
+        return byte_find_avx2(buffer, length, query);
+    }
+#endif
+#ifdef _SIMD_SSE2
+    return byte_find_sse2(buffer, length, query);
+#else
+    return byte_find_scalar(buffer, length, query);
+#endif
+}
+
+usize bytes_find_last(const c8* buffer, usize length, c8 query) {
+#ifdef _SIMD_X86
+    if (simd_has_avx2()) {
+        return byte_find_last_avx2(buffer, length, query);
+    }
+#endif
+#ifdef _SIMD_SSE2
+    return byte_find_last_sse2(buffer, length, query);
+#else
+    return byte_find_last_scalar(buffer, length, query);
+#endif
+}
+
+usize bytes_find_nth(const c8* buffer, usize length, c8 query, usize n) {
+    assert(n > 0);
+
+#ifdef _SIMD_X86
+    if (simd_has_avx2()) {
+        return byte_find_nth_avx2(buffer, length, query, n);
+    }
+#endif
+#ifdef _SIMD_SSE2
+    return byte_find_nth_sse2(buffer, length, query, n);
+#else
+    return byte_find_nth_scalar(buffer, length, query, n);
+#endif
+}
+
+usize bytes_find_last_nth(const c8* buffer, usize length, c8 query, usize n) {
+    assert(n > 0);
+
+#ifdef _SIMD_X86
+    if (simd_has_avx2()) {
+        return byte_find_last_nth_avx2(buffer, length, query, n);
+    }
+#endif
+#ifdef _SIMD_SSE2
+    return byte_find_last_nth_sse2(buffer, length, query, n);
+#else
+    return byte_find_last_nth_scalar(buffer, length, query, n);
+#endif
+}
+
+usize bytes_count(const c8* buffer, usize length, c8 query) {
+#ifdef _SIMD_X86
+    if (simd_has_avx2()) {
+        return byte_count_avx2(buffer, length, query);
+    }
+#endif
+#ifdef _SIMD_SSE2
+    return byte_count_sse2(buffer, length, query);
+#else
+    return byte_count_scalar(buffer, length, query);
+#endif
+}
+
+static void ascii_flip(c8* buffer, usize length, c8 first) {
+#ifdef _SIMD_X86
+    if (simd_has_avx2()) {
+        ascii_flip_buffer_avx2(buffer, length, first);
+        return;
+    }
+#endif
+#ifdef _SIMD_SSE2
+    ascii_flip_buffer_sse2(buffer, length, first);
+#else
+    ascii_flip_scalar(buffer, length, first);
+#endif
+}
+
+void ascii_to_lower(c8* buffer, usize length) {
+    ascii_flip(buffer, length, 'A');
+}
+
+void ascii_to_upper(c8* buffer, usize length) {
+    ascii_flip(buffer, length, 'a');
+}
+
+usize ascii_mismatch_ignore_case(const c8* one, const c8* two, usize length) {
+#ifdef _SIMD_X86
+    if (simd_has_avx2()) {
+        return ascii_mismatch_avx2(one, two, length);
+    }
+#endif
+#ifdef _SIMD_SSE2
+    return ascii_mismatch_sse2(one, two, length);
+#else
+    return ascii_mismatch_scalar(one, two, length);
+#endif
+}
+
+usize ascii_whitespace_find(const c8* buffer, usize length, bool whitespace) {
+#ifdef _SIMD_X86
+    if (simd_has_avx2()) {
+        return whitespace_find_avx2(buffer, length, whitespace);
+    }
+#endif
+#ifdef _SIMD_SSE2
+    return whitespace_find_sse2(buffer, length, whitespace);
+#else
+    return whitespace_find_scalar(buffer, length, whitespace);
+#endif
+}
+
+usize ascii_whitespace_find_last(const c8* buffer, usize length, bool whitespace) {
+#ifdef _SIMD_X86
+    if (simd_has_avx2()) {
+        return whitespace_find_last_avx2(buffer, length, whitespace);
+    }
+#endif
+#ifdef _SIMD_SSE2
+    return whitespace_find_last_sse2(buffer, length, whitespace);
+#else
+    return whitespace_find_last_scalar(buffer, length, whitespace);
+#endif
+}
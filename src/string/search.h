@@ -0,0 +1,172 @@
+#ifndef CTK_SEARCH_H
+#define CTK_SEARCH_H
+
+#include "../string/string.h"
+
+// MARK: Definition
+
+/**
+ * @brief Substring searcher compiled once from a needle and reused across any number of haystacks
+ * @note short needles are located with a SIMD filter on their first and last byte, long needles and
+ *       adversarial haystacks fall back to Two-Way, which keeps every search linear in the haystack
+ * @note an empty needle never matches, mirroring str_contains()
+ */
+typedef struct {
+    const c8* needle;
+    usize length;
+    bool owned;
+    usize critical;
+    usize period;
+    usize memory;
+    usize byteset[256 / (8 * sizeof(usize))];
+    u32 shift[256];
+} StrSearcher;
+
+/**
+ * @brief Heap allocated list of byte offsets into an existing string
+ */
+typedef struct {
+    usize* indices;
+    usize count;
+} StrIndices;
+
+// MARK: Lifecycle
+
+/**
+ * @return heap allocated searcher holding its own copy of the given needle
+ * @note must be freed
+ */
+StrSearcher* str_searcher_new(const StrSlice* needle)
+    __attribute__((warn_unused_result))
+    __attribute__((nonnull(1)));
+
+/**
+ * @brief initializes a stack allocated searcher that borrows the given needle
+ * @note the needle must outlive the searcher, which does not need to be freed
+ */
+void str_searcher_init(StrSearcher* searcher, const StrSlice* needle) __attribute__((nonnull(1, 2)));
+
+/**
+ * @brief deep free of StrSearcher* and sets pointer to NULL
+ */
+void str_searcher_free(StrSearcher** searcher) __attribute__((nonnull(1)));
+
+/**
+ * @brief shallow free of StrIndices and sets pointer to NULL
+ */
+void str_indices_free(StrIndices** indices) __attribute__((nonnull(1)));
+
+// MARK: Query
+
+/**
+ * @return the first index at or after start where the needle occurs in the given str, or an empty optional if not found
+ */
+OptionIndex str_searcher_find_from(const StrSearcher* searcher, const StrSlice* str, usize start)
+    __attribute__((nonnull(1, 2)));
+
+/**
+ * @return the first index where the needle occurs in the given str, or an empty optional if not found
+ */
+__attribute__((nonnull(1, 2))) static inline OptionIndex str_searcher_find(const StrSearcher* searcher, const StrSlice* str) {
+    return str_searcher_find_from(searcher, str, 0);
+}
+
+/**
+ * @return a heap allocated list of every non-overlapping index where the needle occurs, scanning left to right
+ * @note this does need to be freed
+ */
+StrIndices* str_searcher_find_all(const StrSearcher* searcher, const StrSlice* str)
+    __attribute__((nonnull(1, 2)))
+    __attribute__((warn_unused_result));
+
+/**
+ * @return a heap allocated list of at most limit non-overlapping indices where the needle occurs, scanning left to right
+ * @note this does need to be freed
+ */
+StrIndices* str_searcher_find_n(const StrSearcher* searcher, const StrSlice* str, usize limit)
+    __attribute__((nonnull(1, 2)))
+    __attribute__((warn_unused_result));
+
+/**
+ * @return the first index of the given query str in the given str, or an empty optional if not found
+ * @note to search for the same query many times, compile it once with str_searcher_new()
+ */
+OptionIndex str_find_str(const StrSlice* str, const StrSlice* query) __attribute__((nonnull(1, 2)));
+
+/**
+ * @return a heap allocated list of every non-overlapping index of the given query str in the given str
+ * @note this does need to be freed
+ */
+StrIndices* str_find_all(const StrSlice* str, const StrSlice* query)
+    __attribute__((nonnull(1, 2)))
+    __attribute__((warn_unused_result));
+
+/**
+ * @return the first index of the given query str in the given str ignoring ASCII case, or an empty optional if not found
+ * @note only A-Z and a-z are folded, every other byte must match exactly
+ */
+OptionIndex str_find_str_ignore_case(const StrSlice* str, const StrSlice* query) __attribute__((nonnull(1, 2)));
+
+// MARK: Kernels
+
+/**
+ * @return index of the first byte equal to query, or length if there is none
+ * @note vectorized byte kernels backing str_find() and friends, usable on any buffer with full 64-bit lengths
+ */
+usize bytes_find(const c8* buffer, usize length, c8 query);
+
+/**
+ * @return index of the last byte equal to query, or length if there is none
+ */
+usize bytes_find_last(const c8* buffer, usize length, c8 query);
+
+/**
+ * @return index of the nth (starting at 1) byte equal to query from the front, or length if there are fewer
+ */
+usize bytes_find_nth(const c8* buffer, usize length, c8 query, usize n);
+
+/**
+ * @return index of the nth (starting at 1) byte equal to query from the back, or length if there are fewer
+ */
+usize bytes_find_last_nth(const c8* buffer, usize length, c8 query, usize n);
+
+/**
+ * @return number of bytes equal to query
+ */
+usize bytes_count(const c8* buffer, usize length, c8 query);
+
+/**
+ * @brief rewrites every ASCII uppercase letter in the buffer as lowercase, leaving all other bytes untouched
+ */
+void ascii_to_lower(c8* buffer, usize length);
+
+/**
+ * @brief rewrites every ASCII lowercase letter in the buffer as uppercase, leaving all other bytes untouched
+ */
+void ascii_to_upper(c8* buffer, usize length);
+
+/**
+ * @return index of the first position where the buffers differ once ASCII letters are folded to lowercase, or length
+ */
+usize ascii_mismatch_ignore_case(const c8* one, const c8* two, usize length);
+
+/**
+ * @return whether the byte is ASCII whitespace: ' ', '\t', '\n', '\v', '\f' or '\r', the same set as isspace() in the C locale
+ */
+static inline bool ascii_is_whitespace(c8 byte) {
+    return byte == ' ' || (u8) (byte - '\t') <= '\r' - '\t';
+}
+
+/**
+ * @return index of the first byte that is whitespace when whitespace is true, or that is not when it is false,
+ *         or length if there is none
+ */
+usize ascii_whitespace_find(const c8* buffer, usize length, bool whitespace);
+
+/**
+ * @return index of the last byte that is whitespace when whitespace is true, or that is not when it is false,
+ *         or length if there is none
+ */
+usize ascii_whitespace_find_last(const c8* buffer, usize length, bool whitespace);
+
+#endif
@@ -0,0 +1,350 @@
+#include "split.h"
+#include <assert.h>
+#include <string.h>
+#include "../core/memory.h"
+#include "../core/simd.h"
+#include "search.h"
+
+#define _SPLIT_BYTE       0
+#define _SPLIT_STR        1
+#define _SPLIT_SET        2
+#define _SPLIT_WHITESPACE 3
+
+// MARK: Internal
+
+/**
+ * @note bytes below 0x80 live in set_low and the rest in set_high, each row indexed by the low nibble
+ *       holding one bit per high nibble, which is the layout a pshufb based lookup needs
+ */
+static inline bool set_contains(const StrSplitIter* iter, u8 byte) {
+    const u8* rows = byte < 0x80 ? iter->set_low : iter->set_high;
+    return (rows[byte & 0x0F] >> ((byte >> 4) & 7)) & 1;
+}
+
+static usize set_find_scalar(const StrSplitIter* iter, usize start, usize end) {
+    for (usize i = start; i < end; i++) {
+        if (set_contains(iter, (u8) iter->buffer[i])) {
+            return i;
+        }
+    }
+
+    return end;
+}
+
+static usize set_find_last_scalar(const StrSplitIter* iter, usize start, usize end) {
+    for (usize i = end; i > start; i--) {
+        if (set_contains(iter, (u8) iter->buffer[i - 1])) {
+            return i - 1;
+        }
+    }
+
+    return end;
+}
+
+#ifdef _SIMD_X86
+_SIMD_TARGET_AVX2 static inline u32 set_mask_avx2(const c8* buffer, __m256i low, __m256i high, __m256i columns) {
+    __m256i bytes = _mm256_loadu_si256((const __m256i*) buffer);
+    __m256i flipped = _mm256_xor_si256(bytes, _mm256_set1_epi8((i8) 0x80));
+    __m256i rows = _mm256_or_si256(_mm256_shuffle_epi8(low, bytes), _mm256_shuffle_epi8(high, flipped));
+    __m256i nibbles = _mm256_and_si256(_mm256_srli_epi16(bytes, 4), _mm256_set1_epi8(0x0F));
+    __m256i hits = _mm256_and_si256(rows, _mm256_shuffle_epi8(columns, nibbles));
+
+    return ~(u32) _mm256_movemask_epi8(_mm256_cmpeq_epi8(hits, _mm256_setzero_si256()));
+}
+
+_SIMD_TARGET_AVX2 static inline void set_tables_avx2(const StrSplitIter* iter, __m256i* low, __m256i* high, __m256i* columns) {
+    static const u8 bits[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+
+    *low = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*) iter->set_low));
+    *high = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*) iter->set_high));
+    *columns = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*) bits));
+}
+
+_SIMD_TARGET_AVX2 static usize set_find_avx2(const StrSplitIter* iter, usize start, usize end) {
+    __m256i low;
+    __m256i high;
+    __m256i columns;
+    set_tables_avx2(iter, &low, &high, &columns);
+    usize i = start;
+
+    for (; i + 32 <= end; i += 32) {
+        u32 mask = set_mask_avx2(iter->buffer + i, low, high, columns);
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+
+    return set_find_scalar(iter, i, end);
+}
+
+_SIMD_TARGET_AVX2 static usize set_find_last_avx2(const StrSplitIter* iter, usize start, usize end) {
+    __m256i low;
+    __m256i high;
+    __m256i columns;
+    set_tables_avx2(iter, &low, &high, &columns);
+    usize i = end;
+
+    while (i - start >= 32) {
+        i -= 32;
+        u32 mask = set_mask_avx2(iter->buffer + i, low, high, columns);
+        if (mask != 0) {
+            return i + 31 - __builtin_clz(mask);
+        }
+    }
+
+    usize found = set_find_last_scalar(iter, start, i);
+    return found < i ? found : end;
+}
+#endif
+
+static usize str_find_last_in(const StrSplitIter* iter, usize start, usize end) {
+    usize length = iter->delimiter.length;
+    c8 last = iter->delimiter.buffer[length - 1];
+    usize limit = end;
+
+    // candidates are anchored on the last delimiter byte, then verified in full
+    while (limit - start >= length) {
+        usize first = start + length - 1;
+        usize found = bytes_find_last(iter->buffer + first, limit - first, last);
+        if (found >= limit - first) {
+            break;
+        }
+
+        usize candidate = first + found - (length - 1);
+        if (memcmp(iter->buffer + candidate, iter->delimiter.buffer, length) == 0) {
+            return candidate;
+        }
+        limit = first + found;
+    }
+
+    return end;
+}
+
+static inline usize split_delimiter_length(const StrSplitIter* iter) {
+    return iter->kind == _SPLIT_STR ? iter->delimiter.length : 1;
+}
+
+/**
+ * @return index of the first delimiter in [start, end), or end if there is none
+ */
+static usize split_find(const StrSplitIter* iter, usize start, usize end) {
+    switch (iter->kind) {
+        case _SPLIT_BYTE:
+            return start + bytes_find(iter->buffer + start, end - start, iter->byte);
+        case _SPLIT_WHITESPACE:
+            return start + ascii_whitespace_find(iter->buffer + start, end - start, true);
+        case _SPLIT_STR: {
+            StrSlice window = {iter->buffer + start, end - start};
+            OptionIndex found = str_find_str(&window, &iter->delimiter);
+            return found.present ? start + found.value : end;
+        }
+        default:
+#ifdef _SIMD_X86
+            if (simd_has_avx2()) {
+                return set_find_avx2(iter, start, end);
+            }
+#endif
+            return set_find_scalar(iter, start, end);
+    }
+}
+
+/**
+ * @return index of the last delimiter in [start, end), or end if there is none
+ */
+static usize split_find_last(const StrSplitIter* iter, usize start, usize end) {
+    switch (iter->kind) {
+        case _SPLIT_BYTE: {
+            usize found = bytes_find_last(iter->buffer + start, end - start, iter->byte);
+            return start + found;
+        }
+        case _SPLIT_WHITESPACE:
+            return start + ascii_whitespace_find_last(iter->buffer + start, end - start, true);
+        case _SPLIT_STR:
+            if (iter->delimiter.length == 0) {
+                return end;
+            }
+            return str_find_last_in(iter, start, end);
+        default:
+#ifdef _SIMD_X86
+            if (simd_has_avx2()) {
+                return set_find_last_avx2(iter, start, end);
+            }
+#endif
+            return set_find_last_scalar(iter, start, end);
+    }
+}
+
+/**
+ * @return true if a whole delimiter starts at the given index and fits before end
+ */
+static bool split_delimiter_at(const StrSplitIter* iter, usize index, usize end) {
+    switch (iter->kind) {
+        case _SPLIT_BYTE:
+            return index < end && iter->buffer[index] == iter->byte;
+        case _SPLIT_WHITESPACE:
+            return index < end && ascii_is_whitespace(iter->buffer[index]);
+        case _SPLIT_STR:
+            return iter->delimiter.length > 0 && end - index >= iter->delimiter.length &&
+                   memcmp(iter->buffer + index, iter->delimiter.buffer, iter->delimiter.length) == 0;
+        default:
+            return index < end && set_contains(iter, (u8) iter->buffer[index]);
+    }
+}
+
+/**
+ * @brief steps over a whole run of whitespace on the near side in one pass, rather than one empty field per byte
+ */
+static void split_skip_whitespace(StrSplitIter* iter) {
+    usize length = iter->end - iter->start;
+
+    if (!iter->reverse) {
+        iter->start += ascii_whitespace_find(iter->buffer + iter->start, length, false);
+        return;
+    }
+
+    usize last = ascii_whitespace_find_last(iter->buffer + iter->start, length, false);
+    iter->end = last < length ? iter->start + last + 1 : iter->start;
+}
+
+static StrSplitIter split_iter_init(const StrSlice* str, u8 kind) {
+    StrSplitIter iter;
+    memset(&iter, 0, sizeof(StrSplitIter));
+    iter.buffer = str->buffer;
+    iter.end = str->length;
+    iter.kind = kind;
+    iter.remaining = SIZE_MAX;
+
+    return iter;
+}
+
+// MARK: Lifecycle
+
+StrSplitIter str_split_iter(const StrSlice* str, c8 delimiter) {
+    ASSERT_NONNULL(str);
+
+    StrSplitIter iter = split_iter_init(str, _SPLIT_BYTE);
+    iter.byte = delimiter;
+
+    return iter;
+}
+
+StrSplitIter str_split_str_iter(const StrSlice* str, const StrSlice* delimiter) {
+    ASSERT_NONNULL(str);
+    ASSERT_NONNULL(delimiter);
+
+    StrSplitIter iter = split_iter_init(str, _SPLIT_STR);
+    iter.delimiter = *delimiter;
+
+    return iter;
+}
+
+StrSplitIter str_split_any_iter(const StrSlice* str, const StrSlice* set) {
+    ASSERT_NONNULL(str);
+    ASSERT_NONNULL(set);
+
+    StrSplitIter iter = split_iter_init(str, _SPLIT_SET);
+
+    for (usize i = 0; i < set->length; i++) {
+        u8 byte = (u8) set->buffer[i];
+        u8* rows = byte < 0x80 ? iter.set_low : iter.set_high;
+        rows[byte & 0x0F] |= (u8) (1 << ((byte >> 4) & 7));
+    }
+
+    return iter;
+}
+
+StrSplitIter str_split_whitespace_iter(const StrSlice* str) {
+    ASSERT_NONNULL(str);
+
+    return split_iter_init(str, _SPLIT_WHITESPACE);
+}
+
+void str_split_iter_keep_empty(StrSplitIter* iter) {
+    ASSERT_NONNULL(iter);
+
+    iter->keep_empty = true;
+}
+
+void str_split_iter_reverse(StrSplitIter* iter) {
+    ASSERT_NONNULL(iter);
+
+    iter->reverse = true;
+}
+
+void str_split_iter_limit(StrSplitIter* iter, usize count) {
+    ASSERT_NONNULL(iter);
+
+    iter->remaining = count;
+}
+
+// MARK: Query
+
+bool str_split_iter_next(StrSplitIter* iter, StrSlice* out) {
+    ASSERT_NONNULL(iter);
+    ASSERT_NONNULL(out);
+
+    usize delimiter_length = split_delimiter_length(iter);
+
+    while (!iter->finished && iter->remaining > 0) {
+        StrSlice field;
+
+        if (iter->kind == _SPLIT_WHITESPACE && !iter->keep_empty) {
+            split_skip_whitespace(iter);
+        }
+
+        if (iter->remaining == 1) {
+            // last field -> hand back everything left, past any delimiters on the near side
+            while (!iter->keep_empty && !iter->reverse && split_delimiter_at(iter, iter->start, iter->end)) {
+                iter->start += delimiter_length;
+            }
+            while (!iter->keep_empty && iter->reverse && iter->end - iter->start >= delimiter_length &&
+                   split_delimiter_at(iter, iter->end - delimiter_length, iter->end)) {
+                iter->end -= delimiter_length;
+            }
+            field = (StrSlice) {iter->buffer + iter->start, iter->end - iter->start};
+            iter->finished = true;
+        } else if (!iter->reverse) {
+            usize found = split_find(iter, iter->start, iter->end);
+            field = (StrSlice) {iter->buffer + iter->start, found - iter->start};
+
+            if (found == iter->end) {
+                iter->finished = true;
+            } else {
+                iter->start = found + delimiter_length;
+            }
+        } else {
+            usize found = split_find_last(iter, iter->start, iter->end);
+
+            if (found == iter->end) {
+                field = (StrSlice) {iter->buffer + iter->start, iter->end - iter->start};
+                iter->finished = true;
+            } else {
+                field = (StrSlice) {iter->buffer + found + delimiter_length, iter->end - found - delimiter_length};
+                iter->end = found;
+            }
+        }
+
+        if (field.length == 0 && !iter->keep_empty) {
+            continue;
+        }
+
+        if (iter->remaining != SIZE_MAX) {
+            iter->remaining--;
+        }
+
+        *out = field;
+        return true;
+    }
+
+    return false;
+}
+
+StrSlice str_split_iter_remainder(const StrSplitIter* iter) {
+    ASSERT_NONNULL(iter);
+
+    if (iter->finished || iter->remaining == 0) {
+        return (StrSlice) {iter->buffer + iter->end, 0};
+    }
+
+    return (StrSlice) {iter->buffer + iter->start, iter->end - iter->start};
+}
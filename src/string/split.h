@@ -0,0 +1,90 @@
+#ifndef CTK_SPLIT_H
+#define CTK_SPLIT_H
+
+#include "../string/string.h"
+
+// MARK: Definition
+
+/**
+ * @brief Lazy, stack resident iterator over the fields of a str separated by a byte, a str, a set of bytes, or whitespace
+ * @note fields are slices into the original str, so iterating never allocates and the str must outlive the iterator
+ * @note empty fields are skipped by default, mirroring str_split_slices(), see str_split_iter_keep_empty()
+ * @note configure with keep_empty(), reverse() and limit() before the first call to next()
+ */
+typedef struct {
+    const c8* buffer;
+    usize start;
+    usize end;
+    u8 kind;
+    c8 byte;
+    StrSlice delimiter;
+    u8 set_low[16];
+    u8 set_high[16];
+    bool keep_empty;
+    bool reverse;
+    bool finished;
+    usize remaining;
+} StrSplitIter;
+
+// MARK: Lifecycle
+
+/**
+ * @return iterator over the fields of the given str separated by the given delimiter byte
+ */
+StrSplitIter str_split_iter(const StrSlice* str, c8 delimiter) __attribute__((nonnull(1)));
+
+/**
+ * @return iterator over the fields of the given str separated by every instance of the given delimiter str
+ * @note the delimiter must outlive the iterator, and an empty delimiter yields the whole str as one field
+ */
+StrSplitIter str_split_str_iter(const StrSlice* str, const StrSlice* delimiter) __attribute__((nonnull(1, 2)));
+
+/**
+ * @return iterator over the fields of the given str separated by any one of the bytes in the given set
+ * @note the set is compiled into a 32 byte lookup table, so it does not need to outlive the iterator
+ */
+StrSplitIter str_split_any_iter(const StrSlice* str, const StrSlice* set) __attribute__((nonnull(1, 2)));
+
+/**
+ * @return iterator over the words of the given str, separated by runs of ASCII whitespace (' ', '\t', '\n', '\v', '\f', '\r')
+ * @note whitespace is classified 16 or 32 bytes at a time with SSE2 or AVX2, and a whole run between two words is
+ *       skipped in one pass, so with keep_empty() every single whitespace byte delimits a field instead
+ */
+StrSplitIter str_split_whitespace_iter(const StrSlice* str) __attribute__((nonnull(1)));
+
+/**
+ * @brief yields empty fields between adjacent delimiters and at either end instead of skipping them
+ */
+void str_split_iter_keep_empty(StrSplitIter* iter) __attribute__((nonnull(1)));
+
+/**
+ * @brief yields fields from the back of the str to the front (rsplit)
+ */
+void str_split_iter_reverse(StrSplitIter* iter) __attribute__((nonnull(1)));
+
+/**
+ * @brief yields at most count fields, the last of which is the unsplit remainder of the str (splitn)
+ */
+void str_split_iter_limit(StrSplitIter* iter, usize count) __attribute__((nonnull(1)));
+
+// MARK: Query
+
+/**
+ * @return true and stores the next field in out, or false once the iterator is exhausted
+ */
+bool str_split_iter_next(StrSplitIter* iter, StrSlice* out) __attribute__((nonnull(1, 2)));
+
+/**
+ * @return true and stores the next field in out without consuming it, or false if the iterator is exhausted
+ */
+__attribute__((nonnull(1, 2))) static inline bool str_split_iter_peek(const StrSplitIter* iter, StrSlice* out) {
+    StrSplitIter copy = *iter;
+    return str_split_iter_next(&copy, out);
+}
+
+/**
+ * @return the part of the str that has not been yielded yet
+ */
+StrSlice str_split_iter_remainder(const StrSplitIter* iter) __attribute__((nonnull(1)));
+
+#endif
@@ -3,26 +3,80 @@
 #include <stdlib.h>
 #include <string.h>
 #include "../core/memory.h"
+#include "search.h"
 
-// MARK: Lifecycle
-
-String* string_new(const c8* cstr_literal) {
-    ASSERT_NONNULL(cstr_literal);
+// MARK: Internal
 
+static String* string_with_length(usize length) {
     String* string = heap_one(sizeof(String));
-    string->length = strlen(cstr_literal);
 
-    if (string->length > 0) {
-        string->buffer = heap_many(sizeof(c8), string->length);
-        memcpy(string->buffer, cstr_literal, string->length);
+    if (length <= STRING_INLINE_CAPACITY) {
+        string->small.tag = _STRING_INLINE_TAG(length);
     } else {
-        string->buffer = heap_many(sizeof(c8), 1);
-        string->buffer[0] = '\0';
+        string->heap.buffer = heap_many(sizeof(c8), length);
+        string->heap.length = length;
+        string->heap.capacity = _STRING_HEAP_CAPACITY(length);
     }
 
     return string;
 }
 
+static String* string_from_bytes(const c8* bytes, usize length) {
+    String* string = string_with_length(length);
+    memcpy(string_buffer(string), bytes, length);
+
+    return string;
+}
+
+static StringMut* string_mut_with_capacity(usize capacity) {
+    StringMut* string_mut = heap_one(sizeof(StringMut));
+    string_mut_init(string_mut, capacity);
+
+    return string_mut;
+}
+
+static StringMut* string_mut_from_bytes(const c8* bytes, usize length) {
+    StringMut* string_mut = string_mut_with_capacity(length);
+    memcpy(string_mut_buffer(string_mut), bytes, length);
+    string_mut_set_length(string_mut, length);
+
+    return string_mut;
+}
+
+static usize replaced_length(usize length, const StrIndices* matches, usize query_length, usize replacement_length) {
+    return length - matches->count * query_length + matches->count * replacement_length;
+}
+
+/**
+ * @brief copies str into output, swapping the query at each of the given match indices for the replacement
+ * @note output must hold exactly replaced_length() bytes
+ */
+static void replace_copy(c8* output, const StrSlice* str, const StrIndices* matches, usize query_length, const StrSlice* replacement) {
+    usize read = 0;
+
+    for (usize i = 0; i < matches->count; i++) {
+        usize run = matches->indices[i] - read;
+        memcpy(output, str->buffer + read, run);
+        memcpy(output + run, replacement->buffer, replacement->length);
+        output += run + replacement->length;
+        read = matches->indices[i] + query_length;
+    }
+
+    memcpy(output, str->buffer + read, str->length - read);
+}
+
+// MARK: Lifecycle
+
+String* string_new(const c8* cstr_literal) {
+    ASSERT_NONNULL(cstr_literal);
+
+    return string_from_bytes(cstr_literal, strlen(cstr_literal));
+}
+
+String* string_new_sized(usize length) {
+    return string_with_length(length);
+}
+
 CString* cstring_new(const c8* cstr_literal) {
     ASSERT_NONNULL(cstr_literal);
 
@@ -35,18 +89,7 @@ CString* cstring_new(const c8* cstr_literal) {
 }
 
 StringMut* string_mut_new_sized(usize initial_capacity) {
-    StringMut* string_mut = heap_one(sizeof(StringMut));
-    string_mut->length = 0;
-
-    if (initial_capacity > 0) {
-        string_mut->capacity = initial_capacity;
-    } else {
-        string_mut->capacity = 1;
-    }
-
-    string_mut->buffer = heap_many(sizeof(c8), string_mut->capacity);
-
-    return string_mut;
+    return string_mut_with_capacity(initial_capacity);
 }
 
 CStringMut* cstring_mut_new_sized(usize initial_capacity) {
@@ -68,19 +111,7 @@ CStringMut* cstring_mut_new_sized(usize initial_capacity) {
 StringMut* string_mut_new(const c8* cstr_literal) {
     ASSERT_NONNULL(cstr_literal);
 
-    StringMut* string_mut = heap_one(sizeof(StringMut));
-    string_mut->length = strlen(cstr_literal);
-
-    if (string_mut->length > 0) {
-        string_mut->buffer = heap_many(sizeof(c8), string_mut->length);
-        string_mut->capacity = string_mut->length;
-        memcpy(string_mut->buffer, cstr_literal, string_mut->length);
-    } else {
-        string_mut->buffer = heap_many(sizeof(c8), 1);
-        string_mut->capacity = 1;
-    }
-
-    return string_mut;
+    return string_mut_from_bytes(cstr_literal, strlen(cstr_literal));
 }
 
 CStringMut* cstring_mut_new(const c8* cstr_literal) {
@@ -98,17 +129,7 @@ CStringMut* cstring_mut_new(const c8* cstr_literal) {
 String* string_clone(const String* string) {
     ASSERT_NONNULL(string);
 
-    String* duplicate = heap_one(sizeof(String));
-    duplicate->length = string->length;
-
-    if (string->length > 0) {
-        duplicate->buffer = heap_many(sizeof(c8), string->length);
-        memcpy(duplicate->buffer, string->buffer, string->length);
-    } else {
-        duplicate->buffer = heap_many(sizeof(c8), 1);
-    }
-
-    return duplicate;
+    return string_from_bytes(string_buffer(string), string_length(string));
 }
 
 CString* cstring_clone(const CString* cstring) {
@@ -125,17 +146,9 @@ CString* cstring_clone(const CString* cstring) {
 StringMut* string_mut_clone(const StringMut* string_mut) {
     ASSERT_NONNULL(string_mut);
 
-    StringMut* duplicate = heap_one(sizeof(StringMut));
-    duplicate->length = string_mut->length;
-    duplicate->capacity = string_mut->capacity;
-
-    if (string_mut->capacity > 0) {
-        duplicate->buffer = heap_many(sizeof(c8), string_mut->capacity);
-        memcpy(duplicate->buffer, string_mut->buffer, string_mut->capacity);
-    } else {
-        duplicate->buffer = heap_many(sizeof(c8), 1);
-        duplicate->buffer[0] = '\0';
-    }
+    StringMut* duplicate = string_mut_with_capacity(string_mut_capacity(string_mut));
+    memcpy(string_mut_buffer(duplicate), string_mut_buffer(string_mut), string_mut_length(string_mut));
+    string_mut_set_length(duplicate, string_mut_length(string_mut));
 
     return duplicate;
 }
@@ -153,23 +166,37 @@ CStringMut* cstring_mut_clone(const CStringMut* cstring_mut) {
     return duplicate;
 }
 
+String* str_to_owned(const StrSlice* str) {
+    ASSERT_NONNULL(str);
+
+    return string_from_bytes(str->buffer, str->length);
+}
+
 StringMut* str_to_owned_mut(const StrSlice* str) {
     ASSERT_NONNULL(str);
 
-    StringMut* string_mut = heap_one(sizeof(StringMut));
-    string_mut->length = str->length;
+    return string_mut_from_bytes(str->buffer, str->length);
+}
+
+String* string_mut_to_string_owned(StringMut* string_mut) {
+    ASSERT_NONNULL(string_mut);
 
-    if (string_mut->length > 0) {
-        string_mut->buffer = heap_many(sizeof(c8), string_mut->length);
-        string_mut->capacity = string_mut->length;
-        memcpy(string_mut->buffer, str->buffer, string_mut->length);
+    String* string;
+
+    if (_STRING_IS_HEAP(string_mut->small.tag) && string_mut->heap.length > STRING_INLINE_CAPACITY) {
+        // same layout -> the heap buffer, length and capacity carry over as they are
+        string = heap_one(sizeof(String));
+        string->heap.buffer = string_mut->heap.buffer;
+        string->heap.length = string_mut->heap.length;
+        string->heap.capacity = string_mut->heap.capacity;
     } else {
-        string_mut->buffer = heap_many(sizeof(c8), 1);
-        string_mut->capacity = 1;
-        string_mut->buffer[0] = '\0';
+        string = string_from_bytes(string_mut_buffer(string_mut), string_mut_length(string_mut));
+        string_mut_deinit(string_mut);
     }
 
-    return string_mut;
+    free(string_mut);
+
+    return string;
 }
 
 CStringMut* cstr_to_owned_mut(const CStrSlice* cstr) {
@@ -188,7 +215,9 @@ void string_free(String** string) {
     ASSERT_NONNULL(string);
     ASSERT_NONNULL(*string);
 
-    free((*string)->buffer);
+    if (_STRING_IS_HEAP((*string)->small.tag)) {
+        free((*string)->heap.buffer);
+    }
     free(*string);
     *string = NULL;
 }
@@ -206,11 +235,32 @@ void string_mut_free(StringMut** string_mut) {
     ASSERT_NONNULL(string_mut);
     ASSERT_NONNULL(*string_mut);
 
-    free((*string_mut)->buffer);
+    string_mut_deinit(*string_mut);
     free(*string_mut);
     *string_mut = NULL;
 }
 
+void string_mut_init(StringMut* string_mut, usize initial_capacity) {
+    ASSERT_NONNULL(string_mut);
+
+    if (initial_capacity <= STRING_INLINE_CAPACITY) {
+        string_mut->small.tag = _STRING_INLINE_TAG(0);
+    } else {
+        string_mut->heap.buffer = heap_many(sizeof(c8), initial_capacity);
+        string_mut->heap.length = 0;
+        string_mut->heap.capacity = _STRING_HEAP_CAPACITY(initial_capacity);
+    }
+}
+
+void string_mut_deinit(StringMut* string_mut) {
+    ASSERT_NONNULL(string_mut);
+
+    if (_STRING_IS_HEAP(string_mut->small.tag)) {
+        free(string_mut->heap.buffer);
+    }
+    string_mut->small.tag = _STRING_INLINE_TAG(0);
+}
+
 void cstring_mut_free(CStringMut** cstring_mut) {
     ASSERT_NONNULL(cstring_mut);
     ASSERT_NONNULL(*cstring_mut);
@@ -263,68 +313,90 @@ i32 str_compare(const StrSlice* one, const StrSlice* two) {
     return -1;
 }
 
+bool str_equals_ignore_case(const StrSlice* one, const StrSlice* two) {
+    ASSERT_NONNULL(one);
+    ASSERT_NONNULL(two);
+
+    if (one->length != two->length) {
+        return false;
+    }
+
+    return ascii_mismatch_ignore_case(one->buffer, two->buffer, one->length) == one->length;
+}
+
+i32 str_compare_ignore_case(const StrSlice* one, const StrSlice* two) {
+    ASSERT_NONNULL(one);
+    ASSERT_NONNULL(two);
+
+    usize length = one->length < two->length ? one->length : two->length;
+    usize mismatch = ascii_mismatch_ignore_case(one->buffer, two->buffer, length);
+
+    if (mismatch < length) {
+        u8 byte_one = (u8) one->buffer[mismatch];
+        u8 byte_two = (u8) two->buffer[mismatch];
+        byte_one |= byte_one >= 'A' && byte_one <= 'Z' ? 0x20 : 0;
+        byte_two |= byte_two >= 'A' && byte_two <= 'Z' ? 0x20 : 0;
+        return (i32) byte_one - (i32) byte_two;
+    }
+
+    if (one->length == two->length) {
+        return 0;
+    }
+
+    return one->length > two->length ? 1 : -1;
+}
+
 // MARK: Query
 
-String* str_replace(const StrSlice* str, const StrSlice* query, const StrSlice* replacement) {
+String* str_replace_n(const StrSlice* str, const StrSlice* query, const StrSlice* replacement, usize n) {
     ASSERT_NONNULL(str);
     ASSERT_NONNULL(query);
     ASSERT_NONNULL(replacement);
 
-    StringMut* string_mut = string_mut_new_sized(str->length);
+    StrSearcher searcher;
+    str_searcher_init(&searcher, query);
+    StrIndices* matches = str_searcher_find_n(&searcher, str, n);
 
-    for (usize i = 0; i < str->length; i++) {
-        for (usize j = 0; j < query->length; j++) {
-            if (str->buffer[i + j] != query->buffer[j]) {
-                string_mut_push_char(string_mut, str->buffer[i]);
-                break;
-            }
+    String* string = string_with_length(replaced_length(str->length, matches, query->length, replacement->length));
+    replace_copy(string_buffer(string), str, matches, query->length, replacement);
+    str_indices_free(&matches);
 
-            if (j >= query->length - 1) {
-                (void) replacement;
-                string_mut_push(string_mut, replacement);
-                i += query->length - 1;
-            }
-        }
-    }
+    return string;
+}
 
-    String* moved = heap_one(sizeof(String));
-    moved->length = string_mut->length;
-    moved->buffer = string_mut->buffer;
-    free(string_mut);
+String* str_replace(const StrSlice* str, const StrSlice* query, const StrSlice* replacement) {
+    return str_replace_n(str, query, replacement, SIZE_MAX);
+}
 
-    return moved;
+String* str_replace_first(const StrSlice* str, const StrSlice* query, const StrSlice* replacement) {
+    return str_replace_n(str, query, replacement, 1);
 }
 
-CString* cstr_replace(const CStrSlice* cstr, const CStrSlice* query, const CStrSlice* replacement) {
+CString* cstr_replace_n(const CStrSlice* cstr, const CStrSlice* query, const CStrSlice* replacement, usize n) {
     ASSERT_NONNULL(cstr);
     ASSERT_NONNULL(query);
     ASSERT_NONNULL(replacement);
 
-    CStringMut* cstring_mut = cstring_mut_new_sized(cstr->length);
-
-    for (usize i = 0; i < cstr->length; i++) {
-        for (usize j = 0; j < query->length; j++) {
-            if (cstr->buffer[i + j] != query->buffer[j]) {
-                cstring_mut_push_char(cstring_mut, cstr->buffer[i]);
-                break;
-            }
+    StrSearcher searcher;
+    str_searcher_init(&searcher, (const StrSlice*) query);
+    StrIndices* matches = str_searcher_find_n(&searcher, (const StrSlice*) cstr, n);
 
-            if (j >= query->length - 1) {
-                (void) replacement;
-                cstring_mut_push(cstring_mut, replacement);
-                i += query->length - 1;
-            }
-        }
-    }
+    CString* cstring = heap_one(sizeof(CString));
+    cstring->length = replaced_length(cstr->length, matches, query->length, replacement->length);
+    cstring->buffer = heap_many(sizeof(c8), cstring->length + 1);
+    replace_copy(cstring->buffer, (const StrSlice*) cstr, matches, query->length, (const StrSlice*) replacement);
+    cstring->buffer[cstring->length] = '\0';
+    str_indices_free(&matches);
 
-    cstring_mut->buffer[cstring_mut->length] = '\0';
+    return cstring;
+}
 
-    CString* moved = heap_one(sizeof(CString));
-    moved->length = cstring_mut->length;
-    moved->buffer = cstring_mut->buffer;
-    free(cstring_mut);
+CString* cstr_replace(const CStrSlice* cstr, const CStrSlice* query, const CStrSlice* replacement) {
+    return cstr_replace_n(cstr, query, replacement, SIZE_MAX);
+}
 
-    return moved;
+CString* cstr_replace_first(const CStrSlice* cstr, const CStrSlice* query, const CStrSlice* replacement) {
+    return cstr_replace_n(cstr, query, replacement, 1);
 }
 
 StrSlice str_sub_slice(const StrSlice* str, usize start, usize length) {
@@ -336,6 +408,31 @@ StrSlice str_sub_slice(const StrSlice* str, usize start, usize length) {
         length};
 }
 
+StrSlice str_trim(const StrSlice* str) {
+    ASSERT_NONNULL(str);
+
+    StrSlice start = str_trim_start(str);
+    return str_trim_end(&start);
+}
+
+StrSlice str_trim_start(const StrSlice* str) {
+    ASSERT_NONNULL(str);
+
+    usize start = ascii_whitespace_find(str->buffer, str->length, false);
+    return (StrSlice) {
+        str->buffer + start,
+        str->length - start};
+}
+
+StrSlice str_trim_end(const StrSlice* str) {
+    ASSERT_NONNULL(str);
+
+    usize last = ascii_whitespace_find_last(str->buffer, str->length, false);
+    return (StrSlice) {
+        str->buffer,
+        last < str->length ? last + 1 : 0};
+}
+
 StrSlices* str_split_slices(const StrSlice* str, c8 delimiter) {
     ASSERT_NONNULL(str);
 
@@ -352,11 +449,9 @@ StrSlices* str_split_slices(const StrSlice* str, c8 delimiter) {
     usize slice_index = 0;
     usize current = 0;
 
-    for (usize i = 0; i < str->length + 1; i++) {
-        if (i < str->length && str->buffer[i] != delimiter) {
-            continue;
-        }
-        if (i > 0 && i - current > 0) {
+    while (current <= str->length) {
+        usize i = current + bytes_find(str->buffer + current, str->length - current, delimiter);
+        if (i > current) {
             if (slice_index > capacity - 1) {
                 slices->slices = heap_renew(slices->slices, sizeof(StrSlice), capacity * 2);
                 capacity *= 2;
@@ -385,141 +480,152 @@ bool str_contains(const StrSlice* str, const StrSlice* query) {
     ASSERT_NONNULL(str);
     ASSERT_NONNULL(query);
 
-    if (str->length < query->length || query->length == 0) {
-        return false;
-    }
+    return str_find_str(str, query).present;
+}
 
-    for (usize i = 0; i < str->length - query->length + 1; i++) {
-        for (usize j = 0; j < query->length; j++) {
-            if (str->buffer[i + j] != query->buffer[j]) {
-                break;
-            }
-            if (j == query->length - 1) {
-                return true;
-            }
-        }
-    }
+bool str_contains_ignore_case(const StrSlice* str, const StrSlice* query) {
+    ASSERT_NONNULL(str);
+    ASSERT_NONNULL(query);
 
-    return false;
+    return str_find_str_ignore_case(str, query).present;
 }
 
 bool str_contains_char(const StrSlice* str, c8 query) {
     ASSERT_NONNULL(str);
 
-    for (usize i = 0; i < str->length; i++) {
-        if (str->buffer[i] == query) {
-            return true;
-        }
+    return bytes_find(str->buffer, str->length, query) < str->length;
+}
+
+usize str_count_char(const StrSlice* str, c8 query) {
+    ASSERT_NONNULL(str);
+
+    return bytes_count(str->buffer, str->length, query);
+}
+
+static OptionIndex index_or_empty(usize index, usize length) {
+    if (index >= length) {
+        return option_index_empty();
     }
 
-    return false;
+    return option_index(index);
 }
 
 OptionIndex str_find(const StrSlice* str, c8 query) {
     ASSERT_NONNULL(str);
 
-    for (usize i = 0; i < str->length; i++) {
-        if (str->buffer[i] == query) {
-            return option_index(i);
-        }
-    }
-
-    return option_index_empty();
+    return index_or_empty(bytes_find(str->buffer, str->length, query), str->length);
 }
 
 OptionIndex str_find_last(const StrSlice* str, c8 query) {
     ASSERT_NONNULL(str);
 
-    for (i32 i = (i32) str->length - 1; i >= 0; i--) {
-        if (str->buffer[i] == query) {
-            return option_index((usize) i);
-        }
-    }
-
-    return option_index_empty();
+    return index_or_empty(bytes_find_last(str->buffer, str->length, query), str->length);
 }
 
 OptionIndex str_find_nth(const StrSlice* str, c8 query, usize n) {
     ASSERT_NONNULL(str);
-    usize current = 0;
 
-    for (usize i = 0; i < str->length; i++) {
-        if (str->buffer[i] == query) {
-            if (++current >= n) {
-                return option_index(i);
-            }
-        }
-    }
-
-    return option_index_empty();
+    return index_or_empty(bytes_find_nth(str->buffer, str->length, query, n > 0 ? n : 1), str->length);
 }
 
 OptionIndex str_find_last_nth(const StrSlice* str, c8 query, usize n) {
     ASSERT_NONNULL(str);
-    usize current = 0;
 
-    for (i32 i = (i32) str->length - 1; i >= 0; i--) {
-        if (str->buffer[i] == query) {
-            if (++current >= n) {
-                return option_index((usize) i);
-            }
-        }
-    }
-
-    return option_index_empty();
+    return index_or_empty(bytes_find_last_nth(str->buffer, str->length, query, n > 0 ? n : 1), str->length);
 }
 
 // MARK: Mutation
 
-void string_mut_replace(StringMut* string_mut, const StrSlice* query, const StrSlice* replacer) {
+void string_mut_replace_n(StringMut* string_mut, const StrSlice* query, const StrSlice* replacer, usize n) {
     ASSERT_NONNULL(string_mut);
     ASSERT_NONNULL(query);
     ASSERT_NONNULL(replacer);
 
-    if (query->length <= 0 || string_mut->length < query->length || string_mut->length == 0 || query->length == 0) {
+    if (query->length == 0 || string_mut_length(string_mut) < query->length || n == 0) {
         return;
     }
 
-    StringMut* new_string = string_mut_new_sized(string_mut->length);
+    const c8* bytes = string_mut_buffer(string_mut);
 
-    for (usize i = 0; i < string_mut->length; i++) {
-        usize last_match = 0;
+    if (replacer->buffer >= bytes && replacer->buffer < bytes + string_mut_capacity(string_mut)) {
+        // replacer borrows from the buffer being rewritten -> replace with a copy of it instead
+        String* copy = string_from_bytes(replacer->buffer, replacer->length);
+        StrSlice copy_slice = string_as_slice(copy);
+        string_mut_replace_n(string_mut, query, &copy_slice, n);
+        string_free(&copy);
+        return;
+    }
 
-        for (usize j = 0; j < query->length; j++) {
-            if (i + j >= string_mut->length || (string_mut->buffer[i + j] != query->buffer[j])) {
-                // no match found at index -> push existing string segment
-                usize added_index = 0;
-                do {
-                    string_mut_push_char(new_string, string_mut->buffer[i + added_index]);
-                    added_index++;
-                } while (added_index < last_match);
+    StrSearcher searcher;
+    str_searcher_init(&searcher, query);
+    StrSlice current = string_mut_as_slice(string_mut);
 
-                break;
-            }
+    if (query->length == replacer->length) {
+        // same length -> overwrite each match without moving the rest of the string
+        OptionIndex found = str_searcher_find_from(&searcher, &current, 0);
 
-            if (j >= query->length - 1) {
-                // full match -> push replacer
-                string_mut_push(new_string, replacer);
-                i += query->length - 1;
-            }
+        for (usize replaced = 0; found.present && replaced < n; replaced++) {
+            memcpy(string_mut_buffer(string_mut) + found.value, replacer->buffer, replacer->length);
+            found = str_searcher_find_from(&searcher, &current, found.value + query->length);
+        }
+
+        return;
+    }
+
+    StrIndices* matches = str_searcher_find_n(&searcher, &current, n);
+    usize length = replaced_length(current.length, matches, query->length, replacer->length);
+
+    if (replacer->length < query->length) {
+        // shrinking -> compact front to back, writes never overtake unread bytes
+        c8* buffer = string_mut_buffer(string_mut);
+        usize read = 0;
+        usize write = 0;
+
+        for (usize i = 0; i < matches->count; i++) {
+            usize run = matches->indices[i] - read;
+            memmove(buffer + write, buffer + read, run);
+            memcpy(buffer + write + run, replacer->buffer, replacer->length);
+            write += run + replacer->length;
+            read = matches->indices[i] + query->length;
+        }
 
-            // character matched -> not necessarily full match
-            last_match++;
+        memmove(buffer + write, buffer + read, current.length - read);
+    } else {
+        // growing -> reserve once and shift back to front, writes never overtake unread bytes
+        string_mut_reserve(string_mut, length - current.length);
+        c8* buffer = string_mut_buffer(string_mut);
+        usize read = current.length;
+        usize write = length;
+
+        for (usize i = matches->count; i > 0; i--) {
+            usize end = matches->indices[i - 1] + query->length;
+            write -= read - end;
+            memmove(buffer + write, buffer + end, read - end);
+            write -= replacer->length;
+            memcpy(buffer + write, replacer->buffer, replacer->length);
+            read = matches->indices[i - 1];
         }
     }
 
-    // Put new onto old
-    free(string_mut->buffer);
-    string_mut->buffer = new_string->buffer;
-    string_mut->length = new_string->length;
-    string_mut->capacity = new_string->capacity;
-    free(new_string);
+    string_mut_set_length(string_mut, length);
+    str_indices_free(&matches);
+}
+
+void string_mut_replace(StringMut* string_mut, const StrSlice* query, const StrSlice* replacer) {
+    string_mut_replace_n(string_mut, query, replacer, SIZE_MAX);
+}
+
+void string_mut_replace_first(StringMut* string_mut, const StrSlice* query, const StrSlice* replacer) {
+    string_mut_replace_n(string_mut, query, replacer, 1);
 }
 
 void string_mut_replace_char(StringMut* string_mut, c8 query, c8 replacement) {
-    for (usize i = 0; i < string_mut->length; i++) {
-        if (string_mut->buffer[i] == query) {
-            string_mut->buffer[i] = replacement;
+    c8* buffer = string_mut_buffer(string_mut);
+    usize length = string_mut_length(string_mut);
+
+    for (usize i = 0; i < length; i++) {
+        if (buffer[i] == query) {
+            buffer[i] = replacement;
         }
     }
 }
@@ -532,6 +638,55 @@ void cstring_mut_replace_char(CStringMut* cstring_mut, c8 query, c8 replacement)
     }
 }
 
+void string_mut_to_lower(StringMut* string_mut) {
+    ASSERT_NONNULL(string_mut);
+
+    ascii_to_lower(string_mut_buffer(string_mut), string_mut_length(string_mut));
+}
+
+void string_mut_to_upper(StringMut* string_mut) {
+    ASSERT_NONNULL(string_mut);
+
+    ascii_to_upper(string_mut_buffer(string_mut), string_mut_length(string_mut));
+}
+
+void cstring_mut_to_lower(CStringMut* cstring_mut) {
+    ASSERT_NONNULL(cstring_mut);
+
+    ascii_to_lower(cstring_mut->buffer, cstring_mut->length);
+}
+
+void cstring_mut_to_upper(CStringMut* cstring_mut) {
+    ASSERT_NONNULL(cstring_mut);
+
+    ascii_to_upper(cstring_mut->buffer, cstring_mut->length);
+}
+
+void string_mut_reserve(StringMut* string_mut, usize additional) {
+    ASSERT_NONNULL(string_mut);
+
+    usize length = string_mut_length(string_mut);
+    usize current = string_mut_capacity(string_mut);
+    usize required = length + additional;
+
+    if (current >= required) {
+        return;
+    }
+
+    usize capacity = current * 2 > required ? current * 2 : required;
+
+    if (_STRING_IS_HEAP(string_mut->small.tag)) {
+        string_mut->heap.buffer = heap_renew(string_mut->heap.buffer, sizeof(c8), capacity);
+    } else {
+        c8* buffer = heap_many(sizeof(c8), capacity);
+        memcpy(buffer, string_mut->small.buffer, length);
+        string_mut->heap.buffer = buffer;
+        string_mut->heap.length = length;
+    }
+
+    string_mut->heap.capacity = _STRING_HEAP_CAPACITY(capacity);
+}
+
 void string_mut_push(StringMut* string, const StrSlice* added) {
     ASSERT_NONNULL(string);
     ASSERT_NONNULL(added);
@@ -540,18 +695,10 @@ void string_mut_push(StringMut* string, const StrSlice* added) {
         return;
     }
 
-    if (string->capacity < (string->length + added->length)) {
-        if ((string->capacity * 2) < (string->capacity + added->length)) {
-            string->capacity = string->capacity + added->length;
-        } else {
-            string->capacity *= 2;
-        }
-
-        string->buffer = heap_renew(string->buffer, sizeof(c8), string->capacity);
-    }
-
-    memcpy(string->buffer + string->length, added->buffer, added->length);
-    string->length += added->length;
+    string_mut_reserve(string, added->length);
+    usize length = string_mut_length(string);
+    memcpy(string_mut_buffer(string) + length, added->buffer, added->length);
+    string_mut_set_length(string, length + added->length);
 }
 
 void cstring_mut_push(CStringMut* cstring, const CStrSlice* added) {
@@ -580,13 +727,11 @@ void cstring_mut_push(CStringMut* cstring, const CStrSlice* added) {
 void string_mut_push_char(StringMut* string_mut, c8 added) {
     ASSERT_NONNULL(string_mut);
 
-    if (string_mut->capacity < string_mut->length + 2) {
-        string_mut->capacity *= 2;
-        string_mut->buffer = heap_renew(string_mut->buffer, sizeof(c8), string_mut->capacity);
-    }
+    string_mut_reserve(string_mut, 1);
 
-    string_mut->buffer[string_mut->length] = added;
-    string_mut->length++;
+    usize length = string_mut_length(string_mut);
+    string_mut_buffer(string_mut)[length] = added;
+    string_mut_set_length(string_mut, length + 1);
 }
 
 void cstring_mut_push_char(CStringMut* cstring_mut, c8 added) {
@@ -603,7 +748,7 @@ void cstring_mut_push_char(CStringMut* cstring_mut, c8 added) {
 }
 
 void string_mut_clear(StringMut* string_mut) {
-    string_mut->length = 0;
+    string_mut_set_length(string_mut, 0);
 }
 
 void cstring_mut_clear(CStringMut* cstring_mut) {
@@ -612,8 +757,8 @@ void cstring_mut_clear(CStringMut* cstring_mut) {
 }
 
 void string_mut_clear_to(StringMut* string_mut, c8 value) {
-    string_mut->length = 0;
-    memset(string_mut->buffer, value, string_mut->capacity * sizeof(c8));
+    string_mut_set_length(string_mut, 0);
+    memset(string_mut_buffer(string_mut), value, string_mut_capacity(string_mut) * sizeof(c8));
 }
 
 void cstring_mut_clear_to(CStringMut* cstring_mut, c8 value) {
@@ -1,24 +1,56 @@
 #ifndef CTK_STRING_H
 #define CTK_STRING_H
 
+#include "../collection/iterator.h"
 #include "../core/memory.h"
 #include "../core/type.h"
 
 // MARK: Definition
 
+/**
+ * @brief number of bytes a String or StringMut stores inside of its own struct before spilling to the heap
+ */
+#define STRING_INLINE_CAPACITY (3 * sizeof(usize) - 1)
+
+// the last byte of a String or StringMut is a tag, an inline string keeps its length there while a heap string sets
+// a flag bit that lands in the same byte of its capacity word
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define _STRING_HEAP_CAPACITY(capacity) ((usize) (capacity) << 1 | 1)
+#define _STRING_CAPACITY(word)          ((word) >> 1)
+#define _STRING_INLINE_TAG(length)      ((u8) ((length) << 1))
+#define _STRING_INLINE_LENGTH(tag)      ((usize) (tag) >> 1)
+#define _STRING_IS_HEAP(tag)            (((tag) & 1) != 0)
+#else
+#define _STRING_HEAP_FLAG               ((usize) 1 << (sizeof(usize) * 8 - 1))
+#define _STRING_HEAP_CAPACITY(capacity) ((usize) (capacity) | _STRING_HEAP_FLAG)
+#define _STRING_CAPACITY(word)          ((word) & ~_STRING_HEAP_FLAG)
+#define _STRING_INLINE_TAG(length)      ((u8) (length))
+#define _STRING_INLINE_LENGTH(tag)      ((usize) (tag))
+#define _STRING_IS_HEAP(tag)            (((tag) & 0x80) != 0)
+#endif
+
 /**
  * @brief Heap allocated, mutable, non-null terminated string
- * @note Shares duplicate struct definition with CStringMut, but does not store null terminator in buffer
- */
-typedef struct {
-    c8* buffer;
-    usize length;
-    usize capacity;
+ * @note up to STRING_INLINE_CAPACITY bytes are stored in place of the buffer, length and capacity, so short strings
+ *       need no second allocation, and a zeroed StringMut is an empty string
+ * @note the bytes are found from the tag in the last byte on every access, so a StringMut may be copied or moved like
+ *       any value, read it through string_mut_buffer(), string_mut_length() and string_mut_as_slice()
+ */
+typedef union {
+    struct {
+        c8* buffer;
+        usize length;
+        usize capacity;
+    } heap;
+    struct {
+        c8 buffer[STRING_INLINE_CAPACITY];
+        u8 tag;
+    } small;
 } StringMut;
 
 /**
  * @brief Heap allocated, mutable, null terminated string
- * @note Shares duplicate struct definition with StringMut, but stores null terminator in buffer
+ * @note Shares the buffer, length, and capacity fields of a heap StringMut, but stores null terminator in buffer
  */
 typedef struct {
     c8* buffer;
@@ -28,17 +60,25 @@ typedef struct {
 
 /**
  * @brief Heap allocated, non-null terminated, immutable string
- * @note Shares duplicate struct definition with CString, but does not store null terminator in buffer
+ * @note shares the layout of StringMut, so up to STRING_INLINE_CAPACITY bytes are stored inline, and a String may be
+ *       copied or moved like any value, read it through string_buffer(), string_length() and string_as_slice()
  * @note Despite being immutable, String is not constant as it must be freed
  */
-typedef struct {
-    c8* buffer;
-    usize length;
+typedef union {
+    struct {
+        c8* buffer;
+        usize length;
+        usize capacity;
+    } heap;
+    struct {
+        c8 buffer[STRING_INLINE_CAPACITY];
+        u8 tag;
+    } small;
 } String;
 
 /**
  * @brief Heap allocated, immutable, null terminated string
- * @note Shares duplicate struct definition with String, but stores null terminator in buffer
+ * @note Shares the buffer and length layout of Str, but stores null terminator in buffer
  * @note Despite being immutable, CString is not constant as it must be freed
  */
 typedef struct {
@@ -48,7 +88,7 @@ typedef struct {
 
 /**
  * @brief Stack allocated, immutable, non-null terminated string
- * @note Shares duplicate struct definition with String, and keeps same buffer layout, but is stack allocated
+ * @note Shares the buffer and length layout of CString, but is stack allocated
  */
 typedef struct {
     const c8* buffer;
@@ -89,6 +129,7 @@ typedef struct {
 // MARK: Preprocessor Type Defines
 
 DEFINE_OPTION(usize, Index, index, 0)
+DEFINE_ITER(StrSlice, StrSlice, str_slice)
 
 // MARK: Lifecycle
 
@@ -101,6 +142,12 @@ String* string_new(const c8* cstr_literal)
     __attribute__((warn_unused_result))
     __attribute__((nonnull(1)));
 
+/**
+ * @return heap allocated String of the given length whose bytes are left for the caller to fill in
+ * @note for building a string in place once its final length is known, see StringBuilder
+ */
+String* string_new_sized(usize length) __attribute__((warn_unused_result));
+
 /**
  * @brief performs a deep copy of the given string
  */
@@ -145,7 +192,7 @@ StringMut* string_mut_new(const c8* cstr_literal)
 
 /**
  * @return heap alocated, non-null terminated, owned, mutable string pointer with buffer allocated to the initial capacity
- * @note if initial_capacity = 0, initial_capacity will be set to 1
+ * @note capacities up to STRING_INLINE_CAPACITY (including 0) are stored inline without a heap allocation
  */
 StringMut* string_mut_new_sized(usize initial_capacity) __attribute__((warn_unused_result));
 
@@ -161,6 +208,18 @@ StringMut* string_mut_clone(const StringMut* string_mut)
  */
 void string_mut_free(StringMut** string_mut) __attribute__((nonnull(1)));
 
+/**
+ * @brief initializes a stack or container resident mutable string with room for the initial capacity
+ * @note capacities up to STRING_INLINE_CAPACITY (including 0) are stored inline without a heap allocation
+ * @note must be deinitialized with string_mut_deinit()
+ */
+void string_mut_init(StringMut* string_mut, usize initial_capacity) __attribute__((nonnull(1)));
+
+/**
+ * @brief frees the heap buffer of a mutable string initialized in place, leaving it an empty inline string
+ */
+void string_mut_deinit(StringMut* string_mut) __attribute__((nonnull(1)));
+
 /**
  * @param cstr_literal as a null terminated raw c string
  * @return heap allocated, mutable, owned CStringMut pointer
@@ -232,16 +291,22 @@ CStr cstr_init(const c8* cstr_literal) __attribute__((nonnull(1)));
  */
 void str_slices_free(StrSlices** slices) __attribute__((nonnull(1)));
 
+/**
+ * @return a lazy iterator over the given slices, the source for DEFINE_ITER_FILTER(), DEFINE_ITER_MAP(), etc.
+ * @note the iterator has the same lifetime as the given slices and does not need to be freed
+ */
+__attribute__((nonnull(1))) static inline IterStrSlice str_slices_iter(const StrSlices* slices) {
+    return iter_str_slice_from_array(slices->slices, slices->count);
+}
+
 // MARK: Conversions
 
 /**
  * @brief heap allocates a new string from the given str
  */
-__attribute__((warn_unused_result))
-__attribute__((nonnull(1))) static inline String*
-str_to_owned(const StrSlice* str) {
-    return string_clone((String*) str);
-}
+String* str_to_owned(const StrSlice* str)
+    __attribute__((warn_unused_result))
+    __attribute__((nonnull(1)));
 
 /**
  * @brief heap allocates a new cstring from the given cstr
@@ -259,6 +324,14 @@ StringMut* str_to_owned_mut(const StrSlice* str)
     __attribute__((warn_unused_result))
     __attribute__((nonnull(1)));
 
+/**
+ * @brief moves the contents of the given string_mut into a new string, freeing the string_mut
+ * @note heap buffers are handed over without copying
+ */
+String* string_mut_to_string_owned(StringMut* string_mut)
+    __attribute__((warn_unused_result))
+    __attribute__((nonnull(1)));
+
 /**
  * @brief heap allocates a new mutable cstring from the given cstr
  */
@@ -269,12 +342,72 @@ CStringMut* cstr_to_owned_mut(const CStrSlice* cstr)
 // MARK: Shallow conversions
 
 /**
- * @brief takes a reference to the given owned string without cloning
- * @note the lifetime of this returned ref is the same as the given mutable CString
- * @note because the referenced string is mutable, the references slice may change
+ * @return the bytes of the given string, which live inside of the struct itself while it is short enough
+ * @note only valid until the string is freed, or moved when the string is stored inline
+ */
+__attribute__((nonnull(1))) static inline c8* string_buffer(const String* string) {
+    return _STRING_IS_HEAP(string->small.tag) ? string->heap.buffer : (c8*) string->small.buffer;
+}
+
+/**
+ * @return the number of bytes in the given string
+ */
+__attribute__((nonnull(1))) static inline usize string_length(const String* string) {
+    return _STRING_IS_HEAP(string->small.tag) ? string->heap.length : _STRING_INLINE_LENGTH(string->small.tag);
+}
+
+/**
+ * @return the bytes of the given mutable string, which live inside of the struct itself while it is short enough
+ * @note only valid until the string grows, is freed, or moved when the string is stored inline
+ */
+__attribute__((nonnull(1))) static inline c8* string_mut_buffer(const StringMut* string_mut) {
+    return _STRING_IS_HEAP(string_mut->small.tag) ? string_mut->heap.buffer : (c8*) string_mut->small.buffer;
+}
+
+/**
+ * @return the number of bytes in the given mutable string
+ */
+__attribute__((nonnull(1))) static inline usize string_mut_length(const StringMut* string_mut) {
+    return _STRING_IS_HEAP(string_mut->small.tag) ? string_mut->heap.length
+                                                  : _STRING_INLINE_LENGTH(string_mut->small.tag);
+}
+
+/**
+ * @return the number of bytes the given mutable string holds before it has to grow
  */
-static inline StrSlice* string_mut_as_ref(const StringMut* string) {
-    return ((StrSlice*) string);
+__attribute__((nonnull(1))) static inline usize string_mut_capacity(const StringMut* string_mut) {
+    return _STRING_IS_HEAP(string_mut->small.tag) ? _STRING_CAPACITY(string_mut->heap.capacity)
+                                                  : STRING_INLINE_CAPACITY;
+}
+
+/**
+ * @brief changes the length of the given mutable string without touching its bytes
+ * @note for filling bytes written directly after string_mut_reserve(), the length must not pass the capacity
+ */
+__attribute__((nonnull(1))) static inline void string_mut_set_length(StringMut* string_mut, usize length) {
+    assert(length <= string_mut_capacity(string_mut));
+
+    if (_STRING_IS_HEAP(string_mut->small.tag)) {
+        string_mut->heap.length = length;
+    } else {
+        string_mut->small.tag = _STRING_INLINE_TAG(length);
+    }
+}
+
+/**
+ * @return slice over the bytes of the given string without cloning
+ * @note the slice has the same lifetime as the bytes, see string_buffer()
+ */
+__attribute__((nonnull(1))) static inline StrSlice string_as_slice(const String* string) {
+    return (StrSlice) {string_buffer(string), string_length(string)};
+}
+
+/**
+ * @return slice over the current bytes of the given mutable string without cloning
+ * @note the slice has the same lifetime as the bytes, see string_mut_buffer(), and does not follow later pushes
+ */
+__attribute__((nonnull(1))) static inline StrSlice string_mut_as_slice(const StringMut* string_mut) {
+    return (StrSlice) {string_mut_buffer(string_mut), string_mut_length(string_mut)};
 }
 
 /**
@@ -286,14 +419,6 @@ static inline CStrSlice* cstring_mut_as_ref(const CStringMut* cstring) {
     return ((CStrSlice*) cstring);
 }
 
-/**
- * @brief takes a reference to the given owned string without cloning
- * @note the lifetime of this returned ref is the same as the given String
- */
-__attribute__((nonnull(1))) static inline StrSlice* string_as_ref(const String* string) {
-    return (StrSlice*) string;
-}
-
 /**
  * @brief takes a reference to the given owned string without cloning
  * @note the lifetime of this returned ref is the same as the given CString
@@ -344,6 +469,17 @@ bool str_equals(const StrSlice* one, const StrSlice* two) __attribute__((nonnull
  */
 i32 str_compare(const StrSlice* one, const StrSlice* two) __attribute__((nonnull(1, 2)));
 
+/**
+ * @return true if each string have the same length and the same contents once ASCII letters are folded to lowercase
+ * @note only A-Z and a-z are folded, every other byte must match exactly
+ */
+bool str_equals_ignore_case(const StrSlice* one, const StrSlice* two) __attribute__((nonnull(1, 2)));
+
+/**
+ * @return positive if one > two, negative if two > one, or 0 if one == two, comparing ASCII letters as lowercase
+ */
+i32 str_compare_ignore_case(const StrSlice* one, const StrSlice* two) __attribute__((nonnull(1, 2)));
+
 /**
  * @return true if each cstring have the same length and same buffer contents
  * @note this is the same as str_equals(cstring_as_str_ref(cstring), cstring_as_str_ref(cstring))
@@ -378,6 +514,35 @@ CString* cstr_replace(const CStrSlice* cstr, const CStrSlice* query, const CStrS
     __attribute__((nonnull(1, 2, 3)))
     __attribute__((warn_unused_result));
 
+/**
+ * @return a new string with the first n non-overlapping instances of the given query replaced with given replacement
+ * @note matches are located up front, so the result is allocated once at its exact length
+ */
+String* str_replace_n(const StrSlice* str, const StrSlice* query, const StrSlice* replacement, usize n)
+    __attribute__((nonnull(1, 2, 3)))
+    __attribute__((warn_unused_result));
+
+/**
+ * @return a new cstring with the first n non-overlapping instances of the given query replaced with given replacement
+ */
+CString* cstr_replace_n(const CStrSlice* cstr, const CStrSlice* query, const CStrSlice* replacement, usize n)
+    __attribute__((nonnull(1, 2, 3)))
+    __attribute__((warn_unused_result));
+
+/**
+ * @return a new string with the first instance of the given query replaced with given replacement
+ */
+String* str_replace_first(const StrSlice* str, const StrSlice* query, const StrSlice* replacement)
+    __attribute__((nonnull(1, 2, 3)))
+    __attribute__((warn_unused_result));
+
+/**
+ * @return a new cstring with the first instance of the given query replaced with given replacement
+ */
+CString* cstr_replace_first(const CStrSlice* cstr, const CStrSlice* query, const CStrSlice* replacement)
+    __attribute__((nonnull(1, 2, 3)))
+    __attribute__((warn_unused_result));
+
 /**
  * @param str: existing string
  * @param start: start inclusive
@@ -401,6 +566,25 @@ __attribute__((nonnull(1))) static inline StrSlice cstr_sub_slice(const CStrSlic
     return str_sub_slice((const StrSlice*) cstr, start, length);
 }
 
+/**
+ * @return a slice of the given str without its leading and trailing ASCII whitespace (' ', '\t', '\n', '\v', '\f', '\r')
+ * @note this has the same lifetime as the given str and does not need to be freed
+ * @note whitespace is classified 16 or 32 bytes at a time with SSE2 or AVX2, so long runs of padding are cheap to skip
+ */
+StrSlice str_trim(const StrSlice* str) __attribute__((nonnull(1)));
+
+/**
+ * @return a slice of the given str without its leading ASCII whitespace
+ * @note this has the same lifetime as the given str and does not need to be freed
+ */
+StrSlice str_trim_start(const StrSlice* str) __attribute__((nonnull(1)));
+
+/**
+ * @return a slice of the given str without its trailing ASCII whitespace
+ * @note this has the same lifetime as the given str and does not need to be freed
+ */
+StrSlice str_trim_end(const StrSlice* str) __attribute__((nonnull(1)));
+
 /**
  * @return a heap allocated struct wrapper around 1 or more slice references to a given str as split by the given delimiter
  * @note this does need to be freed, but freeing will not free the referenced string
@@ -429,11 +613,21 @@ cstr_split_slices(const CStrSlice* cstr, c8 delimiter) {
  */
 bool str_contains(const StrSlice* str, const StrSlice* query) __attribute__((nonnull(1, 2)));
 
+/**
+ * @return true if the given str contains the given query str, ignoring ASCII case
+ */
+bool str_contains_ignore_case(const StrSlice* str, const StrSlice* query) __attribute__((nonnull(1, 2)));
+
 /**
  * @return true if the given str contains the given query character
  */
 bool str_contains_char(const StrSlice* str, c8 query) __attribute__((nonnull(1)));
 
+/**
+ * @return the number of times the given query occurs in the given str
+ */
+usize str_count_char(const StrSlice* str, c8 query) __attribute__((nonnull(1)));
+
 /**
  * @return the first instance of the given query in the given str, or an empty optional if not found
  */
@@ -465,6 +659,19 @@ OptionIndex str_find_last_nth(const StrSlice* str, c8 query, usize n) __attribut
 void string_mut_replace(StringMut* string_mut, const StrSlice* query, const StrSlice* replacer)
     __attribute__((nonnull(1, 2, 3)));
 
+/**
+ * @brief replaces the first n non-overlapping instances of the given query string with the given replacement string
+ * @note equal length queries and replacers are overwritten in place, otherwise the buffer grows at most once
+ */
+void string_mut_replace_n(StringMut* string_mut, const StrSlice* query, const StrSlice* replacer, usize n)
+    __attribute__((nonnull(1, 2, 3)));
+
+/**
+ * @brief replaces the first instance of the given query string with the given replacement string
+ */
+void string_mut_replace_first(StringMut* string_mut, const StrSlice* query, const StrSlice* replacer)
+    __attribute__((nonnull(1, 2, 3)));
+
 /**
  * @brief replaces all instances of the given query with the given replacement in place
  */
@@ -475,6 +682,26 @@ void string_mut_replace_char(StringMut* string_mut, c8 query, c8 replacement) __
  */
 void cstring_mut_replace_char(CStringMut* cstring_mut, c8 query, c8 replacement) __attribute__((nonnull(1)));
 
+/**
+ * @brief converts every ASCII uppercase letter to lowercase in place, leaving all other bytes untouched
+ */
+void string_mut_to_lower(StringMut* string_mut) __attribute__((nonnull(1)));
+
+/**
+ * @brief converts every ASCII lowercase letter to uppercase in place, leaving all other bytes untouched
+ */
+void string_mut_to_upper(StringMut* string_mut) __attribute__((nonnull(1)));
+
+/**
+ * @brief converts every ASCII uppercase letter to lowercase in place, leaving all other bytes untouched
+ */
+void cstring_mut_to_lower(CStringMut* cstring_mut) __attribute__((nonnull(1)));
+
+/**
+ * @brief converts every ASCII lowercase letter to uppercase in place, leaving all other bytes untouched
+ */
+void cstring_mut_to_upper(CStringMut* cstring_mut) __attribute__((nonnull(1)));
+
 /**
  * @brief pushes a given slice onto the end of mutable string
  */
@@ -485,6 +712,12 @@ void string_mut_push(StringMut* string_mut, const StrSlice* added) __attribute__
  */
 void string_mut_push_char(StringMut* string_mut, c8 added) __attribute__((nonnull(1)));
 
+/**
+ * @brief grows the capacity of the given string so that at least additional more bytes fit without reallocating
+ * @note moves an inline string to the heap once the required capacity exceeds STRING_INLINE_CAPACITY
+ */
+void string_mut_reserve(StringMut* string_mut, usize additional) __attribute__((nonnull(1)));
+
 /**
  * @brief changes the length of the given string without modifying the underlying data or capacity
  * @note to perform a deep clear, string_mut_clear_to() can be used
@@ -0,0 +1,345 @@
+#include "utf8.h"
+#include <assert.h>
+#include <string.h>
+#include "../core/memory.h"
+#include "../core/simd.h"
+
+// MARK: Internal
+
+static inline bool is_continuation(u8 byte) {
+    return (byte & 0xC0) == 0x80;
+}
+
+/**
+ * @return the length of the valid sequence starting at bytes, storing its code point, or 0 if it is not valid
+ */
+static usize utf8_decode(const u8* bytes, usize length, u32* code_point) {
+    u8 lead = bytes[0];
+    usize size;
+    u32 value;
+    u8 low = 0x80;
+    u8 high = 0xBF;
+
+    if (lead < 0x80) {
+        *code_point = lead;
+        return 1;
+    }
+
+    // the second byte range is what rules out overlong forms, surrogates and code points past U+10FFFF
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        size = 2;
+        value = lead & 0x1F;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+        size = 3;
+        value = lead & 0x0F;
+        low = lead == 0xE0 ? 0xA0 : 0x80;
+        high = lead == 0xED ? 0x9F : 0xBF;
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+        size = 4;
+        value = lead & 0x07;
+        low = lead == 0xF0 ? 0x90 : 0x80;
+        high = lead == 0xF4 ? 0x8F : 0xBF;
+    } else {
+        return 0;
+    }
+
+    if (length < size || bytes[1] < low || bytes[1] > high) {
+        return 0;
+    }
+
+    value = (value << 6) | (bytes[1] & 0x3F);
+    for (usize i = 2; i < size; i++) {
+        if (!is_continuation(bytes[i])) {
+            return 0;
+        }
+        value = (value << 6) | (bytes[i] & 0x3F);
+    }
+
+    *code_point = value;
+    return size;
+}
+
+static usize utf8_valid_up_to_scalar(const u8* bytes, usize start, usize length) {
+    usize i = start;
+
+    while (i < length) {
+        // ascii runs are skipped a word at a time
+        if (i + 8 <= length) {
+            u64 word;
+            memcpy(&word, bytes + i, sizeof(u64));
+            if ((word & 0x8080808080808080ULL) == 0) {
+                i += 8;
+                continue;
+            }
+        }
+
+        u32 code_point;
+        usize size = utf8_decode(bytes + i, length - i, &code_point);
+        if (size == 0) {
+            return i;
+        }
+        i += size;
+    }
+
+    return length;
+}
+
+static usize utf8_count_scalar(const u8* bytes, usize start, usize length) {
+    usize count = 0;
+    usize i = start;
+
+    // a byte starts a code point unless it is 10xxxxxx, so bit 7 clear or bit 6 set
+    for (; i + 8 <= length; i += 8) {
+        u64 word;
+        memcpy(&word, bytes + i, sizeof(u64));
+        count += __builtin_popcountll(((~word >> 7) | (word >> 6)) & 0x0101010101010101ULL);
+    }
+
+    for (; i < length; i++) {
+        count += !is_continuation(bytes[i]);
+    }
+
+    return count;
+}
+
+#ifdef _SIMD_X86
+#define _UTF8_TABLE(...)                _mm256_setr_epi8(__VA_ARGS__, __VA_ARGS__)
+#define _UTF8_PREVIOUS(input, previous, count) \
+    _mm256_alignr_epi8(input, _mm256_permute2x128_si256(previous, input, 0x21), 16 - (count))
+
+// error classes of the lookup algorithm (Keiser & Lemire), one bit each so three table lookups can be intersected
+#define _TOO_SHORT      (1 << 0)
+#define _TOO_LONG       (1 << 1)
+#define _OVERLONG_3     (1 << 2)
+#define _TOO_LARGE      (1 << 3)
+#define _SURROGATE      (1 << 4)
+#define _OVERLONG_2     (1 << 5)
+#define _TOO_LARGE_1000 (1 << 6)
+#define _OVERLONG_4     (1 << 6)
+#define _TWO_CONTS      (1 << 7)
+#define _CARRY          (_TOO_SHORT | _TOO_LONG | _TWO_CONTS)
+
+/**
+ * @return non zero lanes wherever the block, read with the last bytes of the previous block, is not valid UTF-8
+ * @note sequences left unfinished at the end of the block are reported by the next block, see utf8_incomplete_avx2()
+ */
+_SIMD_TARGET_AVX2 static inline __m256i utf8_errors_avx2(__m256i input, __m256i previous) {
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    __m256i previous_1 = _UTF8_PREVIOUS(input, previous, 1);
+    __m256i previous_2 = _UTF8_PREVIOUS(input, previous, 2);
+    __m256i previous_3 = _UTF8_PREVIOUS(input, previous, 3);
+
+    __m256i byte_1_high = _mm256_shuffle_epi8(
+        _UTF8_TABLE(_TOO_LONG, _TOO_LONG, _TOO_LONG, _TOO_LONG, _TOO_LONG, _TOO_LONG, _TOO_LONG, _TOO_LONG, _TWO_CONTS,
+                    _TWO_CONTS, _TWO_CONTS, _TWO_CONTS, _TOO_SHORT | _OVERLONG_2, _TOO_SHORT,
+                    _TOO_SHORT | _OVERLONG_3 | _SURROGATE, _TOO_SHORT | _TOO_LARGE | _TOO_LARGE_1000 | _OVERLONG_4),
+        _mm256_and_si256(_mm256_srli_epi16(previous_1, 4), nibble));
+
+    __m256i byte_1_low = _mm256_shuffle_epi8(
+        _UTF8_TABLE(_CARRY | _OVERLONG_3 | _OVERLONG_2 | _OVERLONG_4, _CARRY | _OVERLONG_2, _CARRY, _CARRY,
+                    _CARRY | _TOO_LARGE, _CARRY | _TOO_LARGE | _TOO_LARGE_1000, _CARRY | _TOO_LARGE | _TOO_LARGE_1000,
+                    _CARRY | _TOO_LARGE | _TOO_LARGE_1000, _CARRY | _TOO_LARGE | _TOO_LARGE_1000,
+                    _CARRY | _TOO_LARGE | _TOO_LARGE_1000, _CARRY | _TOO_LARGE | _TOO_LARGE_1000,
+                    _CARRY | _TOO_LARGE | _TOO_LARGE_1000, _CARRY | _TOO_LARGE | _TOO_LARGE_1000,
+                    _CARRY | _TOO_LARGE | _TOO_LARGE_1000 | _SURROGATE, _CARRY | _TOO_LARGE | _TOO_LARGE_1000,
+                    _CARRY | _TOO_LARGE | _TOO_LARGE_1000),
+        _mm256_and_si256(previous_1, nibble));
+
+    __m256i byte_2_high = _mm256_shuffle_epi8(
+        _UTF8_TABLE(_TOO_SHORT, _TOO_SHORT, _TOO_SHORT, _TOO_SHORT, _TOO_SHORT, _TOO_SHORT, _TOO_SHORT, _TOO_SHORT,
+                    _TOO_LONG | _OVERLONG_2 | _TWO_CONTS | _OVERLONG_3 | _TOO_LARGE_1000 | _OVERLONG_4,
+                    _TOO_LONG | _OVERLONG_2 | _TWO_CONTS | _OVERLONG_3 | _TOO_LARGE,
+                    _TOO_LONG | _OVERLONG_2 | _TWO_CONTS | _SURROGATE | _TOO_LARGE,
+                    _TOO_LONG | _OVERLONG_2 | _TWO_CONTS | _SURROGATE | _TOO_LARGE, _TOO_SHORT, _TOO_SHORT, _TOO_SHORT,
+                    _TOO_SHORT),
+        _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble));
+
+    __m256i special = _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+
+    // the third and fourth bytes of a sequence must be continuations, which the tables alone flag as two in a row
+    __m256i third = _mm256_subs_epu8(previous_2, _mm256_set1_epi8((i8) (0xE0 - 0x80)));
+    __m256i fourth = _mm256_subs_epu8(previous_3, _mm256_set1_epi8((i8) (0xF0 - 0x80)));
+    __m256i expected = _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8((i8) 0x80));
+
+    return _mm256_xor_si256(expected, special);
+}
+
+/**
+ * @return non zero lanes if the block ends part way through a sequence
+ */
+_SIMD_TARGET_AVX2 static inline __m256i utf8_incomplete_avx2(__m256i input) {
+    const __m256i limits = _mm256_setr_epi8((i8) 0xFF, (i8) 0xFF, (i8) 0xFF, (i8) 0xFF, (i8) 0xFF, (i8) 0xFF, (i8) 0xFF,
+                                            (i8) 0xFF, (i8) 0xFF, (i8) 0xFF, (i8) 0xFF, (i8) 0xFF, (i8) 0xFF, (i8) 0xFF,
+                                            (i8) 0xFF, (i8) 0xFF, (i8) 0xFF, (i8) 0xFF, (i8) 0xFF, (i8) 0xFF, (i8) 0xFF,
+                                            (i8) 0xFF, (i8) 0xFF, (i8) 0xFF, (i8) 0xFF, (i8) 0xFF, (i8) 0xFF, (i8) 0xFF,
+                                            (i8) 0xFF, (i8) (0xF0 - 1), (i8) (0xE0 - 1), (i8) (0xC0 - 1));
+
+    return _mm256_subs_epu8(input, limits);
+}
+
+/**
+ * @return length if the whole buffer is valid, otherwise a char boundary before the first invalid byte
+ *         from which the scalar decoder can pinpoint it
+ */
+_SIMD_TARGET_AVX2 static usize utf8_valid_prefix_avx2(const u8* bytes, usize length) {
+    __m256i previous = _mm256_setzero_si256();
+    __m256i incomplete = _mm256_setzero_si256();
+    usize i = 0;
+
+    // the zero padded tail block also flushes a sequence left unfinished by the last full block
+    while (i <= length) {
+        __m256i input;
+        if (i + 32 <= length) {
+            input = _mm256_loadu_si256((const __m256i*) (bytes + i));
+        } else {
+            u8 tail[32] = {0};
+            memcpy(tail, bytes + i, length - i);
+            input = _mm256_loadu_si256((const __m256i*) tail);
+        }
+
+        // a sequence the previous block left open is checked against this one, unless it is ascii and cannot finish it
+        __m256i errors = incomplete;
+        if (_mm256_movemask_epi8(input) != 0) {
+            errors = utf8_errors_avx2(input, previous);
+        }
+
+        if (!_mm256_testz_si256(errors, errors)) {
+            // the error may stem from a sequence the previous block started, so back up to its lead byte
+            usize start = i;
+            for (usize back = 0; back < 4 && start > 0; back++) {
+                u8 byte = bytes[start - 1];
+                if (byte < 0x80) {
+                    break;
+                }
+                start--;
+                if (byte >= 0xC0) {
+                    break;
+                }
+            }
+            return start;
+        }
+
+        incomplete = utf8_incomplete_avx2(input);
+        previous = input;
+        i += 32;
+    }
+
+    return length;
+}
+
+_SIMD_TARGET_AVX2 static usize utf8_count_avx2(const u8* bytes, usize length) {
+    const __m256i threshold = _mm256_set1_epi8((i8) 0xBF);
+    usize count = 0;
+    usize i = 0;
+
+    for (; i + 32 <= length; i += 32) {
+        __m256i input = _mm256_loadu_si256((const __m256i*) (bytes + i));
+        u32 mask = (u32) _mm256_movemask_epi8(_mm256_cmpgt_epi8(input, threshold));
+        count += __builtin_popcount(mask);
+    }
+
+    return count + utf8_count_scalar(bytes, i, length);
+}
+#endif
+
+// MARK: Validation
+
+usize str_utf8_valid_up_to(const StrSlice* str) {
+    ASSERT_NONNULL(str);
+
+    const u8* bytes = (const u8*) str->buffer;
+    usize start = 0;
+
+#ifdef _SIMD_X86
+    if (simd_has_avx2()) {
+        start = utf8_valid_prefix_avx2(bytes, str->length);
+        if (start == str->length) {
+            return start;
+        }
+    }
+#endif
+
+    return utf8_valid_up_to_scalar(bytes, start, str->length);
+}
+
+// MARK: Query
+
+usize str_utf8_count(const StrSlice* str) {
+    ASSERT_NONNULL(str);
+
+#ifdef _SIMD_X86
+    if (simd_has_avx2()) {
+        return utf8_count_avx2((const u8*) str->buffer, str->length);
+    }
+#endif
+
+    return utf8_count_scalar((const u8*) str->buffer, 0, str->length);
+}
+
+bool str_utf8_is_char_boundary(const StrSlice* str, usize index) {
+    ASSERT_NONNULL(str);
+
+    if (index == 0 || index == str->length) {
+        return true;
+    }
+
+    return index < str->length && !is_continuation((u8) str->buffer[index]);
+}
+
+usize str_utf8_floor_char_boundary(const StrSlice* str, usize index) {
+    ASSERT_NONNULL(str);
+
+    if (index >= str->length) {
+        return str->length;
+    }
+
+    while (index > 0 && is_continuation((u8) str->buffer[index])) {
+        index--;
+    }
+
+    return index;
+}
+
+usize str_utf8_ceil_char_boundary(const StrSlice* str, usize index) {
+    ASSERT_NONNULL(str);
+
+    while (index < str->length && is_continuation((u8) str->buffer[index])) {
+        index++;
+    }
+
+    return index < str->length ? index : str->length;
+}
+
+// MARK: Iteration
+
+StrUtf8Iter str_utf8_iter(const StrSlice* str) {
+    ASSERT_NONNULL(str);
+
+    return (StrUtf8Iter) {str->buffer, str->length, 0};
+}
+
+bool str_utf8_iter_next(StrUtf8Iter* iter, u32* out) {
+    ASSERT_NONNULL(iter);
+    ASSERT_NONNULL(out);
+
+    if (iter->position >= iter->length) {
+        return false;
+    }
+
+    const u8* bytes = (const u8*) iter->buffer + iter->position;
+
+    if (bytes[0] < 0x80) {
+        *out = bytes[0];
+        iter->position++;
+        return true;
+    }
+
+    usize size = utf8_decode(bytes, iter->length - iter->position, out);
+    if (size == 0) {
+        *out = UTF8_REPLACEMENT;
+        size = 1;
+    }
+    iter->position += size;
+
+    return true;
+}
@@ -0,0 +1,74 @@
+#ifndef CTK_UTF8_H
+#define CTK_UTF8_H
+
+#include "../string/string.h"
+
+/**
+ * @brief Code point yielded by the iterator in place of every byte that does not start a valid sequence
+ */
+#define UTF8_REPLACEMENT 0xFFFD
+
+// MARK: Definition
+
+/**
+ * @brief Lazy, stack resident iterator over the code points of a str
+ * @note the str must outlive the iterator
+ */
+typedef struct {
+    const c8* buffer;
+    usize length;
+    usize position;
+} StrUtf8Iter;
+
+// MARK: Validation
+
+/**
+ * @return the length of the longest prefix of the given str that is valid UTF-8, which is str->length if all of it is
+ * @note valid means well formed per RFC 3629: no overlong forms, surrogates, or code points past U+10FFFF
+ */
+usize str_utf8_valid_up_to(const StrSlice* str) __attribute__((nonnull(1)));
+
+/**
+ * @return true if the whole str is valid UTF-8, see str_utf8_valid_up_to()
+ */
+__attribute__((nonnull(1))) static inline bool str_utf8_validate(const StrSlice* str) {
+    return str_utf8_valid_up_to(str) == str->length;
+}
+
+// MARK: Query
+
+/**
+ * @return the number of code points in the given str
+ * @note counts every byte that is not a continuation byte, which is exact for valid UTF-8
+ */
+usize str_utf8_count(const StrSlice* str) __attribute__((nonnull(1)));
+
+/**
+ * @return true if the given index is 0, str->length, or the first byte of a code point
+ */
+bool str_utf8_is_char_boundary(const StrSlice* str, usize index) __attribute__((nonnull(1)));
+
+/**
+ * @return the closest char boundary at or before the given index, which is clamped to str->length
+ */
+usize str_utf8_floor_char_boundary(const StrSlice* str, usize index) __attribute__((nonnull(1)));
+
+/**
+ * @return the closest char boundary at or after the given index, which is clamped to str->length
+ */
+usize str_utf8_ceil_char_boundary(const StrSlice* str, usize index) __attribute__((nonnull(1)));
+
+// MARK: Iteration
+
+/**
+ * @return iterator over the code points of the given str, front to back
+ */
+StrUtf8Iter str_utf8_iter(const StrSlice* str) __attribute__((nonnull(1)));
+
+/**
+ * @return true and stores the next code point in out, or false once the str is exhausted
+ * @note a byte that does not start a valid sequence yields UTF8_REPLACEMENT and is skipped on its own
+ */
+bool str_utf8_iter_next(StrUtf8Iter* iter, u32* out) __attribute__((nonnull(1, 2)));
+
+#endif
@@ -0,0 +1,288 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include "ctk/collection/iterator.h"
+#include "ctk/collection/segmented_vector.h"
+#include "ctk/collection/sharded_map.h"
+#include "ctk/collection/soa.h"
+#include "ctk/string/hash.h"
+#include "ctk/string/string.h"
+
+static u64 string_hash(const String* string) {
+    StrSlice slice = string_as_slice(string);
+    return str_hash64(&slice, 0);
+}
+
+static bool string_equals(const String* one, const String* two) {
+    StrSlice one_slice = string_as_slice(one);
+    StrSlice two_slice = string_as_slice(two);
+    return str_equals(&one_slice, &two_slice);
+}
+
+DEFINE_SHARDED_MAP(String, String, Cache, cache, string_hash, string_equals, string_clone, string_free, string_clone, string_free)
+
+typedef struct {
+    i32 x;
+    i32 y;
+} Point;
+
+static void string_mut_destroy(StringMut* string_mut) {
+    string_mut_deinit(string_mut);
+}
+
+DEFINE_SEGMENTED_VEC(Point, Point, point, segmented_vec_no_destroy)
+DEFINE_SEGMENTED_VEC(StringMut, Node, node, string_mut_destroy)
+
+DEFINE_SOA(Particle, particle, (f32, x), (f32, y), (u32, id))
+
+static bool is_long_field(StrSlice* field) {
+    return field->length > 3;
+}
+
+static bool is_even(i32* value) {
+    return *value % 2 == 0;
+}
+
+static i64 square(i32 value) {
+    return (i64) value * value;
+}
+
+static usize field_length(StrSlice field) {
+    return field.length;
+}
+
+DEFINE_ITER(i32, Int, int)
+DEFINE_ITER_FILTER(i32, EvenInt, even_int, Int, int, is_even)
+DEFINE_ITER_MAP(i64, Square, square, i32, EvenInt, even_int, square)
+DEFINE_ITER_SKIP(i64, SkippedSquare, skipped_square, Square, square)
+DEFINE_ITER_TAKE(i64, TakenSquare, taken_square, SkippedSquare, skipped_square)
+DEFINE_ITER_PAIR(usize, i64, IndexedSquare)
+DEFINE_ITER_ENUMERATE(IndexedSquare, EnumeratedSquare, enumerated_square, TakenSquare, taken_square)
+
+static bool is_odd_index(IndexedSquare* pair) {
+    return pair->left % 2 == 1;
+}
+
+DEFINE_ITER_FILTER(IndexedSquare, OddSquare, odd_square, EnumeratedSquare, enumerated_square, is_odd_index)
+
+DEFINE_ITER_SKIP(i32, SkippedInt, skipped_int, Int, int)
+DEFINE_ITER_PAIR(i32, i32, IntPair)
+DEFINE_ITER_ZIP(IntPair, ZippedInt, zipped_int, Int, int, SkippedInt, skipped_int)
+
+static i32 pair_difference(IntPair pair) {
+    return pair.right - pair.left;
+}
+
+DEFINE_ITER_MAP(i32, Difference, difference, IntPair, ZippedInt, zipped_int, pair_difference)
+
+DEFINE_ITER_FILTER(StrSlice, LongField, long_field, StrSlice, str_slice, is_long_field)
+DEFINE_ITER_MAP(usize, FieldLength, field_length, StrSlice, LongField, long_field, field_length)
+
+#define WORKERS 4
+#define WORKER_KEYS 500
+
+static void* cache_worker(void* arg) {
+    ShardedMapCache* cache = arg;
+    c8 key[32];
+
+    for (usize i = 0; i < WORKER_KEYS; i++) {
+        snprintf(key, sizeof(key), "/usr/share/%zu", i);
+        String* winner = sharded_map_cache_get_or_insert_owned(cache, string_new(key), string_new(key));
+        StrSlice winner_slice = string_as_slice(winner);
+        assert(str_equals(&winner_slice, &(Str) {key, strlen(key)}));
+        string_free(&winner);
+    }
+
+    return NULL;
+}
+
+static void test_sharded_map() {
+    ShardedMapCache* cache = sharded_map_cache_new(SHARDED_MAP_DEFAULT_SHARDS);
+    String* key = string_new("~/.config");
+    String* value = string_new("/home/user/.config");
+    String* other = string_new("/root/.config");
+
+    assert(sharded_map_cache_insert(cache, key, value));
+    assert(!sharded_map_cache_insert(cache, key, other));
+    assert(sharded_map_cache_count(cache) == 1);
+
+    OptionCache found = sharded_map_cache_get(cache, key);
+    assert(found.present);
+    assert(string_equals(found.value, other));
+    string_free(&found.value);
+
+    assert(sharded_map_cache_remove(cache, key));
+    assert(!sharded_map_cache_remove(cache, key));
+    assert(!sharded_map_cache_contains(cache, key));
+    assert(!sharded_map_cache_get(cache, key).present);
+
+    pthread_t workers[WORKERS];
+    for (usize i = 0; i < WORKERS; i++) {
+        pthread_create(&workers[i], NULL, cache_worker, cache);
+    }
+    for (usize i = 0; i < WORKERS; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    assert(sharded_map_cache_count(cache) == WORKER_KEYS);
+
+    for (usize i = 0; i < WORKER_KEYS; i += 2) {
+        c8 buffer[32];
+        snprintf(buffer, sizeof(buffer), "/usr/share/%zu", i);
+        String* removed = string_new(buffer);
+        assert(sharded_map_cache_remove(cache, removed));
+        string_free(&removed);
+    }
+    for (usize i = 0; i < WORKER_KEYS; i++) {
+        c8 buffer[32];
+        snprintf(buffer, sizeof(buffer), "/usr/share/%zu", i);
+        String* lookup = string_new(buffer);
+        assert(sharded_map_cache_contains(cache, lookup) == (i % 2 == 1));
+        string_free(&lookup);
+    }
+
+    sharded_map_cache_clear(cache);
+    assert(sharded_map_cache_count(cache) == 0);
+
+    string_free(&key);
+    string_free(&value);
+    string_free(&other);
+    sharded_map_cache_free(&cache);
+    assert(cache == NULL);
+}
+
+static void test_segmented_vec() {
+    SegmentedVecPoint* points = segmented_vec_point_new();
+    Point* first = segmented_vec_point_push_back(points, (Point) {.x = -1, .y = -1});
+
+    for (i32 i = 1; i < 10000; i++) {
+        Point* pushed = segmented_vec_point_push_back(points, (Point) {.x = i, .y = i * 2});
+        assert(pushed == segmented_vec_point_at(points, i));
+    }
+
+    assert(points->count == 10000);
+    assert(first == segmented_vec_point_first(points).value);
+    assert(first->x == -1);
+    assert(segmented_vec_point_get(points, 4321).value->y == 8642);
+    assert(!segmented_vec_point_get(points, 10000).present);
+    assert(segmented_vec_point_last(points).value->x == 9999);
+
+    i32 expected = -1;
+    segmented_vec_for_each(Point* point, points, {
+        assert(point->x == expected);
+        expected = expected == -1 ? 1 : expected + 1;
+    });
+    assert(expected == 10000);
+
+    segmented_vec_point_pop_back(points);
+    assert(points->count == 9999);
+    segmented_vec_point_free(&points);
+    assert(points == NULL);
+
+    SegmentedVecNode* nodes = segmented_vec_node_new();
+    StringMut* owned = string_mut_new("usr");
+    segmented_vec_node_push_back(nodes, *owned);
+    free(owned);
+    for (usize i = 0; i < 100; i++) {
+        StringMut* node = segmented_vec_node_emplace_back(nodes);
+        string_mut_init(node, STRING_INLINE_CAPACITY + 1);
+    }
+    StrSlice first_node = string_mut_as_slice(segmented_vec_node_at(nodes, 0));
+    assert(str_equals(&first_node, str_static("usr")));
+    segmented_vec_node_free(&nodes);
+}
+
+static void test_soa() {
+    SoaParticle* particles = soa_particle_new(2);
+
+    for (u32 i = 0; i < 1000; i++) {
+        soa_particle_push(particles, (Particle) {.x = (f32) i, .y = (f32) i * 0.5f, .id = i});
+    }
+    assert(particles->count == 1000);
+
+    f32* xs = soa_particle_x(particles);
+    f32* ys = soa_particle_y(particles);
+    for (usize i = 0; i < particles->count; i++) {
+        xs[i] += ys[i];
+    }
+
+    Particle particle = option_particle_get(soa_particle_get(particles, 10));
+    assert(particle.x == 15.0f);
+    assert(particle.id == 10);
+    assert(!soa_particle_get(particles, 1000).present);
+
+    Particle removed = option_particle_get(soa_particle_swap_remove(particles, 0));
+    assert(removed.id == 0);
+    assert(particles->count == 999);
+    assert(soa_particle_id(particles)[0] == 999);
+
+    soa_particle_set(particles, 1, (Particle) {.x = 1.0f, .y = 2.0f, .id = 42});
+    assert(soa_particle_get(particles, 1).value.id == 42);
+
+    soa_particle_clear(particles);
+    assert(particles->count == 0);
+    soa_particle_free(&particles);
+    assert(particles == NULL);
+}
+
+static void test_iterator() {
+    i32 numbers[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    IterInt source = iter_int_from_array(numbers, 10);
+    IterEvenInt evens = iter_even_int_from(source);
+    IterSquare squares = iter_square_from(evens);
+    IterSkippedSquare skipped = iter_skipped_square_from(squares, 1);
+    IterTakenSquare taken = iter_taken_square_from(skipped, 3);
+    IterEnumeratedSquare enumerated = iter_enumerated_square_from(taken);
+
+    i64 expected[] = {16, 36, 64};
+    IndexedSquare current;
+    usize yielded = 0;
+    while (iter_enumerated_square_next(&enumerated, &current)) {
+        assert(current.left == yielded);
+        assert(current.right == expected[current.left]);
+        yielded++;
+    }
+    assert(yielded == 3);
+
+    IterSquare all_squares = iter_square_from(iter_even_int_from(iter_int_from_array(numbers, 10)));
+    IterTakenSquare middle_squares = iter_taken_square_from(iter_skipped_square_from(all_squares, 1), 3);
+    IterOddSquare odd = iter_odd_square_from(iter_enumerated_square_from(middle_squares));
+    assert(iter_odd_square_next(&odd, &current) && current.left == 1 && current.right == 36);
+    assert(!iter_odd_square_next(&odd, &current));
+
+    IterSkippedInt shifted = iter_skipped_int_from(iter_int_from_array(numbers, 10), 7);
+    IterZippedInt zip = iter_zipped_int_from(iter_int_from_array(numbers, 10), shifted);
+    IntPair pair;
+    usize zipped = 0;
+    while (iter_zipped_int_next(&zip, &pair)) {
+        assert(pair.right == pair.left + 7);
+        zipped++;
+    }
+    assert(zipped == 3);
+
+    shifted = iter_skipped_int_from(iter_int_from_array(numbers, 10), 7);
+    IterDifference differences = iter_difference_from(iter_zipped_int_from(iter_int_from_array(numbers, 10), shifted));
+    i32 difference;
+    while (iter_difference_next(&differences, &difference)) {
+        assert(difference == 7);
+    }
+
+    StrSlices* fields = str_split_slices(str_static("usr,local,share,bin,include"), ',');
+    IterLongField long_fields = iter_long_field_from(str_slices_iter(fields));
+    assert(iter_long_field_count(&long_fields) == 3);
+
+    IterFieldLength lengths = iter_field_length_from(iter_long_field_from(str_slices_iter(fields)));
+    usize length;
+    usize total = 0;
+    while (iter_field_length_next(&lengths, &length)) {
+        total += length;
+    }
+    assert(total == strlen("local") + strlen("share") + strlen("include"));
+    str_slices_free(&fields);
+}
+
+int main() {
+    test_sharded_map();
+    test_segmented_vec();
+    test_soa();
+    test_iterator();
+}
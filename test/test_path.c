@@ -1,3 +1,4 @@
+#include "ctk/io/glob.h"
 #include "ctk/io/path.h"
 #include "ctk/os/env.h"
 #include "ctk/string/string.h"
@@ -28,6 +29,29 @@ int main() {
     assert(str_equals(cstring_as_str_ref(user_norm->uri), cstring_as_str_ref(home_mod_norm->uri)));
     assert(str_equals(cstring_as_str_ref(current_norm->uri), cstring_as_str_ref(relative_mod_norm->uri)));
 
+    IterPathNode nodes = path_mut_iter(users);
+    RcString* node;
+    assert(iter_path_node_next(&nodes, &node) && str_equals(rc_string_as_ref(node), str_static("/")));
+    assert(iter_path_node_count(&nodes) == users->nodes->count - 1);
+
+    VecPathNode* shared_nodes = vec_path_node_clone(users->nodes);
+    assert(shared_nodes->elements[0] == users->nodes->elements[0]);
+    assert(rc_string_references(users->nodes->elements[0]) == 2);
+    vec_path_node_free(&shared_nodes);
+    assert(rc_string_references(users->nodes->elements[0]) == 1);
+
+    VecPathNode* copied_nodes = vec_path_node_new(1);
+    vec_path_node_push_back(copied_nodes, *users->nodes->elements[0]);
+    assert(copied_nodes->elements[0] == users->nodes->elements[0]);
+    assert(rc_string_references(users->nodes->elements[0]) == 2);
+    vec_path_node_free(&copied_nodes);
+    assert(rc_string_references(users->nodes->elements[0]) == 1);
+
+    PathMut* empty_first = path_mut_new(str_static(""));
+    path_mut_append(empty_first, str_static(""));
+    assert(!path_mut_is_absolute(empty_first));
+    path_mut_free(&empty_first);
+
     path_mut_free(&users);
     path_mut_free(&user);
     path_mut_free(&current);
@@ -43,4 +67,48 @@ int main() {
 
     assert(users == NULL);
     assert(users_norm == NULL);
+
+    Glob* sources = glob_new(str_static("src/**/*.[ch]"));
+    assert(glob_matches(sources, str_static("src/main.c")));
+    assert(glob_matches(sources, str_static("src/io/path/path.h")));
+    assert(!glob_matches(sources, str_static("src/main.rs")));
+    assert(!glob_matches(sources, str_static("test/src/main.c")));
+    glob_free(&sources);
+
+    Glob* tests = glob_new(str_static("**/test_?*.c"));
+    PathMut* test_mut = path_mut_new(str_static("/repo/test/./test_path.c"));
+    Path* test_path = path_mut_to_path(test_mut);
+    assert(glob_matches_path(tests, test_path));
+    assert(glob_matches(tests, str_static("test_a.c")));
+    assert(!glob_matches(tests, str_static("test_.c")));
+    assert(!glob_matches(tests, str_static("test/test_a/b.c")));
+    glob_free(&tests);
+    path_mut_free(&test_mut);
+    path_free(&test_path);
+
+    Glob* stars = glob_new(str_static("*a*a*a*a*a*b"));
+    assert(!glob_matches(stars, str_static("aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa")));
+    assert(glob_matches(stars, str_static("aaaaaaab")));
+    glob_free(&stars);
+
+    Glob* escaped = glob_new(str_static("[!.]*\\*"));
+    assert(glob_matches(escaped, str_static("a*")));
+    assert(!glob_matches(escaped, str_static(".a*")));
+    glob_free(&escaped);
+
+    assert(glob_new(str_static("src/[a-z")) == NULL);
+    assert(glob_syntax_error(str_static("src/[a-z")).value == 4);
+    assert(!glob_syntax_error(str_static("src/[]]")).present);
+
+    StrSlice ignores[] = {*str_static("target/**"), *str_static("**/*.o"), *str_static("**/.git"), *str_static("docs/*.md")};
+    GlobSet* ignored = glob_set_new(ignores, 4);
+    assert(glob_set_is_match(ignored, str_static("target/debug/ctk")));
+    assert(glob_set_find(ignored, str_static("a/.git")).value == 2);
+    assert(!glob_set_find(ignored, str_static("docs/api/index.md")).present);
+
+    StrIndices* both = glob_set_matches(ignored, str_static("target/main.o"));
+    assert(both->count == 2 && both->indices[0] == 0 && both->indices[1] == 1);
+    str_indices_free(&both);
+    glob_set_free(&ignored);
+    assert(ignored == NULL);
 }
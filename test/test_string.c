@@ -1,4 +1,30 @@
+#include <stdio.h>
+#include <string.h>
 #include "ctk/io/io.h"
+#include "ctk/string/builder.h"
+#include "ctk/string/encoding.h"
+#include "ctk/string/hash.h"
+#include "ctk/string/interner.h"
+#include "ctk/string/multi_match.h"
+#include "ctk/string/number.h"
+#include "ctk/string/parallel.h"
+#include "ctk/string/rc_string.h"
+#include "ctk/string/regex.h"
+#include "ctk/string/rope.h"
+#include "ctk/string/search.h"
+#include "ctk/string/split.h"
+#include "ctk/string/utf8.h"
+
+typedef struct {
+    ThreadPool* pool;
+    StrSlice lines;
+    usize count;
+} NestedCount;
+
+static void nested_count_task(void* argument) {
+    NestedCount* nested = argument;
+    nested->count = str_par_count_char(nested->pool, &nested->lines, '\n');
+}
 
 int main() {
     const Str* stack_static = str_static("Stack Static Allocated");
@@ -12,16 +38,19 @@ int main() {
     CStringMut* heap_mut_cstr = cstring_mut_new("Heap Allocated + Mut + CString");
     CStringMut* heap_mut_cstr_clone = cstring_mut_clone(heap_mut_cstr);
 
-    String* replaced = str_replace(string_as_ref(heap_immutable), str_static("Heap"), str_static("Heap (Modified!)"));
-    assert(str_equals(string_as_ref(replaced), str_static("Heap (Modified!) Allocated")));
+    StrSlice heap_immutable_slice = string_as_slice(heap_immutable);
+    String* replaced = str_replace(&heap_immutable_slice, str_static("Heap"), str_static("Heap (Modified!)"));
+    StrSlice replaced_slice = string_as_slice(replaced);
+    assert(str_equals(&replaced_slice, str_static("Heap (Modified!) Allocated")));
 
     CString* replaced_cstr = cstr_replace(cstring_as_ref(heap_immutable_cstr), cstr_static("Heap"), cstr_static("Heap (Modified!)"));
     assert(cstr_equals(cstring_as_ref(replaced_cstr), cstr_static("Heap (Modified!) Allocated CStr")));
 
-    StrSlices* slices_space = str_split_slices(string_mut_as_ref(heap_mut), ' ');
-    StrSlices* slices_last = str_split_slices(string_mut_as_ref(heap_mut), 't');
-    StrSlices* slices_first = str_split_slices(string_mut_as_ref(heap_mut), 'H');
-    StrSlices* slices_missing = str_split_slices(string_mut_as_ref(heap_mut), 'Z');
+    StrSlice heap_mut_slice = string_mut_as_slice(heap_mut);
+    StrSlices* slices_space = str_split_slices(&heap_mut_slice, ' ');
+    StrSlices* slices_last = str_split_slices(&heap_mut_slice, 't');
+    StrSlices* slices_first = str_split_slices(&heap_mut_slice, 'H');
+    StrSlices* slices_missing = str_split_slices(&heap_mut_slice, 'Z');
 
     assert(slices_space->count == 4);
     assert(slices_last->count == 2);
@@ -33,13 +62,15 @@ int main() {
     assert(str_equals(stack_static, str_static("Stack Static Allocated")));
     assert(!str_equals(&stack, stack_static));
 
-    assert(!str_equals(string_as_ref(heap_immutable), str_static("Stack Allocated")));
-    assert(str_equals(string_as_ref(heap_immutable), str_static("Heap Allocated")));
-    assert(str_equals(string_as_ref(heap_immutable), string_as_ref(heap_immutable_clone)));
+    assert(!str_equals(&heap_immutable_slice, str_static("Stack Allocated")));
+    assert(str_equals(&heap_immutable_slice, str_static("Heap Allocated")));
+    StrSlice heap_immutable_clone_slice = string_as_slice(heap_immutable_clone);
+    assert(str_equals(&heap_immutable_slice, &heap_immutable_clone_slice));
 
-    assert(!str_equals(string_mut_as_ref(heap_mut), str_static("Heap Allocated")));
-    assert(str_equals(string_mut_as_ref(heap_mut), str_static("Heap Allocated + Mut")));
-    assert(str_equals(string_mut_as_ref(heap_mut), string_mut_as_ref(heap_mut_clone)));
+    assert(!str_equals(&heap_mut_slice, str_static("Heap Allocated")));
+    assert(str_equals(&heap_mut_slice, str_static("Heap Allocated + Mut")));
+    StrSlice heap_mut_clone_slice = string_mut_as_slice(heap_mut_clone);
+    assert(str_equals(&heap_mut_slice, &heap_mut_clone_slice));
 
     assert(!cstr_equals(cstring_mut_as_ref(heap_mut_cstr), cstr_static("Heap Allocated + Mut")));
     assert(cstr_equals(cstring_mut_as_ref(heap_mut_cstr), cstr_static("Heap Allocated + Mut + CString")));
@@ -47,11 +78,12 @@ int main() {
 
     assert(str_compare(&stack, stack_static) < 1);
     assert(str_compare(stack_static, &stack) > 1);
-    assert(str_compare(string_as_ref(heap_immutable), string_as_ref(heap_immutable_clone)) == 0);
+    assert(str_compare(&heap_immutable_slice, &heap_immutable_clone_slice) == 0);
 
     string_mut_push(heap_mut, str_static(" + Pushed"));
     string_mut_push(heap_mut, str_static(""));
-    assert(str_equals(string_mut_as_ref(heap_mut), str_static("Heap Allocated + Mut + Pushed")));
+    heap_mut_slice = string_mut_as_slice(heap_mut);
+    assert(str_equals(&heap_mut_slice, str_static("Heap Allocated + Mut + Pushed")));
 
     cstring_mut_push(heap_mut_cstr, cstr_static(" + Pushed"));
     cstring_mut_push(heap_mut_cstr, cstr_static(""));
@@ -61,12 +93,15 @@ int main() {
     string_mut_replace_char(heap_mut, 'd', '&');
     string_mut_replace_char(heap_mut, 'H', '{');
     string_mut_replace(heap_mut, str_static("Mut"), str_static("Modifiable"));
-    assert(str_equals(string_mut_as_ref(heap_mut), str_static("{eap_Allocate&_+_Modifiable_+_Pushe&")));
+    heap_mut_slice = string_mut_as_slice(heap_mut);
+    assert(str_equals(&heap_mut_slice, str_static("{eap_Allocate&_+_Modifiable_+_Pushe&")));
 
     string_mut_clear(heap_mut);
     string_mut_clear_to(heap_mut_clone, '\0');
-    assert(str_equals(string_mut_as_ref(heap_mut), str_static("")));
-    assert(str_equals(string_mut_as_ref(heap_mut_clone), str_static("")));
+    heap_mut_slice = string_mut_as_slice(heap_mut);
+    assert(str_equals(&heap_mut_slice, str_static("")));
+    heap_mut_clone_slice = string_mut_as_slice(heap_mut_clone);
+    assert(str_equals(&heap_mut_clone_slice, str_static("")));
 
     OptionIndex index = str_find(&stack, 'd');
     assert(index.present);
@@ -84,6 +119,501 @@ int main() {
     assert(second_last.present);
     assert(option_index_get(second_last) == 2);
 
+    const StrSlice* log = str_static("GET /index.html 200\nGET /missing.html 404\nPOST /index.html 200\n");
+    assert(str_contains(log, str_static("missing")));
+    assert(!str_contains(log, str_static("PUT")));
+    assert(!str_contains(log, str_static("")));
+    assert(option_index_get(str_find_str(log, str_static("404"))) == 38);
+    assert(!str_find_str(log, str_static("index.htm!")).present);
+
+    assert(str_count_char(log, '\n') == 3);
+    assert(option_index_get(str_find_last(log, 'P')) == 42);
+    assert(option_index_get(str_find_nth(log, 'T', 3)) == 45);
+    assert(option_index_get(str_find_last_nth(log, '.', 2)) == 32);
+    assert(!str_find_nth(log, '\n', 4).present);
+    assert(!str_contains_char(log, '#'));
+
+    assert(str_equals_ignore_case(str_static("Content-Length"), str_static("content-LENGTH")));
+    assert(!str_equals_ignore_case(str_static("Content-Length"), str_static("Content_Length")));
+    assert(str_compare_ignore_case(str_static("accept"), str_static("ACCEPT-Encoding")) < 0);
+    assert(str_compare_ignore_case(str_static("Host"), str_static("accept")) > 0);
+    assert(str_contains_ignore_case(log, str_static("get /MISSING")));
+    assert(!str_contains_ignore_case(log, str_static("put")));
+    assert(option_index_get(str_find_str_ignore_case(log, str_static("post"))) == 42);
+
+    StringMut* header = string_mut_new("X-Request-ID: a1B2-\xC3\x89t\xC3\xA9 and a tail past one vector");
+    string_mut_to_lower(header);
+    StrSlice header_slice = string_mut_as_slice(header);
+    assert(str_equals(&header_slice, str_static("x-request-id: a1b2-\xC3\x89t\xC3\xA9 and a tail past one vector")));
+    string_mut_to_upper(header);
+    header_slice = string_mut_as_slice(header);
+    assert(str_equals(&header_slice, str_static("X-REQUEST-ID: A1B2-\xC3\x89T\xC3\xA9 AND A TAIL PAST ONE VECTOR")));
+    string_mut_free(&header);
+
+    assert(option_u64_get(str_parse_u64(str_static("18446744073709551615"))) == UINT64_MAX);
+    assert(option_u64_get(str_parse_u64(str_static("+0000000000000000000000042"))) == 42);
+    assert(!str_parse_u64(str_static("18446744073709551616")).present);
+    assert(!str_parse_u64(str_static("12a4")).present);
+    assert(!str_parse_u64(str_static("")).present);
+    assert(option_i64_get(str_parse_i64(str_static("-9223372036854775808"))) == INT64_MIN);
+    assert(!str_parse_i64(str_static("9223372036854775808")).present);
+    assert(option_u32_get(str_parse_u32(str_static("4294967295"))) == UINT32_MAX);
+    assert(!str_parse_u32(str_static("4294967296")).present);
+
+    u64 status;
+    assert(str_parse_u64_prefix(str_static("404 Not Found"), &status) == 3);
+    assert(status == 404);
+    assert(str_parse_u64_prefix(str_static("-1"), &status) == 0);
+
+    assert(option_f64_get(str_parse_f64(str_static("0.1"))) == 0.1);
+    assert(option_f64_get(str_parse_f64(str_static("-1.7976931348623157e308"))) == -1.7976931348623157e308);
+    assert(option_f64_get(str_parse_f64(str_static("4.9406564584124654e-324"))) == 5e-324);
+    assert(option_f64_get(str_parse_f64(str_static("9007199254740993.00000000000000000000001"))) == 9007199254740994.0);
+    assert(option_f64_get(str_parse_f64(str_static("1e400"))) == __builtin_inf());
+    assert(option_f32_get(str_parse_f32(str_static("3.4028235e38"))) == 3.4028235e38f);
+    assert(!str_parse_f64(str_static("1.5x")).present);
+    assert(!str_parse_f64(str_static(".")).present);
+
+    f64 reading;
+    assert(str_parse_f64_prefix(str_static("2.5e3,next"), &reading) == 5);
+    assert(reading == 2500.0);
+    assert(str_parse_f64_prefix(str_static("7e+"), &reading) == 1);
+
+    StringMut* numbers = string_mut_new("");
+    string_mut_push_u64(numbers, 0);
+    string_mut_push_char(numbers, ',');
+    string_mut_push_i64(numbers, INT64_MIN);
+    string_mut_push_char(numbers, ',');
+    string_mut_push_u64(numbers, 1234567890123ULL);
+    StrSlice numbers_slice = string_mut_as_slice(numbers);
+    assert(str_equals(&numbers_slice, str_static("0,-9223372036854775808,1234567890123")));
+    string_mut_free(&numbers);
+
+    StringMut* floats = string_mut_new("");
+    string_mut_push_f64(floats, 0.1);
+    string_mut_push_char(floats, ',');
+    string_mut_push_f64(floats, 1e16);
+    string_mut_push_char(floats, ',');
+    string_mut_push_f64(floats, 5e-324);
+    string_mut_push_char(floats, ',');
+    string_mut_push_f64(floats, -0.0);
+    string_mut_push_char(floats, ',');
+    string_mut_push_f32(floats, 0.1f);
+    string_mut_push_char(floats, ',');
+    string_mut_push_f64_fixed(floats, 2.675, 2);
+    string_mut_push_char(floats, ',');
+    string_mut_push_f64_fixed(floats, -0.0004, 3);
+    StrSlice floats_slice = string_mut_as_slice(floats);
+    assert(str_equals(&floats_slice, str_static("0.1,1e16,5e-324,-0,0.1,2.67,-0.000")));
+    string_mut_free(&floats);
+
+    StringMut* encoded = string_mut_new("");
+    str_hex_encode(str_static("\x01\xAB\xFF"), encoded);
+    StrSlice encoded_slice = string_mut_as_slice(encoded);
+    assert(str_equals(&encoded_slice, str_static("01abff")));
+    string_mut_clear(encoded);
+    str_base64_encode(str_static("any carnal pleas"), BASE64_STANDARD, encoded);
+    encoded_slice = string_mut_as_slice(encoded);
+    assert(str_equals(&encoded_slice, str_static("YW55IGNhcm5hbCBwbGVhcw==")));
+    string_mut_clear(encoded);
+    str_base64_encode(str_static("\xFB\xFF"), BASE64_URL, encoded);
+    encoded_slice = string_mut_as_slice(encoded);
+    assert(str_equals(&encoded_slice, str_static("-_8")));
+    string_mut_free(&encoded);
+
+    StringMut* decoded = string_mut_new("");
+    assert(!str_hex_decode(str_static("01ABff"), decoded).present);
+    StrSlice decoded_slice = string_mut_as_slice(decoded);
+    assert(str_equals(&decoded_slice, str_static("\x01\xAB\xFF")));
+    assert(option_index_get(str_hex_decode(str_static("01zz"), decoded)) == 2);
+    assert(option_index_get(str_hex_decode(str_static("012"), decoded)) == 3);
+    assert(string_mut_length(decoded) == 3);
+    string_mut_clear(decoded);
+    assert(!str_base64_decode(str_static("YW55IGNhcm5hbCBwbGVhcw"), BASE64_STANDARD, decoded).present);
+    decoded_slice = string_mut_as_slice(decoded);
+    assert(str_equals(&decoded_slice, str_static("any carnal pleas")));
+    assert(option_index_get(str_base64_decode(str_static("YW5_"), BASE64_STANDARD, decoded)) == 3);
+    assert(option_index_get(str_base64_decode(str_static("YW=5"), BASE64_STANDARD, decoded)) == 2);
+    assert(option_index_get(str_base64_decode(str_static("YW55I"), BASE64_URL, decoded)) == 5);
+    string_mut_free(&decoded);
+
+    StrSlice parts[] = {str_init("usr"), str_init("local"), str_init("bin")};
+    String* joined = str_join(&(StrSlices) {parts, 3}, str_static("/"));
+    StrSlice joined_slice = string_as_slice(joined);
+    assert(str_equals(&joined_slice, str_static("usr/local/bin")));
+    string_free(&joined);
+    String* empty_join = str_join(&(StrSlices) {parts, 0}, str_static(", "));
+    assert(string_length(empty_join) == 0);
+    string_free(&empty_join);
+
+    String* uri = str_concat(3, str_static("https"), str_static("://"), str_static("example.com"));
+    StrSlice uri_slice = string_as_slice(uri);
+    assert(str_equals(&uri_slice, str_static("https://example.com")));
+    string_free(&uri);
+
+    StringBuilder builder;
+    string_builder_init(&builder);
+    for (usize i = 0; i < STRING_BUILDER_INLINE_PIECES * 2; i++) {
+        string_builder_push(&builder, str_static("ab"));
+    }
+    assert(string_builder_length(&builder) == STRING_BUILDER_INLINE_PIECES * 4);
+    String* built = string_builder_build(&builder);
+    assert(string_length(built) == STRING_BUILDER_INLINE_PIECES * 4);
+    StrSlice built_slice = string_as_slice(built);
+    StrSlice built_head = str_sub_slice(&built_slice, 0, 4);
+    assert(str_equals(&built_head, str_static("abab")));
+    string_free(&built);
+    assert(string_builder_length(&builder) == 0);
+    string_builder_push(&builder, str_static("tail"));
+    StringMut* target = string_mut_new("head ");
+    string_builder_build_into(&builder, target);
+    StrSlice target_slice = string_mut_as_slice(target);
+    assert(str_equals(&target_slice, str_static("head tail")));
+    string_mut_free(&target);
+
+    RcString* shared = rc_string_new("shared");
+    RcString* owner = rc_string_clone(shared);
+    assert(owner == shared);
+    assert(rc_string_references(shared) == 2);
+    rc_string_free(&owner);
+    assert(owner == NULL);
+    assert(rc_string_references(shared) == 1);
+    assert(str_equals(rc_string_as_ref(shared), str_static("shared")));
+    rc_string_free(&shared);
+
+    StrSearcher* searcher = str_searcher_new(str_static("index.html"));
+    StrIndices* matches = str_searcher_find_all(searcher, log);
+    assert(matches->count == 2);
+    assert(matches->indices[0] == 5);
+    assert(matches->indices[1] == 48);
+    assert(option_index_get(str_searcher_find_from(searcher, log, 6)) == 48);
+    str_indices_free(&matches);
+    str_searcher_free(&searcher);
+    assert(searcher == NULL);
+
+    StrIndices* overlapping = str_find_all(str_static("aaaaa"), str_static("aa"));
+    assert(overlapping->count == 2);
+    str_indices_free(&overlapping);
+
+    String* first_only = str_replace_first(log, str_static("index"), str_static("home"));
+    String* two_only = str_replace_n(str_static("a-b-c-d"), str_static("-"), str_static(" -> "), 2);
+    String* untouched = str_replace(str_static("abc"), str_static(""), str_static("x"));
+    StrSlice first_only_slice = string_as_slice(first_only);
+    assert(str_equals(&first_only_slice, str_static("GET /home.html 200\nGET /missing.html 404\nPOST /index.html 200\n")));
+    StrSlice two_only_slice = string_as_slice(two_only);
+    assert(str_equals(&two_only_slice, str_static("a -> b -> c-d")));
+    StrSlice untouched_slice = string_as_slice(untouched);
+    assert(str_equals(&untouched_slice, str_static("abc")));
+    string_free(&first_only);
+    string_free(&two_only);
+    string_free(&untouched);
+
+    StringMut* template = string_mut_new("{name} owes {amount}, {name}!");
+    string_mut_replace(template, str_static("{name}"), str_static("Alexander"));
+    string_mut_replace_first(template, str_static("{amount}"), str_static("$5"));
+    StrSlice template_slice = string_mut_as_slice(template);
+    assert(str_equals(&template_slice, str_static("Alexander owes $5, Alexander!")));
+    string_mut_replace(template, str_static("Alexander"), str_static("Bartholo"));
+    string_mut_replace_n(template, str_static("o"), str_static("0"), 2);
+    template_slice = string_mut_as_slice(template);
+    assert(str_equals(&template_slice, str_static("Barth0l0 owes $5, Bartholo!")));
+    string_mut_free(&template);
+
+    StrSlice placeholders[] = {str_init("{user}"), str_init("{host}"), str_init("{home}"), str_init("{host}:{port}")};
+    StrSlice values[] = {str_init("nate"), str_init("example.com"), str_init("/home/nate"), str_init("example.com:22")};
+    StrMultiMatcher* matcher = str_multi_matcher_new(placeholders, 4);
+    const StrSlice* config = str_static("ssh {user}@{host}:{port} # {home} {unknown}");
+
+    StrMultiMatches* found = str_multi_matcher_find_all(matcher, config);
+    assert(found->count == 3);
+    assert(found->matches[0].pattern == 0 && found->matches[0].index == 4);
+    assert(found->matches[1].pattern == 3 && found->matches[1].index == 11);
+    assert(found->matches[2].pattern == 2 && found->matches[2].index == 27);
+    str_multi_matches_free(&found);
+
+    StringMut* expanded = string_mut_new_sized(0);
+    str_multi_matcher_replace_all(matcher, config, values, expanded);
+    StrSlice expanded_slice = string_mut_as_slice(expanded);
+    assert(str_equals(&expanded_slice, str_static("ssh nate@example.com:22 # /home/nate {unknown}")));
+    string_mut_free(&expanded);
+    str_multi_matcher_free(&matcher);
+
+    StrSlice field;
+    StrSplitIter csv = str_split_iter(str_static("id,,name,"), ',');
+    str_split_iter_keep_empty(&csv);
+    assert(str_split_iter_next(&csv, &field) && str_equals(&field, str_static("id")));
+    assert(str_split_iter_next(&csv, &field) && field.length == 0);
+    assert(str_split_iter_peek(&csv, &field) && str_equals(&field, str_static("name")));
+    StrSlice remainder = str_split_iter_remainder(&csv);
+    assert(str_equals(&remainder, str_static("name,")));
+    assert(str_split_iter_next(&csv, &field) && str_equals(&field, str_static("name")));
+    assert(str_split_iter_next(&csv, &field) && field.length == 0);
+    assert(!str_split_iter_next(&csv, &field));
+
+    StrSplitIter words = str_split_any_iter(str_static("  key =\tvalue  # note"), str_static(" =\t"));
+    str_split_iter_limit(&words, 3);
+    assert(str_split_iter_next(&words, &field) && str_equals(&field, str_static("key")));
+    assert(str_split_iter_next(&words, &field) && str_equals(&field, str_static("value")));
+    assert(str_split_iter_next(&words, &field) && str_equals(&field, str_static("# note")));
+    assert(!str_split_iter_next(&words, &field));
+
+    StrSplitIter extension = str_split_str_iter(str_static("archive.tar.gz"), str_static("."));
+    str_split_iter_reverse(&extension);
+    str_split_iter_limit(&extension, 2);
+    assert(str_split_iter_next(&extension, &field) && str_equals(&field, str_static("gz")));
+    assert(str_split_iter_next(&extension, &field) && str_equals(&field, str_static("archive.tar")));
+    assert(!str_split_iter_next(&extension, &field));
+
+    const StrSlice* padded = str_static(" \t\r\n  trimmed \v text\f\n ");
+    StrSlice trimmed = str_trim(padded);
+    assert(str_equals(&trimmed, str_static("trimmed \v text")));
+    trimmed = str_trim_start(padded);
+    assert(str_equals(&trimmed, str_static("trimmed \v text\f\n ")));
+    trimmed = str_trim_end(padded);
+    assert(str_equals(&trimmed, str_static(" \t\r\n  trimmed \v text")));
+    trimmed = str_trim(str_static(" \n\t "));
+    assert(trimmed.length == 0);
+
+    StrSplitIter tokens = str_split_whitespace_iter(str_static("\t  ls -la\n\n /home/nate  \r\n"));
+    assert(str_split_iter_next(&tokens, &field) && str_equals(&field, str_static("ls")));
+    assert(str_split_iter_next(&tokens, &field) && str_equals(&field, str_static("-la")));
+    assert(str_split_iter_next(&tokens, &field) && str_equals(&field, str_static("/home/nate")));
+    assert(!str_split_iter_next(&tokens, &field));
+
+    tokens = str_split_whitespace_iter(str_static("  cmd  first  second rest  "));
+    str_split_iter_reverse(&tokens);
+    str_split_iter_limit(&tokens, 2);
+    assert(str_split_iter_next(&tokens, &field) && str_equals(&field, str_static("rest")));
+    assert(str_split_iter_next(&tokens, &field) && str_equals(&field, str_static("  cmd  first  second")));
+    assert(!str_split_iter_next(&tokens, &field));
+
+    Regex* email = regex_new(str_static("(\\w+)@(\\w+)\\.(com|org)\\b"));
+    const StrSlice* inbox = str_static("from: nate@example.com, cc: ops@ctk.org.uk; bad@host.comx");
+    OptionRegexMatch groups[4];
+    assert(regex_group_count(email) == 4);
+    assert(regex_is_match(email, inbox));
+    assert(regex_captures(email, inbox, groups));
+    assert(groups[0].value.start == 6 && groups[0].value.end == 22);
+    assert(groups[1].value.start == 6 && groups[1].value.end == 10);
+    assert(groups[2].value.start == 11 && groups[2].value.end == 18);
+    assert(groups[3].value.start == 19 && groups[3].value.end == 22);
+    RegexMatches* emails = regex_find_all(email, inbox);
+    assert(emails->count == 2);
+    assert(emails->matches[1].start == 28 && emails->matches[1].end == 39);
+    regex_matches_free(&emails);
+    regex_free(&email);
+
+    Regex* request = regex_new(str_static("(?i)^\\s*(get|post)\\s+(/[^ ]*)?(?: HTTP/1\\.[01])?$"));
+    assert(regex_captures(request, str_static("  Get /index.html HTTP/1.1"), groups));
+    assert(groups[1].value.start == 2 && groups[1].value.end == 5);
+    assert(groups[2].value.start == 6 && groups[2].value.end == 17);
+    assert(regex_captures(request, str_static("POST  "), groups) && !groups[2].present);
+    assert(!regex_is_match(request, str_static("PUT /")));
+    assert(!regex_find_from(request, str_static(" get /"), 1).present);
+    regex_free(&request);
+
+    Regex* lazy = regex_new(str_static("<.+?>|x*"));
+    RegexMatches* tags = regex_find_all(lazy, str_static("<b>y<i>z"));
+    assert(tags->count == 3);
+    assert(tags->matches[0].start == 0 && tags->matches[0].end == 3);
+    assert(tags->matches[1].start == 4 && tags->matches[1].end == 7);
+    assert(tags->matches[2].start == 8 && tags->matches[2].end == 8);
+    regex_matches_free(&tags);
+    regex_free(&lazy);
+
+    // a body that can match empty ends the loop at its first empty pass, following RE2 rather than Perl or Python
+    const c8* nullable[] = {"(?:a?\?)+", "(?:|a)+", "(x?|a)*", "(|a)*", "(?:|a){2,}"};
+    for (usize i = 0; i < sizeof(nullable) / sizeof(nullable[0]); i++) {
+        Regex* empty_first = regex_new(&(StrSlice) {nullable[i], strlen(nullable[i])});
+        OptionRegexMatch found = regex_find(empty_first, str_static("aab"));
+        assert(found.present && found.value.start == 0 && found.value.end == 0);
+        assert(regex_captures(empty_first, str_static("aa"), groups) && groups[0].value.end == 0);
+        regex_free(&empty_first);
+    }
+    Regex* re2_priority = regex_new(str_static("(?:|b)*\\D?c"));
+    OptionRegexMatch re2_found = regex_find(re2_priority, str_static("bbccac"));
+    assert(re2_found.present && re2_found.value.start == 0 && re2_found.value.end == 4);
+    regex_free(&re2_priority);
+
+    assert(regex_new(str_static("a(b")) == NULL);
+    assert(regex_syntax_error(str_static("ab)")).value == 2);
+    assert(regex_syntax_error(str_static("[z-a]")).value == 1);
+    assert(!regex_syntax_error(str_static("x{2,3}?[]-]\\x41")).present);
+
+    usize lines_length = (usize) 6 * STR_PAR_MIN_CHUNK;
+    c8* lines_buffer = heap_many(sizeof(c8), lines_length);
+    for (usize i = 0; i < lines_length; i++) {
+        lines_buffer[i] = i % 97 == 0 || i % 1013 == 0 ? '\n' : 'x';
+    }
+    StrSlice lines = {lines_buffer, lines_length};
+    ThreadPool* pool = thread_pool_new(4);
+
+    assert(str_par_count_char(pool, &lines, '\n') == str_count_char(&lines, '\n'));
+    StrSlices* serial = str_split_slices(&lines, '\n');
+    StrSlices* parallel = str_par_split(pool, &lines, '\n');
+    assert(serial->count == parallel->count);
+    for (usize i = 0; i < serial->count; i++) {
+        assert(serial->slices[i].buffer == parallel->slices[i].buffer);
+        assert(serial->slices[i].length == parallel->slices[i].length);
+    }
+
+    str_slices_free(&serial);
+    str_slices_free(&parallel);
+    thread_pool_free(&pool);
+    assert(pool == NULL);
+
+    // the only worker is busy waiting on its own chunks, so it has to run them itself
+    NestedCount nested = {thread_pool_new(1), lines, 0};
+    thread_pool_submit(nested.pool, nested_count_task, &nested);
+    thread_pool_wait(nested.pool);
+    assert(nested.count == str_count_char(&lines, '\n'));
+    thread_pool_free(&nested.pool);
+    free(lines_buffer);
+
+    const StrSlice* sentence = str_static("the quick brown fox jumps over the lazy dog, again and again and again");
+    StrHasher hasher;
+    str_hasher_init(&hasher, 42);
+    str_hasher_push(&hasher, &(StrSlice) {sentence->buffer, 10});
+    str_hasher_push(&hasher, &(StrSlice) {sentence->buffer + 10, sentence->length - 10});
+    assert(str_hasher_finish(&hasher) == str_hash64(sentence, 42));
+    assert(str_hash64(sentence, 42) != str_hash64(sentence, 43));
+    assert(str_hash64(str_static("abc"), 0) != str_hash64(str_static("abd"), 0));
+
+    Hash128 wide = str_hash128(sentence, 42);
+    assert(wide.low != wide.high);
+    assert(wide.low == str_hash128(sentence, 42).low);
+
+    HashedStr key = hashed_str_init(str_static("content-length"));
+    HashedStr same = hashed_str_init(str_static("content-length"));
+    HashedStr other = hashed_str_init(str_static("content-type"));
+    assert(key.hash == same.hash);
+    assert(hashed_str_equals(&key, &same));
+    assert(!hashed_str_equals(&key, &other));
+
+    StrInterner* interner = str_interner_new();
+    StrSlice components[] = {str_init("usr"), str_init("local"), str_init(".."), str_init("usr"), str_init("")};
+    StrSymbol symbols[5];
+    str_interner_intern_all(interner, components, 5, symbols);
+    assert(str_interner_count(interner) == 4);
+    assert(symbols[0] == symbols[3]);
+    assert(symbols[0] != symbols[1]);
+    assert(option_symbol_get(str_interner_lookup(interner, str_static(".."))) == symbols[2]);
+    assert(!str_interner_lookup(interner, str_static("home")).present);
+
+    StrSlice first_resolved = str_interner_resolve(interner, symbols[0]);
+    for (usize i = 0; i < 5000; i++) {
+        c8 name[16];
+        usize length = (usize) snprintf(name, sizeof(name), "node%zu", i);
+        assert(str_interner_intern(interner, &(StrSlice) {name, length}) == i + 4);
+    }
+    assert(str_interner_resolve(interner, symbols[0]).buffer == first_resolved.buffer);
+    assert(str_equals(&first_resolved, str_static("usr")));
+    assert(str_interner_intern(interner, str_static("node4999")) == 5003);
+    str_interner_free(&interner);
+
+    Rope* rope = rope_from_str(str_static("hello world"));
+    rope_insert(rope, 5, str_static(","));
+    rope_push(rope, str_static("!"));
+    rope_delete(rope, 0, 1);
+    rope_insert(rope, 0, str_static("H"));
+    assert(rope_length(rope) == 13);
+    assert(rope_at(rope, 5) == ',');
+    String* rope_string = rope_to_string(rope);
+    StrSlice rope_string_slice = string_as_slice(rope_string);
+    assert(str_equals(&rope_string_slice, str_static("Hello, world!")));
+    string_free(&rope_string);
+
+    c8 digits[ROPE_CHUNK_CAPACITY * 8];
+    for (usize i = 0; i < sizeof(digits); i++) {
+        digits[i] = (c8) ('0' + i % 10);
+    }
+    Rope* large_rope = rope_from_str(&(StrSlice) {digits, sizeof(digits)});
+    rope_delete(large_rope, 100, ROPE_CHUNK_CAPACITY * 3);
+    assert(rope_length(large_rope) == ROPE_CHUNK_CAPACITY * 5);
+    assert(rope_at(large_rope, 100) == digits[100 + ROPE_CHUNK_CAPACITY * 3]);
+    Rope* large_slice = rope_slice(large_rope, 50, ROPE_CHUNK_CAPACITY * 4);
+    assert(rope_length(large_slice) == ROPE_CHUNK_CAPACITY * 4);
+    assert(rope_at(large_slice, 0) == digits[50] && rope_at(large_slice, 60) == digits[60 + ROPE_CHUNK_CAPACITY * 3]);
+    rope_free(&large_slice);
+    Rope* rope_tail = rope_slice(large_rope, 0, 10);
+    rope_concat_owned(rope, rope_tail);
+    assert(rope_length(rope) == 23);
+    RopeChunks chunks = rope_chunks(rope);
+    StrSlice chunk;
+    usize chunk_total = 0;
+    while (rope_chunks_next(&chunks, &chunk)) {
+        assert(chunk.length > 0);
+        chunk_total += chunk.length;
+    }
+    assert(chunk_total == 23);
+    rope_string = rope_to_string(rope);
+    rope_string_slice = string_as_slice(rope_string);
+    assert(str_equals(&rope_string_slice, str_static("Hello, world!0123456789")));
+    string_free(&rope_string);
+    rope_free(&large_rope);
+    rope_free(&rope);
+    assert(rope == NULL);
+
+    Str accented = str_init("caf\xC3\xA9 \xE2\x82\xAC\xF0\x9F\x98\x80");
+    assert(str_utf8_validate(&accented));
+    assert(str_utf8_count(&accented) == 7);
+    assert(!str_utf8_is_char_boundary(&accented, 4));
+    assert(str_utf8_floor_char_boundary(&accented, 4) == 3);
+    assert(str_utf8_ceil_char_boundary(&accented, 4) == 5);
+    assert(str_utf8_ceil_char_boundary(&accented, 100) == accented.length);
+    u32 expected_points[] = {'c', 'a', 'f', 0xE9, ' ', 0x20AC, 0x1F600};
+    StrUtf8Iter points = str_utf8_iter(&accented);
+    u32 point;
+    usize point_count = 0;
+    while (str_utf8_iter_next(&points, &point)) {
+        assert(point == expected_points[point_count++]);
+    }
+    assert(point_count == 7);
+
+    c8 long_text[100];
+    memset(long_text, 'a', sizeof(long_text));
+    long_text[40] = (c8) 0xED;
+    long_text[41] = (c8) 0xA0;
+    long_text[42] = (c8) 0x80;
+    assert(str_utf8_valid_up_to(&(StrSlice) {long_text, sizeof(long_text)}) == 40);
+    assert(str_utf8_valid_up_to(str_static("ab\xC0\xAF")) == 2);
+    assert(str_utf8_valid_up_to(str_static("ab\xE2\x82")) == 2);
+    points = str_utf8_iter(str_static("a\xFF" "b"));
+    assert(str_utf8_iter_next(&points, &point) && point == 'a');
+    assert(str_utf8_iter_next(&points, &point) && point == UTF8_REPLACEMENT);
+    assert(str_utf8_iter_next(&points, &point) && point == 'b');
+    assert(!str_utf8_iter_next(&points, &point));
+
+    assert(sizeof(String) == sizeof(CStringMut));
+    assert(sizeof(StringMut) == sizeof(CStringMut));
+    String* inline_string = string_new("XDG_CONFIG_HOME=~/.conf");
+    String* spilled_string = string_new("a string that is too long to be stored inline");
+    assert(string_buffer(inline_string) == inline_string->small.buffer);
+    assert(string_buffer(spilled_string) != spilled_string->small.buffer);
+    String moved = *inline_string;
+    free(inline_string);
+    StrSlice moved_slice = string_as_slice(&moved);
+    assert(str_equals(&moved_slice, str_static("XDG_CONFIG_HOME=~/.conf")));
+    string_free(&spilled_string);
+
+    StringMut* growing = string_mut_new("home");
+    assert(string_mut_capacity(growing) == STRING_INLINE_CAPACITY);
+    StringMut copied = *growing;
+    string_mut_push(&copied, str_static("/me"));
+    StrSlice copied_slice = string_mut_as_slice(&copied);
+    assert(str_equals(&copied_slice, str_static("home/me")));
+    StrSlice growing_slice = string_mut_as_slice(growing);
+    assert(str_equals(&growing_slice, str_static("home")));
+    for (usize i = 0; i < 10; i++) {
+        string_mut_push(growing, str_static("/user"));
+    }
+    assert(string_mut_capacity(growing) > STRING_INLINE_CAPACITY);
+    assert(string_mut_length(growing) == 54);
+    assert(str_equals(&(Str) {string_mut_buffer(growing) + 44, 10}, str_static("/user/user")));
+    String* owned = string_mut_to_string_owned(growing);
+    assert(string_length(owned) == 54);
+    string_free(&owned);
+
     string_free(&heap_immutable);
     string_free(&heap_immutable_clone);
     string_free(&replaced);